@@ -0,0 +1,201 @@
+#include "Precompiled.hpp"
+
+#include "ClassTrimStream.hpp"
+#include "RawDocumentation.hpp"
+
+#include <Engine/Documentation.hpp>
+
+namespace Zero
+{
+  ClassTrimStream::ClassTrimStream(DocumentationLibrary& trimLib)
+    : mRawTypedefs(nullptr),
+      mTrimTypedefs(nullptr),
+      mTagAsUnbound(false),
+      mTrimLib(trimLib),
+      mAddedCount(0),
+      mWaitingCount(0),
+      mPeakWaitingCount(0)
+  {
+  }
+
+  void ClassTrimStream::Add(RawDocumentationLibrary& library, RawClassDoc* classDoc)
+  {
+    ++mAddedCount;
+    classDoc->Build();
+
+    const String& baseClass = classDoc->mBaseClass;
+
+    if (!baseClass.Empty() && !WasTrimmed(baseClass))
+    {
+      mWaiting[baseClass].PushBack(classDoc);
+
+      ++mWaitingCount;
+      mPeakWaitingCount = Math::Max(mPeakWaitingCount, mWaitingCount);
+      return;
+    }
+
+    Array<RawClassDoc*> ready;
+    ready.PushBack(classDoc);
+    TrimReady(library, ready);
+  }
+
+  bool ClassTrimStream::WasTrimmed(StringParam name)
+  {
+    return mTrimmedBases.ContainsKey(name);
+  }
+
+  bool ClassTrimStream::HasClasses(void)
+  {
+    return mAddedCount != 0;
+  }
+
+  void ClassTrimStream::Finish(RawDocumentationLibrary& library)
+  {
+    // whatever still waits derives from a class that was never loaded or from another waiting
+    // class. Starting at the missing bases trims every chain from its top down
+    HashSet<String> waitingNames;
+    forRange(auto& entry, mWaiting.All())
+    {
+      forRange(RawClassDoc* classDoc, entry.second.All())
+      {
+        waitingNames.Insert(classDoc->mName);
+        waitingNames.Insert(classDoc->GenerateMapKey());
+      }
+    }
+
+    Array<String> missingBases;
+    forRange(auto& entry, mWaiting.All())
+    {
+      if (!waitingNames.Contains(entry.first))
+        missingBases.PushBack(entry.first);
+    }
+
+    Array<RawClassDoc*> ready;
+    forRange(String& baseName, missingBases.All())
+    {
+      TakeWaiting(baseName, ready);
+      TrimReady(library, ready);
+    }
+
+    // only classes deriving from each other in a circle are left
+    while (!mWaiting.Empty())
+    {
+      String baseName = mWaiting.All().Front().first;
+
+      TakeWaiting(baseName, ready);
+      TrimReady(library, ready);
+    }
+
+    mTrimLib.mEnums = library.mEnums;
+    mTrimLib.mFlags = library.mFlags;
+
+    if (!mRawOutputDirectory.Empty())
+      library.SaveLibraryDataFile(mRawOutputDirectory);
+
+    WriteLog("trimmed %u classes while loading, at most %u waited on their base class at once\n",
+      mAddedCount, mPeakWaitingCount);
+  }
+
+  void ClassTrimStream::TakeWaiting(StringParam baseName, Array<RawClassDoc*>& ready)
+  {
+    Array<RawClassDoc*>* waiting = mWaiting.FindPointer(baseName);
+
+    if (waiting == nullptr)
+      return;
+
+    forRange(RawClassDoc* classDoc, waiting->All())
+    {
+      ready.PushBack(classDoc);
+    }
+
+    mWaitingCount -= waiting->Size();
+    mWaiting.Erase(baseName);
+  }
+
+  void ClassTrimStream::TrimReady(RawDocumentationLibrary& library, Array<RawClassDoc*>& ready)
+  {
+    while (!ready.Empty())
+    {
+      RawClassDoc* rawClass = ready.Back();
+      ready.PopBack();
+
+      // same steps as the full mode, just for one class
+      FillOverloadDescriptions(rawClass);
+
+      if (mTagAsUnbound)
+        rawClass->mTags.PushBack("Non-Zilch");
+
+      if (mRawTypedefs)
+        rawClass->NormalizeAllTypes(mRawTypedefs);
+
+      if (!mRawOutputDirectory.Empty()
+        && library.GenerateClassDocumentationFile(mRawOutputDirectory, rawClass))
+      {
+        library.mClassPaths.PushBack(rawClass->mRelativePath);
+      }
+
+      if (mTrimTypedefs)
+        rawClass->NormalizeAllTypes(mTrimTypedefs);
+
+      ClassDoc* trimClass = new ClassDoc();
+      rawClass->FillTrimmedClass(trimClass);
+
+      mTrimLib.mClasses.PushBack(trimClass);
+      mTrimLib.mClassMap[trimClass->mName] = trimClass;
+
+      TrimmedBase trimmed;
+      trimmed.mBaseClass = rawClass->mBaseClass;
+
+      forRange(auto& entry, rawClass->mMethodMap.All())
+      {
+        if (entry.second.Size() > 1)
+          trimmed.mOverloadDescriptions[entry.first] = rawClass->GetDescriptionForMethod(entry.first);
+      }
+
+      String name = rawClass->mName;
+      String mapKey = rawClass->GenerateMapKey();
+
+      mTrimmedBases[name] = trimmed;
+      mTrimmedBases[mapKey] = trimmed;
+
+      library.RemoveClass(rawClass);
+
+      TakeWaiting(name, ready);
+      TakeWaiting(mapKey, ready);
+    }
+  }
+
+  void ClassTrimStream::FillOverloadDescriptions(RawClassDoc* classDoc)
+  {
+    forRange(RawMethodDoc* methodDoc, classDoc->mMethods.All())
+    {
+      if (!methodDoc->mDescription.Empty())
+        continue;
+
+      // see if there is a function in that same class by the same name
+      if (classDoc->mMethodMap[methodDoc->mName].Size() > 1)
+      {
+        methodDoc->mDescription = classDoc->GetDescriptionForMethod(methodDoc->mName);
+
+        if (!methodDoc->mDescription.Empty())
+          continue;
+      }
+
+      // if not, check the overloads the trimmed base classes handed down
+      TrimmedBase* parentClass = mTrimmedBases.FindPointer(classDoc->mBaseClass);
+
+      while (parentClass)
+      {
+        String* description = parentClass->mOverloadDescriptions.FindPointer(methodDoc->mName);
+
+        if (description)
+          methodDoc->mDescription = *description;
+
+        if (!methodDoc->mDescription.Empty())
+          break;
+
+        parentClass = mTrimmedBases.FindPointer(parentClass->mBaseClass);
+      }
+    }
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+namespace Zero
+{
+  class RawClassDoc;
+  class RawDocumentationLibrary;
+  class RawTypedefLibrary;
+  class DocumentationLibrary;
+
+  /// Trims raw classes into a DocumentationLibrary while the raw library is still loading, so
+  /// it never holds every class at once. The only thing a class takes from other classes is
+  /// the description of inherited overloads, so a class is normalized, saved, trimmed and
+  /// deleted as soon as its base class was trimmed. Classes whose base was not trimmed yet
+  /// wait for it, the ones whose base never gets loaded wait until Finish.
+  class ClassTrimStream
+  {
+  public:
+    ClassTrimStream(DocumentationLibrary& trimLib);
+
+    /// takes a class of library whose macros were expanded and whose source was scanned.
+    /// The class is removed from library and deleted once it was trimmed, maybe right away.
+    void Add(RawDocumentationLibrary& library, RawClassDoc* classDoc);
+
+    /// true if a class by this name or map key was trimmed already
+    bool WasTrimmed(StringParam name);
+
+    /// true if any class was added so far
+    bool HasClasses(void);
+
+    /// trims every class still waiting on a base, copies the enums and flags of library into
+    /// the trimmed library and saves the raw library file if raw classes were saved
+    void Finish(RawDocumentationLibrary& library);
+
+    /// raw classes are normalized with this before they are saved, null skips it
+    RawTypedefLibrary* mRawTypedefs;
+    /// raw classes are normalized with this before they are trimmed, null skips it
+    RawTypedefLibrary* mTrimTypedefs;
+    /// every raw class is saved under this directory, empty skips saving them
+    String mRawOutputDirectory;
+    /// if true every class is tagged as an unbound type before it is saved
+    bool mTagAsUnbound;
+
+  private:
+    /// what a trimmed class still hands down to the classes deriving from it
+    struct TrimmedBase
+    {
+      String mBaseClass;
+      /// what GetDescriptionForMethod returned for every overloaded method
+      HashMap<String, String> mOverloadDescriptions;
+    };
+
+    /// moves the classes waiting on baseName into ready
+    void TakeWaiting(StringParam baseName, Array<RawClassDoc*>& ready);
+
+    /// trims every class in ready along with everything that waited on them
+    void TrimReady(RawDocumentationLibrary& library, Array<RawClassDoc*>& ready);
+
+    /// same as RawDocumentationLibrary::FillOverloadDescriptions, only the base classes are
+    /// looked up in mTrimmedBases
+    void FillOverloadDescriptions(RawClassDoc* classDoc);
+
+    DocumentationLibrary& mTrimLib;
+
+    // by class name and by map key, since base classes can be named either way
+    HashMap<String, TrimmedBase> mTrimmedBases;
+
+    // classes that were loaded but not trimmed yet, by the name of their base class
+    HashMap<String, Array<RawClassDoc*> > mWaiting;
+
+    uint mAddedCount;
+    uint mWaitingCount;
+    uint mPeakWaitingCount;
+  };
+}
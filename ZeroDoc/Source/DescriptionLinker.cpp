@@ -0,0 +1,219 @@
+#include "Precompiled.hpp"
+
+#include "DescriptionLinker.hpp"
+
+namespace Zero
+{
+  DescriptionLinker gDescriptionLinker;
+
+  // names only link when the letters around them could not continue an identifier
+  static bool IsIdentifierLetter(char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+  }
+
+  void DescriptionLinker::Build(const UnsortedMap<String, String>& linkMap)
+  {
+    mNodes.Clear();
+    mNames.Clear();
+    mLinks.Clear();
+
+    Node& root = mNodes.PushBack();
+    root.mFailure = 0;
+    root.mNextMatch = 0;
+    root.mName = (uint)-1;
+    root.mDepth = 0;
+
+    forRange(auto& entry, linkMap.All())
+    {
+      const String& name = entry.first;
+      if (name.Empty())
+        continue;
+
+      uint node = 0;
+      const char* letters = name.c_str();
+      for (uint i = 0; i < name.SizeInBytes(); ++i)
+        node = AddEdge(node, letters[i]);
+
+      mNodes[node].mName = mNames.Size();
+      mNames.PushBack(name);
+      mLinks.PushBack(entry.second);
+    }
+
+    // breadth first so every failure target is finished before the nodes that use it
+    Array<uint> queue;
+    queue.Reserve(mNodes.Size());
+
+    forRange(Edge& edge, mNodes[0].mEdges.All())
+    {
+      mNodes[edge.mNode].mFailure = 0;
+      mNodes[edge.mNode].mNextMatch = 0;
+      queue.PushBack(edge.mNode);
+    }
+
+    for (uint i = 0; i < queue.Size(); ++i)
+    {
+      uint parent = queue[i];
+
+      for (uint e = 0; e < mNodes[parent].mEdges.Size(); ++e)
+      {
+        Edge edge = mNodes[parent].mEdges[e];
+
+        uint failure = mNodes[parent].mFailure;
+        uint target = FindEdge(failure, edge.mLetter);
+        while (target == 0 && failure != 0)
+        {
+          failure = mNodes[failure].mFailure;
+          target = FindEdge(failure, edge.mLetter);
+        }
+
+        Node& child = mNodes[edge.mNode];
+        child.mFailure = target;
+        child.mNextMatch = mNodes[target].mName != (uint)-1 ? target : mNodes[target].mNextMatch;
+
+        queue.PushBack(edge.mNode);
+      }
+    }
+  }
+
+  void DescriptionLinker::AppendLinked(StringRange text, StringBuilder& output, StringParam skipName) const
+  {
+    const char* data = text.Data();
+    uint size = (uint)text.SizeInBytes();
+
+    if (mNodes.Size() <= 1 || size == 0)
+    {
+      output << text;
+      return;
+    }
+
+    // the longest whole word name starting at every byte, -1 if none does
+    Array<uint> matchNames;
+    matchNames.Resize(size, (uint)-1);
+
+    uint node = 0;
+    for (uint i = 0; i < size; ++i)
+    {
+      char letter = data[i];
+
+      uint next = FindEdge(node, letter);
+      while (next == 0 && node != 0)
+      {
+        node = mNodes[node].mFailure;
+        next = FindEdge(node, letter);
+      }
+      node = next;
+
+      // a name running into more identifier letters is part of a longer word
+      if (i + 1 < size && IsIdentifierLetter(data[i + 1]))
+        continue;
+
+      uint match = mNodes[node].mName != (uint)-1 ? node : mNodes[node].mNextMatch;
+      for (; match != 0; match = mNodes[match].mNextMatch)
+      {
+        uint length = mNodes[match].mDepth;
+        uint start = i + 1 - length;
+
+        if (start > 0 && IsIdentifierLetter(data[start - 1]))
+          continue;
+
+        uint previous = matchNames[start];
+        if (previous == (uint)-1 || length > mNames[previous].SizeInBytes())
+          matchNames[start] = mNodes[match].mName;
+      }
+    }
+
+    uint copiedTo = 0;
+    uint i = 0;
+    while (i < size)
+    {
+      // leave existing links as they are
+      if (data[i] == '[' && i + 1 < size && data[i + 1] == '[')
+      {
+        // the range is not null terminated, so the closing brackets are searched within it
+        uint linkEnd = i + 2;
+        while (linkEnd + 1 < size && !(data[linkEnd] == ']' && data[linkEnd + 1] == ']'))
+          ++linkEnd;
+
+        i = linkEnd + 1 < size ? linkEnd + 2 : size;
+        continue;
+      }
+
+      uint name = matchNames[i];
+      if (name == (uint)-1)
+      {
+        ++i;
+        continue;
+      }
+
+      uint length = (uint)mNames[name].SizeInBytes();
+      if (mNames[name] == skipName)
+      {
+        i += length;
+        continue;
+      }
+
+      output << StringRange(data + copiedTo, data + i);
+      output << "[[" << mLinks[name] << "]]";
+
+      i += length;
+      copiedTo = i;
+    }
+
+    output << StringRange(data + copiedTo, data + size);
+  }
+
+  uint DescriptionLinker::FindEdge(uint node, char letter) const
+  {
+    const Array<Edge>& edges = mNodes[node].mEdges;
+
+    uint first = 0;
+    uint count = edges.Size();
+    while (count > 0)
+    {
+      uint step = count / 2;
+      if (edges[first + step].mLetter < letter)
+      {
+        first += step + 1;
+        count -= step + 1;
+      }
+      else
+      {
+        count = step;
+      }
+    }
+
+    if (first < edges.Size() && edges[first].mLetter == letter)
+      return edges[first].mNode;
+
+    return 0;
+  }
+
+  uint DescriptionLinker::AddEdge(uint node, char letter)
+  {
+    uint existing = FindEdge(node, letter);
+    if (existing != 0)
+      return existing;
+
+    uint child = mNodes.Size();
+
+    Node& childNode = mNodes.PushBack();
+    childNode.mFailure = 0;
+    childNode.mNextMatch = 0;
+    childNode.mName = (uint)-1;
+    childNode.mDepth = mNodes[node].mDepth + 1;
+
+    // keep the edges sorted so lookups can binary search them
+    Array<Edge>& edges = mNodes[node].mEdges;
+    edges.PushBack();
+
+    uint insertAt = edges.Size() - 1;
+    for (; insertAt > 0 && edges[insertAt - 1].mLetter > letter; --insertAt)
+      edges[insertAt] = edges[insertAt - 1];
+
+    edges[insertAt].mLetter = letter;
+    edges[insertAt].mNode = child;
+
+    return child;
+  }
+}
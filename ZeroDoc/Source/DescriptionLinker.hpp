@@ -0,0 +1,52 @@
+#pragma once
+
+namespace Zero
+{
+  /// Links every known type name mentioned in plain description text. All names are compiled
+  /// into one Aho-Corasick automaton so a description is rewritten in a single pass no matter
+  /// how many names there are. A name only links as a whole word, the longest name wins where
+  /// several start at the same place, and text already inside a [[link]] is left alone.
+  class DescriptionLinker
+  {
+  public:
+    /// compiles every key of linkMap, the values are what goes between the [[ ]]
+    void Build(const UnsortedMap<String, String>& linkMap);
+
+    /// appends text to output with every name linked, except skipName so pages do not link
+    /// to themselves
+    void AppendLinked(StringRange text, StringBuilder& output, StringParam skipName = String()) const;
+
+  private:
+    struct Edge
+    {
+      char mLetter;
+      uint mNode;
+    };
+
+    struct Node
+    {
+      // sorted by letter
+      Array<Edge> mEdges;
+      // longest proper suffix of this node that is also in the trie
+      uint mFailure;
+      // closest node along the failure chain that ends a name, 0 if none does
+      uint mNextMatch;
+      // index into mNames and mLinks if a name ends here, -1 otherwise
+      uint mName;
+      uint mDepth;
+    };
+
+    /// child of node along letter, 0 if there is none
+    uint FindEdge(uint node, char letter) const;
+
+    uint AddEdge(uint node, char letter);
+
+    // node 0 is the root
+    Array<Node> mNodes;
+    Array<String> mNames;
+    Array<String> mLinks;
+  };
+
+  /// built from gLinkMap every time the markup is written, shared by all ReMarkup writers
+  extern DescriptionLinker gDescriptionLinker;
+}
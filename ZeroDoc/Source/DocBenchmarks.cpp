@@ -0,0 +1,944 @@
+#include "Precompiled.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include "Platform/FileSystem.hpp"
+#include "DocBenchmarks.hpp"
+#include "DocConfiguration.hpp"
+#include "DocTypeTokens.hpp"
+#include "RawDocumentation.hpp"
+#include "FlattenedSource.hpp"
+#include "TypeBlacklist.hpp"
+#include "TrimDocBinary.hpp"
+#include "DocQueryServer.hpp"
+#include "DocSearchIndex.hpp"
+#include "TinyXmlHelpers.hpp"
+#include "WikiOperations.hpp"
+#include "WikiStandIn.hpp"
+
+namespace Zero
+{
+
+typedef std::chrono::high_resolution_clock BenchmarkClock;
+
+/// milliseconds elapsed since start
+static double MillisecondsSince(BenchmarkClock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(BenchmarkClock::now() - start).count();
+}
+
+/// loads and finalizes the trimmed documentation the library benchmarks run on, name is the
+/// benchmark the error message blames when trimmedOutput is not a trimmed documentation file
+static bool LoadTrimmedLibraryForBenchmark(DocGeneratorConfig& config, DocumentationLibrary& lib,
+  cstr name)
+{
+  if (!FileExists(config.mTrimmedOutput.c_str()) || !LoadDocumentationSkeleton(lib, config.mTrimmedOutput))
+  {
+    printf("%s benchmark needs trimmedOutput to point at a trimmed documentation file\n", name);
+    return false;
+  }
+
+  lib.FinalizeDocumentation();
+  return true;
+}
+
+/// loads the text of every codeline in the doxygen xml directory into lines
+static void LoadBenchmarkCodelines(StringParam doxyPath, Array<String>& lines)
+{
+  Array<String> xmlFiles;
+  GetFilesWithPartialName(FilePath::Combine(doxyPath, "xml"), ".xml", &xmlFiles);
+
+  forRange(String& path, xmlFiles.All())
+  {
+    TiXmlDocument doc;
+
+    if (!doc.LoadFile(path.c_str()))
+      continue;
+
+    FlattenedSource source;
+    source.Build(&doc);
+
+    forRange(String& line, source.mLines.All())
+    {
+      if (!line.Empty())
+        lines.PushBack(line);
+    }
+  }
+}
+
+/// times lexing real codelines and compares the linear keyword scan every token used to go
+/// through against the single probe classifier that only runs on identifiers
+bool benchmarkLexer(DocGeneratorConfig& config)
+{
+  const uint iterations = 20;
+
+  if (config.mDoxygenPath.Empty())
+  {
+    printf("lexer benchmark needs doxyPath to point at doxygen output\n");
+    return false;
+  }
+
+  Array<String> lines;
+  LoadBenchmarkCodelines(config.mDoxygenPath, lines);
+
+  if (lines.Empty())
+  {
+    printf("lexer benchmark found no codelines under %s\n", config.mDoxygenPath.c_str());
+    return false;
+  }
+
+  DocDfaState* dfa = DocLangDfa::Get();
+
+  TypeTokens tokens;
+  BenchmarkClock::time_point start = BenchmarkClock::now();
+
+  for (uint i = 0; i < iterations; ++i)
+  {
+    tokens.Clear();
+    forRange(String& line, lines.All())
+    {
+      AppendTokensFromString(dfa, line, &tokens);
+    }
+  }
+
+  double lexTime = MillisecondsSince(start) / iterations;
+
+  // every token goes back to whatever the dfa accepted before being classified again
+  Array<DocTokenType::Enum> lexedTypes;
+  lexedTypes.Reserve(tokens.Size());
+  forRange(DocToken& token, tokens.All())
+  {
+    lexedTypes.PushBack(token.mEnumTokenType > DocTokenType::KeywordStart
+      ? DocTokenType::Identifier : token.mEnumTokenType);
+  }
+
+  uint keywordCount = 0;
+  uint linearKeywordCount = 0;
+
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    linearKeywordCount = 0;
+    for (uint j = 0; j < tokens.Size(); ++j)
+    {
+      DocToken& token = tokens[j];
+      token.mEnumTokenType = lexedTypes[j];
+      CheckForKeywordLinear(token);
+
+      if (token.mEnumTokenType > DocTokenType::KeywordStart)
+        ++linearKeywordCount;
+    }
+  }
+  double linearTime = MillisecondsSince(start) / iterations;
+
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    keywordCount = 0;
+    for (uint j = 0; j < tokens.Size(); ++j)
+    {
+      DocToken& token = tokens[j];
+      token.mEnumTokenType = lexedTypes[j];
+
+      if (token.mEnumTokenType == DocTokenType::Identifier)
+        token.mEnumTokenType = ClassifyKeyword(token.mText.c_str(), token.mText.SizeInBytes());
+
+      if (token.mEnumTokenType > DocTokenType::KeywordStart)
+        ++keywordCount;
+    }
+  }
+  double probeTime = MillisecondsSince(start) / iterations;
+
+  printf("lexer benchmark: %u codelines, %u tokens, %u keywords\n", lines.Size(), tokens.Size(), keywordCount);
+  printf("  full lex per pass:             %10.3f ms\n", lexTime);
+  printf("  linear keyword scan per pass:  %10.3f ms\n", linearTime);
+  printf("  keyword probe per pass:        %10.3f ms\n", probeTime);
+
+  if (keywordCount != linearKeywordCount)
+  {
+    printf("  keyword counts do not match, linear scan found %u\n", linearKeywordCount);
+    return false;
+  }
+
+  return true;
+}
+
+/// the substring trimming ignore check the path trie replaced, with the ancestor walk fixed
+static bool TrimmingIgnoreCheck(const IgnoreList& ignoreList, StringParam dir)
+{
+  String relativeDir = dir;
+  if (dir.StartsWith(ignoreList.mDoxyPath))
+    relativeDir = dir.SubStringFromByteIndices(ignoreList.mDoxyPath.SizeInBytes(), dir.SizeInBytes());
+
+  if (ignoreList.mDirectories.Contains(relativeDir))
+    return true;
+
+  StringRange subPath = relativeDir.SubString(relativeDir.Begin(), relativeDir.FindLastOf('\\').Begin());
+
+  while (subPath.SizeInBytes() > 2)
+  {
+    if (ignoreList.mDirectories.Contains(String(subPath)))
+      return true;
+
+    subPath = subPath.SubString(subPath.Begin(), subPath.FindLastOf('\\').Begin());
+  }
+
+  return false;
+}
+
+/// times ignore list and blacklist checks against the string building versions they replaced
+bool benchmarkIgnoreList(DocGeneratorConfig& config)
+{
+  const uint iterations = 200;
+  const uint moduleCount = 64;
+
+  // synthetic layout so the benchmark does not depend on what doxygen output is around
+  IgnoreList ignoreList;
+  ignoreList.mDoxyPath = "C:\\Doxygen";
+
+  for (uint i = 0; i < moduleCount; i += 4)
+    ignoreList.mDirectories.Insert(String::Format("\\Systems\\Module%u\\Private", i));
+  ignoreList.Compile();
+
+  Array<String> paths;
+  for (uint i = 0; i < moduleCount; ++i)
+  {
+    for (uint j = 0; j < 8; ++j)
+    {
+      paths.PushBack(String::Format("C:\\Doxygen\\Systems\\Module%u\\Private\\xml\\class_%u.xml", i, j));
+      paths.PushBack(String::Format("C:\\Doxygen\\Systems\\Module%u\\Public\\xml\\class_%u.xml", i, j));
+    }
+  }
+
+  TypeBlacklist blacklist;
+  Array<String> typeNames;
+
+  for (uint i = 0; i < 512; ++i)
+  {
+    typeNames.PushBack(String::Format("SomeType%u", i));
+
+    if (i % 8 == 0)
+      blacklist.mTypeNames.Insert(String::Format("sometype%u", i));
+  }
+
+  // matching results is part of the benchmark passing
+  uint mismatches = 0;
+  uint ignoredCount = 0;
+  uint blacklistedCount = 0;
+
+  forRange(String& path, paths.All())
+  {
+    bool ignored = ignoreList.DirectoryIsOnIgnoreList(path);
+    ignoredCount += ignored;
+    mismatches += ignored != TrimmingIgnoreCheck(ignoreList, path);
+  }
+
+  forRange(String& typeName, typeNames.All())
+  {
+    bool blacklisted = blacklist.isOnBlacklist(typeName);
+    blacklistedCount += blacklisted;
+    mismatches += blacklisted != blacklist.mTypeNames.Contains(typeName.ToLower());
+  }
+
+  uint hits = 0;
+  BenchmarkClock::time_point start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    forRange(String& path, paths.All())
+      hits += TrimmingIgnoreCheck(ignoreList, path);
+  }
+  double trimmingTime = MillisecondsSince(start) / iterations;
+
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    forRange(String& path, paths.All())
+      hits += ignoreList.DirectoryIsOnIgnoreList(path);
+  }
+  double trieTime = MillisecondsSince(start) / iterations;
+
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    forRange(String& typeName, typeNames.All())
+      hits += blacklist.mTypeNames.Contains(typeName.ToLower());
+  }
+  double lowerTime = MillisecondsSince(start) / iterations;
+
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    forRange(String& typeName, typeNames.All())
+      hits += blacklist.isOnBlacklist(typeName);
+  }
+  double foldedTime = MillisecondsSince(start) / iterations;
+
+  printf("ignore list benchmark: %u paths (%u ignored), %u type names (%u blacklisted)\n",
+    paths.Size(), ignoredCount, typeNames.Size(), blacklistedCount);
+  printf("  substring ignore checks per pass:  %10.3f ms\n", trimmingTime);
+  printf("  path trie ignore checks per pass:  %10.3f ms\n", trieTime);
+  printf("  ToLower blacklist per pass:        %10.3f ms\n", lowerTime);
+  printf("  pre-folded blacklist per pass:     %10.3f ms\n", foldedTime);
+  printf("  (%u hits)\n", hits);
+
+  if (mismatches != 0)
+  {
+    printf("  %u checks disagreed with the old implementation\n", mismatches);
+    return false;
+  }
+
+  return true;
+}
+
+/// times loading the trimmed documentation through the text loader against mapping the binary
+/// copy, both fully materialized and for a single class lookup like the engine does at startup
+bool benchmarkTrimLoad(DocGeneratorConfig& config)
+{
+  const uint iterations = 5;
+
+  if (!FileExists(config.mTrimmedOutput.c_str()))
+  {
+    printf("trimLoad benchmark needs trimmedOutput to point at a trimmed documentation file\n");
+    return false;
+  }
+
+  DocumentationLibrary textLib;
+  if (!LoadDocumentationSkeleton(textLib, config.mTrimmedOutput))
+    return false;
+
+  // write the binary copy from what the text loader produced so both hold the same docs. It
+  // goes next to the text file so the configured binary output is left alone
+  String binaryPath = BuildString(config.mTrimmedOutput, ".benchmark.bin");
+  if (!SaveTrimDocToBinaryFile(textLib, binaryPath))
+    return false;
+
+  BenchmarkClock::time_point start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    DocumentationLibrary lib;
+    LoadDocumentationSkeleton(lib, config.mTrimmedOutput);
+  }
+  double textTime = MillisecondsSince(start) / iterations;
+
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    BinaryTrimDocReader reader;
+    reader.Open(binaryPath);
+    reader.LoadAll();
+  }
+  double binaryTime = MillisecondsSince(start) / iterations;
+
+  String lookupName = textLib.mClasses.Empty() ? String() : textLib.mClasses.Back()->mName;
+
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    BinaryTrimDocReader reader;
+    reader.Open(binaryPath);
+    reader.FindClass(lookupName);
+  }
+  double lookupTime = MillisecondsSince(start) / iterations;
+
+  // every class has to come back out of the binary file with the same members
+  uint mismatches = 0;
+
+  BinaryTrimDocReader reader;
+  if (!reader.Open(binaryPath))
+    return false;
+
+  forRange(ClassDoc* textClass, textLib.mClasses.All())
+  {
+    ClassDoc* binaryClass = reader.FindClass(textClass->mName);
+
+    if (!binaryClass
+      || binaryClass->mBaseClass != textClass->mBaseClass
+      || binaryClass->mDescription != textClass->mDescription
+      || binaryClass->mMethods.Size() != textClass->mMethods.Size()
+      || binaryClass->mProperties.Size() != textClass->mProperties.Size()
+      || binaryClass->mEventsSent.Size() != textClass->mEventsSent.Size())
+    {
+      ++mismatches;
+    }
+  }
+
+  DocumentationLibrary& binaryLib = reader.LoadAll();
+  mismatches += binaryLib.mEnums.Size() != textLib.mEnums.Size();
+  mismatches += binaryLib.mFlags.Size() != textLib.mFlags.Size();
+
+  printf("trim load benchmark: %u classes, %u enums, %u flags\n",
+    textLib.mClasses.Size(), textLib.mEnums.Size(), textLib.mFlags.Size());
+  printf("  text load:                  %10.3f ms\n", textTime);
+  printf("  binary map and load all:    %10.3f ms\n", binaryTime);
+  printf("  binary map and find class:  %10.3f ms\n", lookupTime);
+
+  if (mismatches != 0)
+  {
+    printf("  %u docs differ between the text and binary files\n", mismatches);
+    return false;
+  }
+
+  return true;
+}
+
+/// serves the trimmed documentation on a free local port and load tests it with a mix of
+/// lookups of every kind the server answers
+bool benchmarkQuery(DocGeneratorConfig& config)
+{
+  const uint requestCount = 20000;
+
+  DocumentationLibrary lib;
+  if (!LoadTrimmedLibraryForBenchmark(config, lib, "query"))
+    return false;
+
+  DocQueryServer server(lib);
+  if (!server.Start(0))
+    return false;
+
+  Array<String> requests;
+  forRange(ClassDoc* classDoc, lib.mClasses.All())
+  {
+    requests.PushBack(BuildString("get ", classDoc->mName));
+
+    if (!classDoc->mMethods.Empty())
+      requests.PushBack(BuildString("get ", classDoc->mName, ".", classDoc->mMethods[0]->mName));
+
+    requests.PushBack(BuildString("prefix ", classDoc->mName.SubStringFromByteIndices(0,
+      Math::Min(classDoc->mName.SizeInBytes(), (size_t)3))));
+  }
+  requests.PushBack("fuzzy trnsfrm");
+  requests.PushBack("fuzzy getpos");
+
+  std::thread serverThread(&DocQueryServer::Run, &server);
+
+  bool result = RunDocQueryLoadTest(server.GetPort(), requests, requestCount);
+
+  server.Stop();
+  serverThread.join();
+
+  return result;
+}
+
+/// lexes every type string of the trimmed documentation the way loading does, once straight
+/// through the dfa and once through a cold token cache
+bool benchmarkTokenCache(DocGeneratorConfig& config)
+{
+  const uint iterations = 5;
+
+  DocumentationLibrary lib;
+  if (!LoadTrimmedLibraryForBenchmark(config, lib, "tokenCache"))
+    return false;
+
+  // the same strings, in the same order, that LoadFromXmlDoc and RawMethodDoc tokenize
+  Array<String> typeStrings;
+  forRange(ClassDoc* classDoc, lib.mClasses.All())
+  {
+    typeStrings.PushBack(classDoc->mName);
+
+    forRange(MethodDoc* methodDoc, classDoc->mMethods.All())
+    {
+      typeStrings.PushBack(methodDoc->mReturnType);
+
+      forRange(ParameterDoc* paramDoc, methodDoc->mParameterList.All())
+      {
+        typeStrings.PushBack(paramDoc->mType);
+      }
+    }
+    forRange(PropertyDoc* propDoc, classDoc->mProperties.All())
+    {
+      typeStrings.PushBack(propDoc->mType);
+    }
+  }
+
+  DocDfaState* dfa = DocLangDfa::Get();
+
+  uint uncachedTokens = 0;
+  BenchmarkClock::time_point start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    uncachedTokens = 0;
+    forRange(String& typeString, typeStrings.All())
+    {
+      TypeTokens tokens;
+      AppendTokensFromString(dfa, typeString, &tokens);
+      uncachedTokens += tokens.Size();
+    }
+  }
+  double uncachedTime = MillisecondsSince(start) / iterations;
+
+  uint cachedTokens = 0;
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    // every run of the generator starts out cold
+    TokenCache cache;
+
+    cachedTokens = 0;
+    forRange(String& typeString, typeStrings.All())
+    {
+      TypeTokens tokens;
+      cache.Append(typeString, &tokens);
+      cachedTokens += tokens.Size();
+    }
+
+    if (i + 1 == iterations)
+    {
+      printf("tokenCache benchmark: %u type strings, %u tokens\n", typeStrings.Size(), uncachedTokens);
+      printf("  ");
+      cache.PrintStats();
+    }
+  }
+  double cachedTime = MillisecondsSince(start) / iterations;
+
+  printf("  lexed every time:   %10.3f ms\n", uncachedTime);
+  printf("  through the cache:  %10.3f ms\n", cachedTime);
+
+  if (cachedTokens != uncachedTokens)
+  {
+    printf("  the cache returned %u tokens instead of %u\n", cachedTokens, uncachedTokens);
+    return false;
+  }
+
+  return true;
+}
+
+/// appends every member under node that has a brief description and every parameter of those
+static void CollectDescribedMembers(TiXmlNode* node, Array<TiXmlElement*>& members,
+  Array<TiXmlElement*>& parameters)
+{
+  for (TiXmlElement* child = node->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+  {
+    if (strcmp(child->Value(), gElementTags[eMEMBERDEF]) == 0)
+    {
+      if (child->FirstChildElement(gElementTags[eBRIEFDESCRIPTION]))
+        members.PushBack(child);
+
+      for (TiXmlElement* param = child->FirstChildElement(gElementTags[ePARAM]); param != nullptr;
+        param = param->NextSiblingElement(gElementTags[ePARAM]))
+      {
+        parameters.PushBack(param);
+      }
+      continue;
+    }
+
+    CollectDescribedMembers(child, members, parameters);
+  }
+}
+
+/// the brief or inbody node of a parameter the way RawMethodDoc looks for it
+static TiXmlNode* GetParameterDescriptionNode(TiXmlElement* param)
+{
+  TiXmlNode* brief = GetFirstNodeOfChildType(param, gElementTags[eBRIEFDESCRIPTION]);
+
+  if (!brief)
+    brief = GetFirstNodeOfChildType(param, "inbodydescription");
+
+  return brief;
+}
+
+/// runs the old and the new way of getting the descriptions of one call site over elements,
+/// prints both times and returns how many descriptions came out different
+template <typename OldFn, typename NewFn>
+static uint CompareDescriptionSite(cstr siteName, const Array<TiXmlElement*>& elements,
+  OldFn oldDescription, NewFn newDescription)
+{
+  const uint iterations = 5;
+
+  Array<String> oldDescriptions;
+  BenchmarkClock::time_point start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    oldDescriptions.Clear();
+    forRange(TiXmlElement* element, elements.All())
+    {
+      oldDescriptions.PushBack(oldDescription(element));
+    }
+  }
+  double oldTime = MillisecondsSince(start) / iterations;
+
+  Array<String> newDescriptions;
+  start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    newDescriptions.Clear();
+    forRange(TiXmlElement* element, elements.All())
+    {
+      newDescriptions.PushBack(newDescription(element));
+    }
+  }
+  double newTime = MillisecondsSince(start) / iterations;
+
+  printf("  %s (%u):\n", siteName, elements.Size());
+  printf("    extract, trim and clean:  %10.3f ms\n", oldTime);
+  printf("    single pass:              %10.3f ms\n", newTime);
+
+  uint mismatches = 0;
+  for (uint i = 0; i < elements.Size(); ++i)
+  {
+    if (oldDescriptions[i] != newDescriptions[i])
+    {
+      if (mismatches == 0)
+        printf("    first mismatch:\n      '%s'\n      '%s'\n", oldDescriptions[i].c_str(), newDescriptions[i].c_str());
+      ++mismatches;
+    }
+  }
+
+  if (mismatches != 0)
+    printf("    %u descriptions came out different\n", mismatches);
+
+  return mismatches;
+}
+
+/// times every call site that went from DoxyToString or a StringBuilder, Trim and
+/// CleanRedundantSpacesInDesc to a single DescriptionBuilder pass against the code it replaced,
+/// which it has to match. Class descriptions were only ever trimmed and did not change
+bool benchmarkDescriptions(DocGeneratorConfig& config)
+{
+  if (config.mDoxygenPath.Empty())
+  {
+    printf("descriptions benchmark needs doxyPath to point at doxygen output\n");
+    return false;
+  }
+
+  Array<String> xmlFiles;
+  GetFilesWithPartialName(FilePath::Combine(config.mDoxygenPath, "xml"), ".xml", &xmlFiles);
+
+  Array<TiXmlDocument*> documents;
+  Array<TiXmlElement*> members;
+  Array<TiXmlElement*> parameters;
+  forRange(String& path, xmlFiles.All())
+  {
+    TiXmlDocument* doc = new TiXmlDocument;
+
+    if (!doc->LoadFile(path.c_str()))
+    {
+      delete doc;
+      continue;
+    }
+
+    documents.PushBack(doc);
+    CollectDescribedMembers(doc, members, parameters);
+  }
+
+  if (members.Empty())
+  {
+    printf("descriptions benchmark found no brief descriptions under %s\n", config.mDoxygenPath.c_str());
+    for (uint i = 0; i < documents.Size(); ++i)
+      delete documents[i];
+    return false;
+  }
+
+  printf("descriptions benchmark: %u files\n", documents.Size());
+
+  // variable and method descriptions
+  uint mismatches = CompareDescriptionSite("member briefs", members,
+    [](TiXmlElement* element)
+    {
+      String description = DoxyToString(element, gElementTags[eBRIEFDESCRIPTION]).Trim();
+      return CleanRedundantSpacesInDesc(description);
+    },
+    [](TiXmlElement* element)
+    {
+      return DoxyToDescription(element, gElementTags[eBRIEFDESCRIPTION]);
+    });
+
+  // method parameters, a parameter without either description stays empty in both
+  mismatches += CompareDescriptionSite("parameters", parameters,
+    [](TiXmlElement* param)
+    {
+      String description;
+      if (TiXmlNode* brief = GetParameterDescriptionNode(param))
+      {
+        StringBuilder builder;
+        getTextFromParaNodes(brief, &builder);
+        description = builder.ToString().Trim();
+      }
+      return CleanRedundantSpacesInDesc(description);
+    },
+    [](TiXmlElement* param)
+    {
+      String description;
+      if (TiXmlNode* brief = GetParameterDescriptionNode(param))
+      {
+        DescriptionBuilder builder;
+        getTextFromParaNodes(brief, &builder);
+        description = builder.ToString();
+      }
+      return description;
+    });
+
+  for (uint i = 0; i < documents.Size(); ++i)
+    delete documents[i];
+
+  return mismatches == 0;
+}
+
+/// publishes library to a fresh stand-in wiki with at most maxInFlight requests on the wire and
+/// checks every class ended up with exactly the page it was sent. Returns false on a mismatch
+static bool PublishToStandIn(DocumentationLibrary& library, uint maxInFlight, WikiPublishStats& stats)
+{
+  WikiStandInServer server;
+
+  // a little server time so requests overlapping is what matters, and failures to retry
+  server.mResponseDelayMs = 2;
+  server.mFailEvery = 40;
+
+  if (!server.Start(0))
+    return false;
+
+  std::thread serverThread(&WikiStandInServer::Run, &server);
+
+  WikiPublishSettings settings;
+  settings.mApiUrl = String::Format("http://127.0.0.1:%u/api.asp", server.GetPort());
+  settings.mEmail = "benchmark";
+  settings.mPassword = "benchmark";
+  settings.mMaxInFlight = maxInFlight;
+  settings.mRetryDelayMs = 10;
+
+  bool published = PublishLibraryToWiki(library, settings, stats);
+
+  server.Stop();
+  serverThread.join();
+
+  HashMap<String, WikiStandInServer::Article*> articles;
+  forRange(WikiStandInServer::Article& article, server.mArticles.All())
+  {
+    articles[article.mHeadline] = &article;
+  }
+
+  uint mismatches = 0;
+  forRange(ClassDoc* classDoc, library.mClasses.All())
+  {
+    WikiStandInServer::Article* article = articles.FindValue(classDoc->mName, nullptr);
+    mismatches += article == nullptr || article->mEdits != 1 || article->mBody.Empty();
+  }
+
+  printf("  %u in flight: %u requests reached the stand-in over %u connections, %u answered with 503\n",
+    maxInFlight, server.mRequestCount, server.mAcceptedCount, server.mFailedCount);
+
+  if (mismatches != 0)
+    printf("  %u classes did not get exactly one upload\n", mismatches);
+
+  return published && mismatches == 0;
+}
+
+/// publishes every class of the trimmed documentation to the stand-in wiki, one request at a
+/// time like the old serial uploads and then with the pipeline
+bool benchmarkWiki(DocGeneratorConfig& config)
+{
+  DocumentationLibrary lib;
+  if (!LoadTrimmedLibraryForBenchmark(config, lib, "wiki"))
+    return false;
+
+  printf("wiki benchmark: %u classes\n", lib.mClasses.Size());
+
+  WikiPublishStats serialStats;
+  bool result = PublishToStandIn(lib, 1, serialStats);
+
+  WikiPublishStats pipelinedStats;
+  uint maxInFlight = (uint)Math::Max(config.mWikiConnections, 1);
+  result &= PublishToStandIn(lib, maxInFlight, pipelinedStats);
+
+  printf("one request at a time:\n");
+  serialStats.Print();
+  printf("%u requests at a time:\n", maxInFlight);
+  pipelinedStats.Print();
+
+  return result;
+}
+
+/// true if text contains every one of the lower case words
+static bool ContainsAllWords(StringParam text, const Array<String>& words)
+{
+  forRange(const String& word, words.All())
+  {
+    if (!text.Contains(word))
+      return false;
+  }
+  return true;
+}
+
+/// builds the search index of the trimmed documentation and times queries against it and
+/// against scanning the lower cased docs for the same words
+bool benchmarkSearch(DocGeneratorConfig& config)
+{
+  const uint iterations = 5;
+
+  DocumentationLibrary lib;
+  if (!LoadTrimmedLibraryForBenchmark(config, lib, "search"))
+    return false;
+
+  String indexPath = BuildString(config.mTrimmedOutput, ".searchindex");
+
+  BenchmarkClock::time_point start = BenchmarkClock::now();
+  for (uint i = 0; i < iterations; ++i)
+  {
+    if (!SaveSearchIndexFile(lib, indexPath))
+      return false;
+  }
+  double buildTime = MillisecondsSince(start) / iterations;
+
+  SearchIndexReader reader;
+  if (!reader.Open(indexPath))
+    return false;
+
+  Array<String> queries;
+  forRange(ClassDoc* classDoc, lib.mClasses.All())
+  {
+    queries.PushBack(classDoc->mName);
+  }
+  queries.PushBack("world position");
+  queries.PushBack("collision event");
+  queries.PushBack("the");
+
+  Array<uint> results;
+  uint indexMatches = 0;
+
+  start = BenchmarkClock::now();
+  forRange(String& query, queries.All())
+  {
+    results.Clear();
+    reader.Search(query, results);
+    indexMatches += results.Size();
+  }
+  double indexTime = MillisecondsSince(start);
+
+  // what answering the same queries costs without an index
+  Array<String> lowerDocs;
+  forRange(ClassDoc* classDoc, lib.mClasses.All())
+  {
+    lowerDocs.PushBack(BuildString(classDoc->mName, " ", classDoc->mDescription).ToLower());
+
+    forRange(MethodDoc* methodDoc, classDoc->mMethods.All())
+    {
+      lowerDocs.PushBack(BuildString(methodDoc->mName, " ", methodDoc->mDescription).ToLower());
+    }
+    forRange(PropertyDoc* propDoc, classDoc->mProperties.All())
+    {
+      lowerDocs.PushBack(BuildString(propDoc->mName, " ", propDoc->mDescription).ToLower());
+    }
+  }
+
+  uint scanMatches = 0;
+  Array<String> words;
+
+  start = BenchmarkClock::now();
+  forRange(String& query, queries.All())
+  {
+    words.Clear();
+    TokenizeSearchText(query, false, words);
+
+    forRange(String& lowerDoc, lowerDocs.All())
+    {
+      scanMatches += ContainsAllWords(lowerDoc, words);
+    }
+  }
+  double scanTime = MillisecondsSince(start);
+
+  // every class has to be found by its own name
+  uint mismatches = 0;
+  Array<String> nameTerms;
+
+  for (uint i = 0; i < lib.mClasses.Size(); ++i)
+  {
+    ClassDoc* classDoc = lib.mClasses[i];
+
+    nameTerms.Clear();
+    TokenizeSearchText(classDoc->mName, false, nameTerms);
+
+    // too short to have been indexed
+    if (nameTerms.Empty())
+      continue;
+
+    results.Clear();
+    reader.Search(classDoc->mName, results);
+
+    bool found = false;
+    forRange(uint document, results.All())
+    {
+      found |= reader.GetDocumentKind(document) == DocQueryKind::Class
+        && classDoc->mName == reader.GetDocumentName(document);
+    }
+    mismatches += !found;
+  }
+
+  printf("search benchmark: %u documents, %u terms, %u queries\n",
+    reader.GetDocumentCount(), reader.GetTermCount(), queries.Size());
+  printf("  build and write index:   %10.3f ms\n", buildTime);
+  printf("  indexed queries:         %10.3f ms (%u matches)\n", indexTime, indexMatches);
+  printf("  scanned queries:         %10.3f ms (%u substring matches)\n", scanTime, scanMatches);
+
+  if (mismatches != 0)
+  {
+    printf("  %u classes were not found by their own name\n", mismatches);
+    return false;
+  }
+
+  return true;
+}
+
+bool RunBenchmarks(StringParam name, DocGeneratorConfig& config)
+{
+  bool runAll = name == "all";
+  bool ranAny = false;
+  bool retVal = true;
+
+  if (runAll || name == "lexer")
+  {
+    retVal &= benchmarkLexer(config);
+    ranAny = true;
+  }
+
+  if (runAll || name == "ignoreList")
+  {
+    retVal &= benchmarkIgnoreList(config);
+    ranAny = true;
+  }
+
+  if (runAll || name == "trimLoad")
+  {
+    retVal &= benchmarkTrimLoad(config);
+    ranAny = true;
+  }
+
+  if (runAll || name == "query")
+  {
+    retVal &= benchmarkQuery(config);
+    ranAny = true;
+  }
+
+  if (runAll || name == "search")
+  {
+    retVal &= benchmarkSearch(config);
+    ranAny = true;
+  }
+
+  if (runAll || name == "tokenCache")
+  {
+    retVal &= benchmarkTokenCache(config);
+    ranAny = true;
+  }
+
+  if (runAll || name == "descriptions")
+  {
+    retVal &= benchmarkDescriptions(config);
+    ranAny = true;
+  }
+
+  if (runAll || name == "wiki")
+  {
+    retVal &= benchmarkWiki(config);
+    ranAny = true;
+  }
+
+  if (!ranAny)
+  {
+    printf("unknown benchmark: %s\n", name.c_str());
+    return false;
+  }
+
+  return retVal;
+}
+
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Zero
+{
+  struct DocGeneratorConfig;
+
+  /// runs the benchmark with the passed in name, "all" runs every benchmark.
+  /// Returns false if the name does not match any benchmark or a benchmark failed.
+  bool RunBenchmarks(StringParam name, DocGeneratorConfig& config);
+}
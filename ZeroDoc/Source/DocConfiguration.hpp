@@ -14,6 +14,8 @@ struct DocGeneratorConfig
   String mDoxygenPath;
   /// this gets us the doc file that zilch will fill out from the engine meta
   String mZeroDocFile;
+  /// with scanSources, every source file under this directory is known even if no class points at it
+  String mSourceDirectory;
   /// defaults to file in rawDocDirectory honestly it should always be with a documentation folder
   String mTypedefLibraryFile;
   /// where the documentation should output
@@ -44,6 +46,8 @@ struct DocGeneratorConfig
   ///// Trimmed Strings /////
   /// defaults to trimdoc.data in the output directory
   String mTrimmedOutput;
+  /// defaults to Documentation.bin in the output directory, the mappable copy of the trimmed output
+  String mTrimmedBinaryOutput;
   /// where to load the trimmed typedef doclib location
   String mTrimmedTypedefFile;
 
@@ -53,9 +57,32 @@ struct DocGeneratorConfig
   /// where to output the command list
   String mCommandListFile;
 
+  ///// Wiki Strings /////
+  /// the api page of the wiki publishWiki uploads to
+  String mWikiUrl;
+  /// what publishWiki logs on to the wiki with
+  String mWikiEmail;
+  String mWikiPassword;
+
   /// what macro test to run, if -1, no tests will be run, if max(int), all tests will run
   int mRunMacroTest;
 
+  /// what benchmark to run ("lexer", "ignoreList", "trimLoad", "query", "search", "tokenCache", "descriptions", "wiki" or "all"), if empty, no benchmarks will be run
+  String mRunBenchmark;
+
+  /// how many threads the per-class passes can use, 0 means use every hardware thread
+  int mThreadCount;
+
+  /// if not 0, the trimmed documentation is served for lookups on this port of 127.0.0.1
+  int mQueryServerPort;
+
+  /// how many requests publishWiki keeps on the wire at once
+  int mWikiConnections;
+  /// how many times publishWiki sends a request again after a network or server error
+  int mWikiRetries;
+  /// if not 0, a stand-in for the wiki api is served on this port of 127.0.0.1
+  int mWikiStandInPort;
+
   ///// Raw Bools /////
   /// if true, we will replace any typedefs in documentation with the underlying type
   bool mReplaceTypes;
@@ -71,11 +98,23 @@ struct DocGeneratorConfig
   bool mWarnOnUndocumentedBoundData;
   /// if true, we will print the help text then exit
   bool mHelp;
+  /// if true, we keep running after generating and regenerate whatever doxygen changes affect
+  bool mWatch;
+  /// if true, events, exceptions and macros are scanned from the original source files instead
+  /// of the programlisting xml, so doxygen can run with XML_PROGRAMLISTING off
+  bool mScanSources;
 
   ///// Trimmed Bools /////
   
   // if true, we will output the trimmed documentation files
   bool mCreateTrimmed;
+  /// if true, every raw class is trimmed and freed while loading, as soon as its base classes
+  /// were trimmed, instead of keeping the whole raw library alive until it is filled
+  bool mLowMemoryTrim;
+
+  ///// Wiki Bools /////
+  /// if true, instead of generating, the trimmed documentation is published to the wiki
+  bool mPublishWiki;
 };
 
 inline DocGeneratorConfig LoadConfigurations(StringMap& params)
@@ -84,6 +123,7 @@ inline DocGeneratorConfig LoadConfigurations(StringMap& params)
 
   ///// Load Macro Options /////
   config.mRunMacroTest = GetStringValue<int>(params, "runMacroTest", -1);
+  config.mRunBenchmark = GetStringValue<String>(params, "runBenchmark", "");
 
   ///// Load Raw Options /////
   config.mReplaceTypes = GetStringValue<bool>(params, "replaceTypes", false);
@@ -93,11 +133,19 @@ inline DocGeneratorConfig LoadConfigurations(StringMap& params)
   config.mHelp = GetStringValue<bool>(params, "help", false);
   config.mWarnOnUndocumentedBoundData = GetStringValue<bool>(params, "warnOnUndocumentedBoundData", false);
   config.mTagAllAsUnbound = GetStringValue<bool>(params, "tagAllAsUnbound", false);
+  config.mThreadCount = GetStringValue<int>(params, "threadCount", 0);
+  config.mWatch = GetStringValue<bool>(params, "watch", false);
+  config.mScanSources = GetStringValue<bool>(params, "scanSources", false);
+  config.mQueryServerPort = GetStringValue<int>(params, "queryServerPort", 0);
 
   //get the path to the doxygen file
   config.mDoxygenPath = GetStringValue<String>(params, "doxyPath", "");
   config.mDoxygenPath = FilePath::Normalize(config.mDoxygenPath);
 
+  // source files doxygen was run on, only needed by scanSources if doxygen's paths are incomplete
+  config.mSourceDirectory = GetStringValue<String>(params, "sourceDirectory", "");
+  config.mSourceDirectory = FilePath::Normalize(config.mSourceDirectory);
+
   //load the zero documentation (before merging with doxy) and the documentation file
   config.mZeroDocFile = GetStringValue<String>(params, "zeroDocFile", "");
   config.mZeroDocFile = FilePath::Normalize(config.mZeroDocFile);
@@ -153,11 +201,28 @@ inline DocGeneratorConfig LoadConfigurations(StringMap& params)
 
   ///// Load Trim Options /////
   config.mCreateTrimmed = GetStringValue<bool>(params, "createTrimmed", false);
+  config.mLowMemoryTrim = GetStringValue<bool>(params, "lowMemoryTrim", false);
 
   config.mTrimmedOutput = GetStringValue<String>(params, "trimmedOutput",
     BuildString(config.mOutputDirectory, "\\Documentation.data"));
   config.mTrimmedOutput = FilePath::Normalize(config.mTrimmedOutput);
 
+  // the binary copy defaults to the trimmed output's path with a .bin extension, so it lands
+  // wherever the trimmed output does even without an output directory
+  cstr trimmedPath = config.mTrimmedOutput.c_str();
+  cstr trimmedExtension = strrchr(trimmedPath, '.');
+  String binaryOutput;
+
+  // a dot in a directory name does not start an extension
+  if (trimmedExtension == nullptr || strchr(trimmedExtension, '\\') || strchr(trimmedExtension, '/'))
+    binaryOutput = BuildString(config.mTrimmedOutput, ".bin");
+  else
+    binaryOutput = BuildString(config.mTrimmedOutput.SubStringFromByteIndices(0,
+      trimmedExtension - trimmedPath), ".bin");
+
+  config.mTrimmedBinaryOutput = GetStringValue<String>(params, "trimmedBinaryOutput", binaryOutput);
+  config.mTrimmedBinaryOutput = FilePath::Normalize(config.mTrimmedBinaryOutput);
+
   config.mTrimmedTypedefFile = GetStringValue<String>(params, "trimmedTypedefFile", "");
   config.mTrimmedTypedefFile = FilePath::Normalize(config.mTrimmedTypedefFile);
 
@@ -168,6 +233,15 @@ inline DocGeneratorConfig LoadConfigurations(StringMap& params)
   config.mCommandListFile = GetStringValue<String>(params, "commandListFile", "");
   config.mCommandListFile = FilePath::Normalize(config.mCommandListFile);
 
+  ///// Load Wiki Options /////
+  config.mPublishWiki = GetStringValue<bool>(params, "publishWiki", false);
+  config.mWikiUrl = GetStringValue<String>(params, "wikiUrl", "http://zeroengine0.digipen.edu/api.asp");
+  config.mWikiEmail = GetStringValue<String>(params, "wikiEmail", "");
+  config.mWikiPassword = GetStringValue<String>(params, "wikiPassword", "");
+  config.mWikiConnections = GetStringValue<int>(params, "wikiConnections", 8);
+  config.mWikiRetries = GetStringValue<int>(params, "wikiRetries", 3);
+  config.mWikiStandInPort = GetStringValue<int>(params, "wikiStandInPort", 0);
+
   return config;
 }
 
@@ -0,0 +1,115 @@
+#include "Precompiled.hpp"
+
+#include "DocOutputSink.hpp"
+#include "RawDocumentation.hpp"
+
+namespace Zero
+{
+  ////////////////////////////////////////////////////////////////////////
+  // DocOutputSink
+  ////////////////////////////////////////////////////////////////////////
+  DocOutputSink::DocOutputSink()
+    : mWrittenFiles(0)
+    , mSkippedFiles(0)
+    , mWrittenBytes(0)
+    , mSkippedBytes(0)
+  {
+  }
+
+  bool DocOutputSink::Write(StringParam path, const byte* data, uint size)
+  {
+    if (MatchesExistingFile(path, data, size))
+    {
+      ++mSkippedFiles;
+      mSkippedBytes += size;
+      return true;
+    }
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+      FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      Error("Unable to open file for writing: %s\n", path.c_str());
+      WriteLog("ERROR: unable to open file for writing: %s\n", path.c_str());
+      return false;
+    }
+
+    DWORD written = 0;
+    bool success = size == 0 || (WriteFile(file, data, size, &written, nullptr) && written == size);
+
+    CloseHandle(file);
+
+    if (!success)
+    {
+      Error("Failed writing file: %s\n", path.c_str());
+      WriteLog("ERROR: failed writing file: %s\n", path.c_str());
+      return false;
+    }
+
+    ++mWrittenFiles;
+    mWrittenBytes += size;
+    return true;
+  }
+
+  bool DocOutputSink::WriteText(StringParam path, StringRange text)
+  {
+    return Write(path, (const byte*)text.Data(), text.SizeInBytes());
+  }
+
+  bool DocOutputSink::WriteSaver(StringParam path, TextSaver& saver)
+  {
+    String text = saver.GetString();
+    saver.Close();
+
+    return WriteText(path, text);
+  }
+
+  void DocOutputSink::PrintReport(void)
+  {
+    unsigned long long writtenBytes = mWrittenBytes;
+    unsigned long long skippedBytes = mSkippedBytes;
+
+    printf("output files: %u written (%llu bytes), %u unchanged and skipped (%llu bytes)\n",
+      (uint)mWrittenFiles, writtenBytes, (uint)mSkippedFiles, skippedBytes);
+    WriteLog("output files: %u written (%llu bytes), %u unchanged and skipped (%llu bytes)\n",
+      (uint)mWrittenFiles, writtenBytes, (uint)mSkippedFiles, skippedBytes);
+  }
+
+  DocOutputSink* DocOutputSink::Get(void)
+  {
+    static DocOutputSink sink;
+
+    return &sink;
+  }
+
+  bool DocOutputSink::MatchesExistingFile(StringParam path, const byte* data, uint size)
+  {
+    // the size is free to check, only read the file when it could be the same
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes))
+      return false;
+
+    if (attributes.nFileSizeHigh != 0 || attributes.nFileSizeLow != size)
+      return false;
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+      FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+    Array<byte> existing;
+    existing.Resize(size);
+
+    DWORD read = 0;
+    bool readAll = size == 0 || (ReadFile(file, existing.Data(), size, &read, nullptr) && read == size);
+
+    CloseHandle(file);
+
+    if (!readAll)
+      return false;
+
+    return size == 0 || std::memcmp(existing.Data(), data, size) == 0;
+  }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+
+namespace Zero
+{
+  /// Every generated file goes through here. A file is only rewritten when its contents
+  /// changed (size is checked first, then the bytes are compared), so untouched outputs keep their
+  /// modification time. Safe to call from several threads at once.
+  class DocOutputSink
+  {
+  public:
+    DocOutputSink();
+
+    /// writes data to path unless the file already holds the same bytes.
+    /// Returns false only if the file needed writing and that failed.
+    bool Write(StringParam path, const byte* data, uint size);
+
+    /// same as Write for text
+    bool WriteText(StringParam path, StringRange text);
+
+    /// closes a TextSaver that was opened with OpenBuffer and writes everything it saved
+    bool WriteSaver(StringParam path, TextSaver& saver);
+
+    /// prints and logs how many files and bytes were written or skipped so far
+    void PrintReport(void);
+
+    /// gets a pointer to the shared sink
+    static DocOutputSink* Get(void);
+
+  private:
+    /// returns true if the file at path holds exactly size bytes equal to data
+    bool MatchesExistingFile(StringParam path, const byte* data, uint size);
+
+    std::atomic<uint> mWrittenFiles;
+    std::atomic<uint> mSkippedFiles;
+    std::atomic<unsigned long long> mWrittenBytes;
+    std::atomic<unsigned long long> mSkippedBytes;
+  };
+}
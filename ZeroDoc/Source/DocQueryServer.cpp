@@ -0,0 +1,574 @@
+#include "Precompiled.hpp"
+
+#include "Platform/FileSystem.hpp"
+#include "DocQueryServer.hpp"
+#include "DocConfiguration.hpp"
+#include "RawDocumentation.hpp"
+#include "TrimDocBinary.hpp"
+
+#include <Engine/Documentation.hpp>
+
+#pragma comment(lib, "ws2_32.lib")
+
+namespace Zero
+{
+  // how many names prefix and fuzzy requests return at most
+  static const uint cMaxSearchResults = 20;
+
+  static bool EntryKeyLess(const DocQueryEntry& lhs, const DocQueryEntry& rhs)
+  {
+    return strcmp(lhs.mKey.c_str(), rhs.mKey.c_str()) < 0;
+  }
+
+  static const char* GetKindName(DocQueryKind::Enum kind)
+  {
+    switch (kind)
+    {
+      case DocQueryKind::Class: return "class";
+      case DocQueryKind::Method: return "method";
+      case DocQueryKind::Property: return "property";
+      case DocQueryKind::Event: return "event";
+      case DocQueryKind::Enum: return "enum";
+      case DocQueryKind::Flags: return "flags";
+    }
+    return "";
+  }
+
+  /// appends text as a quoted json string
+  static void AppendJsonString(StringBuilder& builder, StringRange text)
+  {
+    builder.Append('"');
+
+    forRange(Rune rune, text)
+    {
+      switch (rune.value)
+      {
+        case '"': builder.Append("\\\""); break;
+        case '\\': builder.Append("\\\\"); break;
+        case '\n': builder.Append("\\n"); break;
+        case '\r': builder.Append("\\r"); break;
+        case '\t': builder.Append("\\t"); break;
+        default:
+        {
+          // anything else below a space has to be escaped by code
+          if (rune.value < 0x20)
+          {
+            char escaped[8];
+            sprintf_s(escaped, "\\u%04x", (uint)rune.value);
+            builder.Append(escaped);
+          }
+          else
+          {
+            builder.Append(rune);
+          }
+        }
+      }
+    }
+
+    builder.Append('"');
+  }
+
+  static void AppendJsonField(StringBuilder& builder, cstr name, StringRange value)
+  {
+    builder.Append(",\"");
+    builder.Append(name);
+    builder.Append("\":");
+    AppendJsonString(builder, value);
+  }
+
+  static void AppendJsonField(StringBuilder& builder, cstr name, bool value)
+  {
+    builder.Append(",\"");
+    builder.Append(name);
+    builder.Append(value ? "\":true" : "\":false");
+  }
+
+  /// appends the names of every doc in docs as a json array field
+  template <typename DocType>
+  static void AppendJsonNames(StringBuilder& builder, cstr name, Array<DocType*>& docs)
+  {
+    builder.Append(",\"");
+    builder.Append(name);
+    builder.Append("\":[");
+
+    for (uint i = 0; i < docs.Size(); ++i)
+    {
+      if (i != 0)
+        builder.Append(',');
+      AppendJsonString(builder, docs[i]->mName);
+    }
+
+    builder.Append(']');
+  }
+
+  /// appends everything documented about the entry as a json object
+  static void AppendJsonEntry(StringBuilder& builder, const DocQueryEntry& entry)
+  {
+    builder.Append("{\"kind\":");
+    AppendJsonString(builder, GetKindName(entry.mKind));
+    AppendJsonField(builder, "name", entry.mName);
+
+    ClassDoc* classDoc = entry.mClass;
+
+    switch (entry.mKind)
+    {
+      case DocQueryKind::Class:
+      {
+        AppendJsonField(builder, "base", classDoc->mBaseClass);
+        AppendJsonField(builder, "library", classDoc->mLibrary);
+        AppendJsonField(builder, "description", classDoc->mDescription);
+        AppendJsonNames(builder, "properties", classDoc->mProperties);
+        AppendJsonNames(builder, "methods", classDoc->mMethods);
+        AppendJsonNames(builder, "events", classDoc->mEventsSent);
+        break;
+      }
+
+      case DocQueryKind::Method:
+      {
+        MethodDoc* methodDoc = classDoc->mMethods[entry.mMemberIndex];
+        AppendJsonField(builder, "returnType", methodDoc->mReturnType);
+        AppendJsonField(builder, "parameters", methodDoc->mParameters);
+        AppendJsonField(builder, "static", methodDoc->mStatic);
+        AppendJsonField(builder, "description", methodDoc->mDescription);
+        break;
+      }
+
+      case DocQueryKind::Property:
+      {
+        PropertyDoc* propDoc = classDoc->mProperties[entry.mMemberIndex];
+        AppendJsonField(builder, "type", propDoc->mType);
+        AppendJsonField(builder, "readOnly", propDoc->mReadOnly);
+        AppendJsonField(builder, "static", propDoc->mStatic);
+        AppendJsonField(builder, "description", propDoc->mDescription);
+        break;
+      }
+
+      case DocQueryKind::Event:
+      {
+        EventDoc* eventDoc = classDoc->mEventsSent[entry.mMemberIndex];
+        AppendJsonField(builder, "type", eventDoc->mType);
+        break;
+      }
+
+      case DocQueryKind::Enum:
+      case DocQueryKind::Flags:
+      {
+        EnumDoc* enumDoc = entry.mEnum;
+        AppendJsonField(builder, "description", enumDoc->mDescription);
+
+        builder.Append(",\"values\":{");
+        bool first = true;
+        forRange(auto& valuePair, enumDoc->mEnumValues.All())
+        {
+          if (!first)
+            builder.Append(',');
+          first = false;
+
+          AppendJsonString(builder, valuePair.first);
+          builder.Append(':');
+          AppendJsonString(builder, valuePair.second);
+        }
+        builder.Append('}');
+        break;
+      }
+    }
+
+    builder.Append('}');
+  }
+
+  /// appends the kind and name of every entry, what searches answer with
+  static void AppendJsonSummaries(StringBuilder& builder, Array<const DocQueryEntry*>& entries)
+  {
+    builder.Append("{\"results\":[");
+
+    for (uint i = 0; i < entries.Size(); ++i)
+    {
+      if (i != 0)
+        builder.Append(',');
+
+      builder.Append("{\"kind\":");
+      AppendJsonString(builder, GetKindName(entries[i]->mKind));
+      AppendJsonField(builder, "name", entries[i]->mName);
+      builder.Append('}');
+    }
+
+    builder.Append("]}");
+  }
+
+  static String MakeJsonError(StringParam message)
+  {
+    StringBuilder builder;
+    builder.Append("{\"error\":");
+    AppendJsonString(builder, message);
+    builder.Append('}');
+    return builder.ToString();
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // DocQueryIndex
+  ////////////////////////////////////////////////////////////////////////
+  void DocQueryIndex::Build(DocumentationLibrary& library)
+  {
+    mEntries.Clear();
+
+    forRange(ClassDoc* classDoc, library.mClasses.All())
+    {
+      AddEntry(classDoc->mName, DocQueryKind::Class, classDoc, 0, nullptr);
+
+      for (uint i = 0; i < classDoc->mMethods.Size(); ++i)
+      {
+        AddEntry(BuildString(classDoc->mName, ".", classDoc->mMethods[i]->mName),
+          DocQueryKind::Method, classDoc, i, nullptr);
+      }
+      for (uint i = 0; i < classDoc->mProperties.Size(); ++i)
+      {
+        AddEntry(BuildString(classDoc->mName, ".", classDoc->mProperties[i]->mName),
+          DocQueryKind::Property, classDoc, i, nullptr);
+      }
+      for (uint i = 0; i < classDoc->mEventsSent.Size(); ++i)
+      {
+        AddEntry(BuildString(classDoc->mName, ".", classDoc->mEventsSent[i]->mName),
+          DocQueryKind::Event, classDoc, i, nullptr);
+      }
+    }
+
+    forRange(EnumDoc* enumDoc, library.mEnums.All())
+    {
+      AddEntry(enumDoc->mName, DocQueryKind::Enum, nullptr, 0, enumDoc);
+    }
+    forRange(EnumDoc* flagsDoc, library.mFlags.All())
+    {
+      AddEntry(flagsDoc->mName, DocQueryKind::Flags, nullptr, 0, flagsDoc);
+    }
+
+    // stable so overloads keep the order they were documented in
+    std::stable_sort(mEntries.Data(), mEntries.Data() + mEntries.Size(), EntryKeyLess);
+  }
+
+  void DocQueryIndex::AddEntry(StringParam name, DocQueryKind::Enum kind, ClassDoc* classDoc,
+    uint memberIndex, EnumDoc* enumDoc)
+  {
+    DocQueryEntry& entry = mEntries.PushBack();
+    entry.mKey = name.ToLower();
+    entry.mName = name;
+    entry.mKind = kind;
+    entry.mClass = classDoc;
+    entry.mMemberIndex = memberIndex;
+    entry.mEnum = enumDoc;
+  }
+
+  uint DocQueryIndex::LowerBound(StringParam key) const
+  {
+    uint first = 0;
+    uint count = mEntries.Size();
+
+    while (count > 0)
+    {
+      uint step = count / 2;
+      uint middle = first + step;
+
+      if (strcmp(mEntries[middle].mKey.c_str(), key.c_str()) < 0)
+      {
+        first = middle + 1;
+        count -= step + 1;
+      }
+      else
+      {
+        count = step;
+      }
+    }
+
+    return first;
+  }
+
+  void DocQueryIndex::FindExact(StringParam name, Array<const DocQueryEntry*>& results) const
+  {
+    String key = name.ToLower();
+
+    for (uint i = LowerBound(key); i < mEntries.Size() && mEntries[i].mKey == key; ++i)
+      results.PushBack(&mEntries[i]);
+  }
+
+  void DocQueryIndex::FindPrefix(StringParam prefix, uint maxResults,
+    Array<const DocQueryEntry*>& results) const
+  {
+    String key = prefix.ToLower();
+
+    for (uint i = LowerBound(key); i < mEntries.Size() && results.Size() < maxResults; ++i)
+    {
+      if (!mEntries[i].mKey.StartsWith(key))
+        break;
+
+      results.PushBack(&mEntries[i]);
+    }
+  }
+
+  void DocQueryIndex::FindFuzzy(StringParam pattern, uint maxResults,
+    Array<const DocQueryEntry*>& results) const
+  {
+    String lowerPattern = pattern.ToLower();
+    const char* patternText = lowerPattern.c_str();
+    uint patternLength = lowerPattern.SizeInBytes();
+
+    if (patternLength == 0)
+      return;
+
+    // (score, entry) of every match, lower scores are tighter matches
+    Array<std::pair<uint, uint> > matches;
+
+    for (uint i = 0; i < mEntries.Size(); ++i)
+    {
+      const char* key = mEntries[i].mKey.c_str();
+
+      uint matched = 0;
+      uint first = 0;
+      uint last = 0;
+
+      for (uint k = 0; key[k] != '\0' && matched < patternLength; ++k)
+      {
+        if (key[k] != patternText[matched])
+          continue;
+
+        if (matched == 0)
+          first = k;
+        last = k;
+        ++matched;
+      }
+
+      if (matched != patternLength)
+        continue;
+
+      // letters spread further apart and matches starting later rank lower,
+      // shorter names win ties
+      uint score = (last - first) * 4 + first * 2 + mEntries[i].mKey.SizeInBytes();
+      matches.PushBack(std::make_pair(score, i));
+    }
+
+    uint count = Math::Min(maxResults, (uint)matches.Size());
+    std::partial_sort(matches.Data(), matches.Data() + count, matches.Data() + matches.Size());
+
+    for (uint i = 0; i < count; ++i)
+      results.PushBack(&mEntries[matches[i].second]);
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // DocQueryServer
+  ////////////////////////////////////////////////////////////////////////
+  DocQueryServer::DocQueryServer(DocumentationLibrary& library)
+    : LoopbackServer("query server")
+  {
+    mIndex.Build(library);
+  }
+
+  bool DocQueryServer::HandleReceived(LoopbackConnection& connection)
+  {
+    // answer every full line, a partial one waits for the rest
+    size_t lineStart = 0;
+    size_t lineEnd;
+
+    while ((lineEnd = connection.mPending.find('\n', lineStart)) != std::string::npos)
+    {
+      size_t length = lineEnd - lineStart;
+
+      if (length > 0 && connection.mPending[lineEnd - 1] == '\r')
+        --length;
+
+      String request(connection.mPending.c_str() + lineStart, length);
+      String response = BuildString(HandleRequest(request), "\n");
+
+      if (!SendAll(connection.mSocket, response.c_str(), response.SizeInBytes()))
+        return false;
+
+      lineStart = lineEnd + 1;
+    }
+
+    connection.mPending.erase(0, lineStart);
+
+    return true;
+  }
+
+  String DocQueryServer::HandleRequest(StringRange request)
+  {
+    StringRange line = request.Trim();
+    StringRange space = line.FindFirstOf(' ');
+
+    if (space.Empty())
+      return MakeJsonError("requests look like 'get <name>', 'prefix <text>' or 'fuzzy <text>'");
+
+    String command = line.SubString(line.Begin(), space.Begin());
+    String argument = StringRange(space.End(), line.End()).Trim();
+
+    Array<const DocQueryEntry*> results;
+    StringBuilder builder;
+
+    if (command == "get")
+    {
+      mIndex.FindExact(argument, results);
+
+      if (results.Empty())
+        return MakeJsonError(BuildString("nothing is documented as ", argument));
+
+      builder.Append("{\"results\":[");
+      for (uint i = 0; i < results.Size(); ++i)
+      {
+        if (i != 0)
+          builder.Append(',');
+        AppendJsonEntry(builder, *results[i]);
+      }
+      builder.Append("]}");
+    }
+    else if (command == "prefix")
+    {
+      mIndex.FindPrefix(argument, cMaxSearchResults, results);
+      AppendJsonSummaries(builder, results);
+    }
+    else if (command == "fuzzy")
+    {
+      mIndex.FindFuzzy(argument, cMaxSearchResults, results);
+      AppendJsonSummaries(builder, results);
+    }
+    else
+    {
+      return MakeJsonError(BuildString("unknown command: ", command));
+    }
+
+    return builder.ToString();
+  }
+
+  bool RunDocQueryServer(DocGeneratorConfig& config)
+  {
+    // the binary copy maps and loads much faster than the text file
+    BinaryTrimDocReader reader;
+    DocumentationLibrary textLibrary;
+    DocumentationLibrary* library = nullptr;
+
+    if (FileExists(config.mTrimmedBinaryOutput.c_str()) && reader.Open(config.mTrimmedBinaryOutput))
+    {
+      library = &reader.LoadAll();
+    }
+    else if (LoadDocumentationSkeleton(textLibrary, config.mTrimmedOutput))
+    {
+      textLibrary.FinalizeDocumentation();
+      library = &textLibrary;
+    }
+    else
+    {
+      printf("query server needs trimmedOutput or trimmedBinaryOutput to point at trimmed documentation\n");
+      return false;
+    }
+
+    DocQueryServer server(*library);
+
+    if (!server.Start((uint)config.mQueryServerPort))
+    {
+      printf("unable to start the query server on port %d\n", config.mQueryServerPort);
+      return false;
+    }
+
+    printf("serving %u documented names on 127.0.0.1:%u\n", server.mIndex.mEntries.Size(), server.GetPort());
+
+    server.Run();
+
+    return true;
+  }
+
+  bool RunDocQueryLoadTest(uint port, const Array<String>& requests, uint count)
+  {
+    if (requests.Empty())
+      return false;
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+      return false;
+
+    SOCKET client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((u_short)port);
+
+    if (client == INVALID_SOCKET || connect(client, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR)
+    {
+      printf("unable to connect to the query server on port %u\n", port);
+      if (client != INVALID_SOCKET)
+        closesocket(client);
+      WSACleanup();
+      return false;
+    }
+
+    BOOL noDelay = TRUE;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+    Array<double> latencies;
+    latencies.Reserve(count);
+
+    std::string pending;
+    char buffer[16384];
+    bool answeredAll = true;
+
+    for (uint i = 0; i < count && answeredAll; ++i)
+    {
+      String request = BuildString(requests[i % requests.Size()], "\n");
+
+      double start = GetDocTimeMs();
+
+      if (send(client, request.c_str(), (int)request.SizeInBytes(), 0) == SOCKET_ERROR)
+      {
+        answeredAll = false;
+        break;
+      }
+
+      // one response line comes back per request
+      size_t lineEnd;
+      while ((lineEnd = pending.find('\n')) == std::string::npos)
+      {
+        int received = recv(client, buffer, sizeof(buffer), 0);
+
+        if (received <= 0)
+        {
+          answeredAll = false;
+          break;
+        }
+
+        pending.append(buffer, received);
+      }
+
+      if (!answeredAll)
+        break;
+
+      latencies.PushBack(GetDocTimeMs() - start);
+      pending.erase(0, lineEnd + 1);
+    }
+
+    closesocket(client);
+    WSACleanup();
+
+    if (latencies.Empty())
+    {
+      printf("the query server did not answer\n");
+      return false;
+    }
+
+    std::sort(latencies.Data(), latencies.Data() + latencies.Size());
+
+    uint size = latencies.Size();
+    double total = 0.0;
+    forRange(double latency, latencies.All())
+    {
+      total += latency;
+    }
+
+    printf("query load test: %u requests over %u distinct queries\n", size, requests.Size());
+    printf("  mean:  %10.4f ms\n", total / size);
+    printf("  p50:   %10.4f ms\n", latencies[size / 2]);
+    printf("  p99:   %10.4f ms\n", latencies[Math::Min(size - 1, (size * 99) / 100)]);
+    printf("  max:   %10.4f ms\n", latencies[size - 1]);
+
+    if (!answeredAll)
+      printf("  stopped after %u of %u requests, the server closed the connection\n", size, count);
+
+    return answeredAll;
+  }
+}
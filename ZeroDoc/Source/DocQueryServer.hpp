@@ -0,0 +1,85 @@
+#pragma once
+
+#include "LoopbackServer.hpp"
+
+namespace Zero
+{
+  struct DocGeneratorConfig;
+  class DocumentationLibrary;
+  class ClassDoc;
+  class EnumDoc;
+
+  DeclareEnum6(DocQueryKind, Class, Method, Property, Event, Enum, Flags);
+
+  /// one searchable name in a DocQueryIndex
+  struct DocQueryEntry
+  {
+    /// lower case "class" or "class.member", what every lookup compares against
+    String mKey;
+    /// the name as it is documented, "Class.Member" for members
+    String mName;
+
+    DocQueryKind::Enum mKind;
+
+    /// class the entry is in, null for enums and flags
+    ClassDoc* mClass;
+    /// index of the member in the array of the class its kind refers to
+    uint mMemberIndex;
+    /// set for enums and flags
+    EnumDoc* mEnum;
+  };
+
+  /// Every class, member, enum and flags name of a finalized library in one array sorted by
+  /// lower case name. Exact and prefix lookups binary search it, fuzzy lookups scan it once.
+  class DocQueryIndex
+  {
+  public:
+    /// indexes library, which has to outlive the index
+    void Build(DocumentationLibrary& library);
+
+    /// appends every entry named name ignoring case, methods can have several overloads
+    void FindExact(StringParam name, Array<const DocQueryEntry*>& results) const;
+
+    /// appends up to maxResults entries starting with prefix ignoring case, in name order
+    void FindPrefix(StringParam prefix, uint maxResults, Array<const DocQueryEntry*>& results) const;
+
+    /// appends up to maxResults entries containing the letters of pattern in order ignoring
+    /// case, tightest matches first
+    void FindFuzzy(StringParam pattern, uint maxResults, Array<const DocQueryEntry*>& results) const;
+
+    Array<DocQueryEntry> mEntries;
+
+  private:
+    /// index of the first entry whose key is not less than key
+    uint LowerBound(StringParam key) const;
+
+    void AddEntry(StringParam name, DocQueryKind::Enum kind, ClassDoc* classDoc,
+      uint memberIndex, EnumDoc* enumDoc);
+  };
+
+  /// Answers documentation lookups over TCP on 127.0.0.1. Every request is one line,
+  /// "get <name>", "prefix <text>" or "fuzzy <text>", and every response is one line of JSON.
+  /// Requests are small enough that one thread serves every connection.
+  class DocQueryServer : public LoopbackServer
+  {
+  public:
+    DocQueryServer(DocumentationLibrary& library);
+
+    /// builds the response line for one request line
+    String HandleRequest(StringRange request);
+
+    DocQueryIndex mIndex;
+
+  protected:
+    /// answers every full line the connection sent, a partial one waits for the rest
+    virtual bool HandleReceived(LoopbackConnection& connection) override;
+  };
+
+  /// loads the trimmed documentation named in config and serves it on queryServerPort
+  /// until the process is closed. Returns false if it could not start.
+  bool RunDocQueryServer(DocGeneratorConfig& config);
+
+  /// Sends count requests, cycling through requests, to the server on port one at a time
+  /// and prints the p50, p99 and max round trip. Returns false if a request went unanswered.
+  bool RunDocQueryLoadTest(uint port, const Array<String>& requests, uint count);
+}
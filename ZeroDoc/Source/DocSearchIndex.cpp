@@ -0,0 +1,456 @@
+#include "Precompiled.hpp"
+
+#include "DocSearchIndex.hpp"
+#include "Engine/Documentation.hpp"
+#include "SectionedFile.hpp"
+#include "DocTaskPool.hpp"
+
+namespace Zero
+{
+  // 'ZDSI' as it reads in a hex editor
+  static const uint cSearchIndexMagic = 0x4953445A;
+  static const uint cSearchIndexVersion = 1;
+
+  /// sections of the file in the order they are written, the byte sections go last so
+  /// every record section stays 4 byte aligned
+  namespace SearchIndexSection
+  {
+    enum Enum
+    {
+      Documents,
+      Terms,
+      Postings,
+      Strings,
+      Count
+    };
+  }
+
+  struct SearchIndexDocumentRecord
+  {
+    uint mName;
+    uint mKind;
+  };
+
+  struct SearchIndexTermRecord
+  {
+    uint mText;
+    // byte offset into the postings section
+    uint mPostings;
+    uint mDocumentCount;
+  };
+
+  // size of one record in each section, postings and strings count bytes
+  static const uint cSearchIndexRecordSizes[SearchIndexSection::Count] =
+  {
+    sizeof(SearchIndexDocumentRecord),
+    sizeof(SearchIndexTermRecord),
+    sizeof(byte),
+    sizeof(char)
+  };
+
+  static const SectionedFileFormat cSearchIndexFormat =
+  {
+    "search index",
+    cSearchIndexMagic,
+    cSearchIndexVersion,
+    SearchIndexSection::Count,
+    cSearchIndexRecordSizes,
+    SearchIndexSection::Strings
+  };
+
+  static bool IsSearchLetter(char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+  }
+
+  static bool IsUpperLetter(char c)
+  {
+    return c >= 'A' && c <= 'Z';
+  }
+
+  static bool TermLess(const String& lhs, const String& rhs)
+  {
+    return strcmp(lhs.c_str(), rhs.c_str()) < 0;
+  }
+
+  static void AddTerm(const char* begin, const char* end, Array<String>& terms)
+  {
+    // single letters match nearly everything, they are not worth a posting list
+    if (end - begin < 2)
+      return;
+
+    String term(begin, end - begin);
+    terms.PushBack(term.ToLower());
+  }
+
+  void TokenizeSearchText(StringParam text, bool isName, Array<String>& terms)
+  {
+    const char* data = text.c_str();
+    const char* end = data + text.SizeInBytes();
+
+    while (data < end)
+    {
+      if (!IsSearchLetter(*data))
+      {
+        ++data;
+        continue;
+      }
+
+      const char* wordBegin = data;
+      while (data < end && IsSearchLetter(*data))
+        ++data;
+
+      AddTerm(wordBegin, data, terms);
+
+      if (!isName)
+        continue;
+
+      // a hump starts at an upper case letter after a lower case one, or at the last upper
+      // case letter of a run followed by a lower case one ("XMLFile" is "XML" and "File")
+      const char* partBegin = wordBegin;
+      for (const char* c = wordBegin + 1; c < data; ++c)
+      {
+        bool hump = IsUpperLetter(*c)
+          && (!IsUpperLetter(c[-1]) || (c + 1 < data && !IsUpperLetter(c[1]) && IsSearchLetter(c[1])));
+
+        if (!hump)
+          continue;
+
+        AddTerm(partBegin, c, terms);
+        partBegin = c;
+      }
+
+      // the whole word is already in there if it never split
+      if (partBegin != wordBegin)
+        AddTerm(partBegin, data, terms);
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // Writing
+  ////////////////////////////////////////////////////////////////////////
+
+  /// one document before it is merged into the index
+  struct SearchDocument
+  {
+    String mName;
+    DocQueryKind::Enum mKind;
+    // sorted and unique
+    Array<String> mTerms;
+  };
+
+  static void AddSearchDocument(Array<SearchDocument>& documents, StringParam name,
+    StringParam termName, StringParam description, DocQueryKind::Enum kind)
+  {
+    SearchDocument& document = documents.PushBack();
+    document.mName = name;
+    document.mKind = kind;
+
+    TokenizeSearchText(termName, true, document.mTerms);
+    TokenizeSearchText(description, false, document.mTerms);
+
+    std::sort(document.mTerms.Data(), document.mTerms.Data() + document.mTerms.Size(), TermLess);
+    String* uniqueEnd = std::unique(document.mTerms.Data(), document.mTerms.Data() + document.mTerms.Size());
+    document.mTerms.Resize(uniqueEnd - document.mTerms.Data());
+  }
+
+  static void AppendVarint(Array<byte>& output, uint value)
+  {
+    while (value >= 0x80)
+    {
+      output.PushBack((byte)(value | 0x80));
+      value >>= 7;
+    }
+    output.PushBack((byte)value);
+  }
+
+  static uint AddSearchString(Array<char>& strings, StringParam text)
+  {
+    uint offset = strings.Size();
+    strings.Resize(offset + text.SizeInBytes() + 1);
+    memcpy(&strings[offset], text.c_str(), text.SizeInBytes() + 1);
+    return offset;
+  }
+
+  bool SaveSearchIndexFile(DocumentationLibrary& library, StringParam absPath)
+  {
+    // every class only tokenizes its own docs, so all of them run at once
+    Array<Array<SearchDocument> > classDocuments;
+    classDocuments.Resize(library.mClasses.Size());
+
+    DocTaskPool::Get()->ParallelFor(library.mClasses.Size(), [&](uint i)
+    {
+      ClassDoc* classDoc = library.mClasses[i];
+      Array<SearchDocument>& documents = classDocuments[i];
+
+      AddSearchDocument(documents, classDoc->mName, classDoc->mName,
+        classDoc->mDescription, DocQueryKind::Class);
+
+      forRange(MethodDoc* methodDoc, classDoc->mMethods.All())
+      {
+        AddSearchDocument(documents, BuildString(classDoc->mName, ".", methodDoc->mName),
+          methodDoc->mName, methodDoc->mDescription, DocQueryKind::Method);
+      }
+      forRange(PropertyDoc* propDoc, classDoc->mProperties.All())
+      {
+        AddSearchDocument(documents, BuildString(classDoc->mName, ".", propDoc->mName),
+          propDoc->mName, propDoc->mDescription, DocQueryKind::Property);
+      }
+      forRange(EventDoc* eventDoc, classDoc->mEventsSent.All())
+      {
+        AddSearchDocument(documents, BuildString(classDoc->mName, ".", eventDoc->mName),
+          eventDoc->mName, String(), DocQueryKind::Event);
+      }
+    });
+
+    Array<SearchDocument> enumDocuments;
+    forRange(EnumDoc* enumDoc, library.mEnums.All())
+    {
+      AddSearchDocument(enumDocuments, enumDoc->mName, enumDoc->mName, enumDoc->mDescription, DocQueryKind::Enum);
+    }
+    forRange(EnumDoc* flagsDoc, library.mFlags.All())
+    {
+      AddSearchDocument(enumDocuments, flagsDoc->mName, flagsDoc->mName, flagsDoc->mDescription, DocQueryKind::Flags);
+    }
+    classDocuments.PushBack(enumDocuments);
+
+    // ids go out in class order, so every posting list is built already sorted
+    Array<char> strings;
+    strings.PushBack('\0');
+
+    Array<SearchIndexDocumentRecord> documentRecords;
+    HashMap<String, Array<uint> > postings;
+
+    forRange(Array<SearchDocument>& documents, classDocuments.All())
+    {
+      forRange(SearchDocument& document, documents.All())
+      {
+        uint id = documentRecords.Size();
+
+        SearchIndexDocumentRecord& record = documentRecords.PushBack();
+        record.mName = AddSearchString(strings, document.mName);
+        record.mKind = (uint)document.mKind;
+
+        forRange(String& term, document.mTerms.All())
+        {
+          postings[term].PushBack(id);
+        }
+      }
+    }
+
+    Array<String> terms;
+    terms.Reserve(postings.Size());
+    forRange(auto& entry, postings.All())
+    {
+      terms.PushBack(entry.first);
+    }
+    std::sort(terms.Data(), terms.Data() + terms.Size(), TermLess);
+
+    Array<SearchIndexTermRecord> termRecords;
+    Array<byte> encodedPostings;
+
+    forRange(String& term, terms.All())
+    {
+      Array<uint>& ids = postings[term];
+
+      SearchIndexTermRecord& record = termRecords.PushBack();
+      record.mText = AddSearchString(strings, term);
+      record.mPostings = encodedPostings.Size();
+      record.mDocumentCount = ids.Size();
+
+      uint previous = 0;
+      forRange(uint id, ids.All())
+      {
+        AppendVarint(encodedPostings, id - previous);
+        previous = id;
+      }
+    }
+
+    SectionedFileWriter writer(cSearchIndexFormat);
+    writer.AddSection(SearchIndexSection::Documents, documentRecords);
+    writer.AddSection(SearchIndexSection::Terms, termRecords);
+    writer.AddSection(SearchIndexSection::Postings, encodedPostings);
+    writer.AddSection(SearchIndexSection::Strings, strings);
+
+    return writer.Save(absPath);
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // SearchIndexReader
+  ////////////////////////////////////////////////////////////////////////
+  SearchIndexReader::SearchIndexReader()
+  {
+  }
+
+  SearchIndexReader::~SearchIndexReader()
+  {
+    Close();
+  }
+
+  bool SearchIndexReader::Open(StringParam absPath)
+  {
+    return mFile.Open(absPath, cSearchIndexFormat);
+  }
+
+  void SearchIndexReader::Close(void)
+  {
+    mFile.Close();
+  }
+
+  uint SearchIndexReader::GetDocumentCount(void) const
+  {
+    if (!IsOpen())
+      return 0;
+
+    return mFile.GetSection(SearchIndexSection::Documents).mCount;
+  }
+
+  const char* SearchIndexReader::GetDocumentName(uint document) const
+  {
+    if (document >= GetDocumentCount())
+      return "";
+
+    return mFile.GetString(mFile.GetRecords<SearchIndexDocumentRecord>(SearchIndexSection::Documents)[document].mName);
+  }
+
+  DocQueryKind::Enum SearchIndexReader::GetDocumentKind(uint document) const
+  {
+    if (document >= GetDocumentCount())
+      return DocQueryKind::Class;
+
+    uint kind = mFile.GetRecords<SearchIndexDocumentRecord>(SearchIndexSection::Documents)[document].mKind;
+    return kind < DocQueryKind::Size ? (DocQueryKind::Enum)kind : DocQueryKind::Class;
+  }
+
+  uint SearchIndexReader::GetTermCount(void) const
+  {
+    if (!IsOpen())
+      return 0;
+
+    return mFile.GetSection(SearchIndexSection::Terms).mCount;
+  }
+
+  uint SearchIndexReader::FindTerm(StringParam term) const
+  {
+    const SearchIndexTermRecord* records = mFile.GetRecords<SearchIndexTermRecord>(SearchIndexSection::Terms);
+
+    uint first = 0;
+    uint count = GetTermCount();
+
+    while (count > 0)
+    {
+      uint step = count / 2;
+      uint middle = first + step;
+
+      if (strcmp(mFile.GetString(records[middle].mText), term.c_str()) < 0)
+      {
+        first = middle + 1;
+        count -= step + 1;
+      }
+      else
+      {
+        count = step;
+      }
+    }
+
+    if (first < GetTermCount() && strcmp(mFile.GetString(records[first].mText), term.c_str()) == 0)
+      return first;
+
+    return (uint)-1;
+  }
+
+  void SearchIndexReader::GetPostings(uint termIndex, Array<uint>& documents) const
+  {
+    if (termIndex >= GetTermCount())
+      return;
+
+    const SearchIndexTermRecord& record = mFile.GetRecords<SearchIndexTermRecord>(SearchIndexSection::Terms)[termIndex];
+    const SectionRange& section = mFile.GetSection(SearchIndexSection::Postings);
+    const byte* postings = mFile.GetRecords<byte>(SearchIndexSection::Postings);
+
+    // a corrupt list just ends where the section does
+    const byte* data = postings + Math::Min(record.mPostings, section.mCount);
+    const byte* end = postings + section.mCount;
+
+    uint id = 0;
+    for (uint i = 0; i < record.mDocumentCount && data < end; ++i)
+    {
+      uint delta = 0;
+      uint shift = 0;
+
+      while (data < end && shift < 32)
+      {
+        byte value = *data++;
+        delta |= (uint)(value & 0x7F) << shift;
+        shift += 7;
+
+        if ((value & 0x80) == 0)
+          break;
+      }
+
+      id += delta;
+      documents.PushBack(id);
+    }
+  }
+
+  void SearchIndexReader::Search(StringParam query, Array<uint>& documents) const
+  {
+    Array<String> terms;
+    TokenizeSearchText(query, false, terms);
+
+    if (terms.Empty() || !IsOpen())
+      return;
+
+    // start from the rarest term so every intersection only gets smaller
+    Array<std::pair<uint, uint> > termsByCount;
+    const SearchIndexTermRecord* records = mFile.GetRecords<SearchIndexTermRecord>(SearchIndexSection::Terms);
+
+    forRange(String& term, terms.All())
+    {
+      uint termIndex = FindTerm(term);
+
+      // a term nothing contains means nothing contains all of them
+      if (termIndex == (uint)-1)
+        return;
+
+      termsByCount.PushBack(std::make_pair(records[termIndex].mDocumentCount, termIndex));
+    }
+    std::sort(termsByCount.Data(), termsByCount.Data() + termsByCount.Size());
+
+    Array<uint> matches;
+    GetPostings(termsByCount[0].second, matches);
+
+    Array<uint> postings;
+    Array<uint> intersection;
+
+    for (uint i = 1; i < termsByCount.Size() && !matches.Empty(); ++i)
+    {
+      postings.Clear();
+      intersection.Clear();
+      GetPostings(termsByCount[i].second, postings);
+
+      uint m = 0;
+      uint p = 0;
+      while (m < matches.Size() && p < postings.Size())
+      {
+        if (matches[m] < postings[p])
+          ++m;
+        else if (postings[p] < matches[m])
+          ++p;
+        else
+        {
+          intersection.PushBack(matches[m]);
+          ++m;
+          ++p;
+        }
+      }
+
+      matches = intersection;
+    }
+
+    forRange(uint id, matches.All())
+    {
+      documents.PushBack(id);
+    }
+  }
+}
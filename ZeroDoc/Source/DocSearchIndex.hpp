@@ -0,0 +1,55 @@
+#pragma once
+
+#include "DocQueryServer.hpp"
+#include "SectionedFile.hpp"
+
+namespace Zero
+{
+  class DocumentationLibrary;
+
+  /// splits text into lower case terms of at least two letters, names are also split at their
+  /// camel case humps so "GetWorldTranslation" is found by "world" as well
+  void TokenizeSearchText(StringParam text, bool isName, Array<String>& terms);
+
+  /// Saves the full text search index of library. Every class, member, enum and flags type is
+  /// a document and the terms of its name and description point at it through a dictionary
+  /// sorted by term and delta encoded postings. Classes are tokenized in parallel.
+  bool SaveSearchIndexFile(DocumentationLibrary& library, StringParam absPath);
+
+  /// Maps a search index file and answers queries straight out of it
+  class SearchIndexReader
+  {
+  public:
+    SearchIndexReader();
+    ~SearchIndexReader();
+
+    /// maps the file and validates the header
+    bool Open(StringParam absPath);
+
+    void Close(void);
+
+    bool IsOpen(void) const { return mFile.IsOpen(); }
+
+    uint GetDocumentCount(void) const;
+
+    /// "Class" or "Class.Member", enums and flags by their name
+    const char* GetDocumentName(uint document) const;
+
+    DocQueryKind::Enum GetDocumentKind(uint document) const;
+
+    uint GetTermCount(void) const;
+
+    /// binary searches the dictionary for term, returns -1 if no document contains it
+    uint FindTerm(StringParam term) const;
+
+    /// appends the id of every document containing the term at termIndex, in id order
+    void GetPostings(uint termIndex, Array<uint>& documents) const;
+
+    /// tokenizes query the way document text was and appends every document containing all
+    /// of its terms, in id order
+    void Search(StringParam query, Array<uint>& documents) const;
+
+  private:
+    SectionedFileReader mFile;
+  };
+}
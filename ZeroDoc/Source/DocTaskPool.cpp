@@ -0,0 +1,205 @@
+#include "Precompiled.hpp"
+
+#include "DocTaskPool.hpp"
+
+namespace Zero
+{
+  // set while a thread is executing a task so nested loops do not dead lock the pool
+  static thread_local bool sInsideTask = false;
+
+  uint DocTaskPool::sRequestedThreadCount = 0;
+
+  ////////////////////////////////////////////////////////////////////////
+  // DocTaskPool
+  ////////////////////////////////////////////////////////////////////////
+  DocTaskPool::DocTaskPool(uint threadCount)
+    : mJob(nullptr)
+    , mJobGeneration(0)
+    , mActiveWorkers(0)
+    , mRemainingRanges(0)
+    , mShutdown(false)
+  {
+    if (threadCount == 0)
+      threadCount = Math::Max(std::thread::hardware_concurrency(), 1u);
+
+    // the calling thread always gets queue 0, workers get the rest
+    for (uint i = 0; i < threadCount; ++i)
+      mQueues.PushBack(new WorkQueue());
+
+    for (uint i = 1; i < threadCount; ++i)
+      mThreads.PushBack(new std::thread(&DocTaskPool::WorkerMain, this, i));
+  }
+
+  DocTaskPool::~DocTaskPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mJobLock);
+      mShutdown = true;
+    }
+    mJobStart.notify_all();
+
+    forRange(std::thread* thread, mThreads.All())
+    {
+      thread->join();
+      delete thread;
+    }
+
+    forRange(WorkQueue* queue, mQueues.All())
+    {
+      delete queue;
+    }
+  }
+
+  void DocTaskPool::ParallelFor(uint count, const DocTaskFn& task, uint grainSize)
+  {
+    if (count == 0)
+      return;
+
+    if (grainSize == 0)
+      grainSize = 1;
+
+    // nothing to gain from dispatching, just run it here
+    if (mThreads.Empty() || sInsideTask || count <= grainSize)
+    {
+      for (uint i = 0; i < count; ++i)
+        task(i);
+      return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(mDispatchLock);
+
+    uint rangeCount = (count + grainSize - 1) / grainSize;
+    uint generation;
+
+    // the job is published before any of its ranges, so a worker can only ever pop ranges
+    // of the job it copied
+    {
+      std::lock_guard<std::mutex> lock(mJobLock);
+      mJob = &task;
+      generation = ++mJobGeneration;
+      mRemainingRanges = rangeCount;
+
+      // deal the ranges out round robin so every worker starts with local work
+      for (uint i = 0; i < rangeCount; ++i)
+      {
+        TaskRange range;
+        range.mBegin = i * grainSize;
+        range.mEnd = Math::Min(range.mBegin + grainSize, count);
+        range.mGeneration = generation;
+
+        WorkQueue* queue = mQueues[i % mQueues.Size()];
+        std::lock_guard<std::mutex> queueLock(queue->mLock);
+        queue->mRanges.push_back(range);
+      }
+    }
+    mJobStart.notify_all();
+
+    RunTasks(0, task, generation);
+
+    // wait for the last range to finish and for every worker to let go of the job
+    std::unique_lock<std::mutex> lock(mJobLock);
+    mJobDone.wait(lock, [this]() { return mRemainingRanges == 0 && mActiveWorkers == 0; });
+    mJob = nullptr;
+  }
+
+  uint DocTaskPool::GetThreadCount(void)
+  {
+    return mQueues.Size();
+  }
+
+  void DocTaskPool::Initialize(uint threadCount)
+  {
+    sRequestedThreadCount = threadCount;
+  }
+
+  DocTaskPool* DocTaskPool::Get(void)
+  {
+    static DocTaskPool pool(sRequestedThreadCount);
+
+    return &pool;
+  }
+
+  bool DocTaskPool::PopLocal(uint queueIndex, uint generation, TaskRange& range)
+  {
+    WorkQueue* queue = mQueues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue->mLock);
+
+    if (queue->mRanges.empty() || queue->mRanges.back().mGeneration != generation)
+      return false;
+
+    range = queue->mRanges.back();
+    queue->mRanges.pop_back();
+    return true;
+  }
+
+  bool DocTaskPool::Steal(uint queueIndex, uint generation, TaskRange& range)
+  {
+    uint queueCount = mQueues.Size();
+
+    for (uint i = 1; i < queueCount; ++i)
+    {
+      WorkQueue* victim = mQueues[(queueIndex + i) % queueCount];
+      std::lock_guard<std::mutex> lock(victim->mLock);
+
+      if (victim->mRanges.empty() || victim->mRanges.front().mGeneration != generation)
+        continue;
+
+      range = victim->mRanges.front();
+      victim->mRanges.pop_front();
+      return true;
+    }
+
+    return false;
+  }
+
+  void DocTaskPool::RunTasks(uint queueIndex, const DocTaskFn& task, uint generation)
+  {
+    sInsideTask = true;
+
+    TaskRange range;
+    while (PopLocal(queueIndex, generation, range) || Steal(queueIndex, generation, range))
+    {
+      for (uint i = range.mBegin; i < range.mEnd; ++i)
+        task(i);
+
+      if (mRemainingRanges.fetch_sub(1) == 1)
+      {
+        std::lock_guard<std::mutex> lock(mJobLock);
+        mJobDone.notify_all();
+      }
+    }
+
+    sInsideTask = false;
+  }
+
+  void DocTaskPool::WorkerMain(uint queueIndex)
+  {
+    uint seenGeneration = 0;
+
+    std::unique_lock<std::mutex> lock(mJobLock);
+    for (;;)
+    {
+      mJobStart.wait(lock, [&]() { return mShutdown || mJobGeneration != seenGeneration; });
+
+      if (mShutdown)
+        return;
+
+      seenGeneration = mJobGeneration;
+
+      // woke up after the loop already finished, nothing left to help with
+      if (mJob == nullptr)
+        continue;
+
+      // copied under the lock, the loop can not finish while we are counted as active
+      const DocTaskFn* job = mJob;
+      ++mActiveWorkers;
+
+      lock.unlock();
+      RunTasks(queueIndex, *job, seenGeneration);
+      lock.lock();
+
+      if (--mActiveWorkers == 0)
+        mJobDone.notify_all();
+    }
+  }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <deque>
+
+namespace Zero
+{
+  /// callback run by the task pool for every index in a parallel loop
+  typedef std::function<void(uint)> DocTaskFn;
+
+  /// Small work-stealing pool used to run independent per-class passes in parallel.
+  /// Each worker owns a queue of index ranges, pops from the back of its own queue and
+  /// steals from the front of everyone else's when it runs dry.
+  class DocTaskPool
+  {
+  public:
+    /// threadCount of 0 means use every hardware thread available
+    explicit DocTaskPool(uint threadCount = 0);
+
+    ~DocTaskPool();
+
+    /// runs task(i) for every i in [0, count) and blocks until all of them finished.
+    /// grainSize is how many indices are handed out at once. Calls made from inside a
+    /// running task are executed serially on the calling thread.
+    void ParallelFor(uint count, const DocTaskFn& task, uint grainSize = 1);
+
+    /// number of threads that execute tasks, including the thread calling ParallelFor
+    uint GetThreadCount(void);
+
+    /// sets the thread count the shared pool will be created with, has to be called before Get
+    static void Initialize(uint threadCount);
+
+    /// gets a pointer to the shared task pool
+    static DocTaskPool* Get(void);
+
+  private:
+    struct TaskRange
+    {
+      uint mBegin;
+      uint mEnd;
+      // the parallel loop the range belongs to
+      uint mGeneration;
+    };
+
+    struct WorkQueue
+    {
+      std::mutex mLock;
+      std::deque<TaskRange> mRanges;
+    };
+
+    /// pops a range of generation from the back of our own queue
+    bool PopLocal(uint queueIndex, uint generation, TaskRange& range);
+    /// pops a range of generation from the front of any other queue
+    bool Steal(uint queueIndex, uint generation, TaskRange& range);
+    /// runs task on ranges of generation until none are left
+    void RunTasks(uint queueIndex, const DocTaskFn& task, uint generation);
+    /// entry point of each worker thread
+    void WorkerMain(uint queueIndex);
+
+    Array<std::thread*> mThreads;
+    // one queue per worker plus one for the calling thread (index 0)
+    Array<WorkQueue*> mQueues;
+
+    // only one parallel loop may be dispatched at a time
+    std::mutex mDispatchLock;
+
+    std::mutex mJobLock;
+    std::condition_variable mJobStart;
+    std::condition_variable mJobDone;
+
+    // the running loop and its generation, only changed under mJobLock
+    const DocTaskFn* mJob;
+    uint mJobGeneration;
+    uint mActiveWorkers;
+    std::atomic<uint> mRemainingRanges;
+    bool mShutdown;
+
+    static uint sRequestedThreadCount;
+  };
+}
@@ -8,31 +8,86 @@ namespace Zero
 ////////////////////
 //The Macro Toolbox (tm)
 ////////////////////
-#define Make_Node(NodeType) UniquePointer<NodeType> node = new NodeType;
+#define Make_Node(NodeType) NodeType* node = mArena.New<NodeType>();
 
 #define Get_Statements while (node->mStatements.PushBack(this->Statement()));
 
-#define Accept_Rule node.Release()
+#define Accept_Rule node
+
+// bails out of the current rule once anything it called has failed
+#define Return_If_Failed if (Failed()) return nullptr;
 
 ////////////////////
 //Call to get parsed block
 ////////////////////
-UniquePointer<BlockNode> ParseBlock(TypeTokens* tokens)
+BlockNode* ParseBlock(TypeTokens* tokens, MacroExpandContext* context, DocParseArena& arena)
+{
+  DocTypeParser parser(*tokens, arena, 0, context);
+
+  BlockNode* retVal = parser.Block();
+
+  if (parser.Failed())
+  {
+    // expansions run on the task pool, the error is reported once the tasks joined
+    if (context)
+      context->mParseErrors.PushBack(parser.GetErrorMessage());
+    else
+      Zero::DoNotifyError("Parsing error", parser.GetErrorMessage().c_str());
+
+    return nullptr;
+  }
+
+  return retVal;
+}
+
+////////////////////////////////////////////////////////////////////////
+// DocParseArena
+////////////////////////////////////////////////////////////////////////
+void DocParseArena::Release(void)
+{
+  // destroy in reverse so nodes go away in the opposite order they were made
+  for (uint i = mDestructors.Size(); i > 0; --i)
+  {
+    DestructorEntry& entry = mDestructors[i - 1];
+    entry.mDestroy(entry.mObject);
+  }
+  mDestructors.Clear();
+
+  forRange(byte* block, mBlocks.All())
+  {
+    delete[] block;
+  }
+  mBlocks.Clear();
+
+  mCurrentBlock = nullptr;
+  mBlockUsed = cBlockSize;
+}
+
+void* DocParseArena::Allocate(size_t size)
 {
-  DocTypeParser parser(*tokens);
+  // keep every node aligned for anything it could contain
+  const size_t alignment = 16;
+  size = (size + alignment - 1) & ~(alignment - 1);
 
-  UniquePointer<BlockNode> retVal;
-  try
+  // anything bigger than a block just gets a block of its own
+  if (size > cBlockSize)
   {
-    retVal = parser.Block();
+    byte* bigBlock = new byte[size];
+    mBlocks.PushBack(bigBlock);
+    return bigBlock;
   }
-  catch (ParsingException &e)
+
+  if (mBlockUsed + size > cBlockSize)
   {
-    // for now do nothing  but break
-    Zero::DoNotifyError("Parsing error", e.what());
+    mCurrentBlock = new byte[cBlockSize];
+    mBlocks.PushBack(mCurrentBlock);
+    mBlockUsed = 0;
   }
 
-  return retVal.Release();
+  byte* memory = mCurrentBlock + mBlockUsed;
+  mBlockUsed += size;
+
+  return memory;
 }
 
 
@@ -82,115 +137,111 @@ bool DocTypeParser::accept(DocTokenType::Enum type, DocToken*& token)
 }
 
 ////
-//Bool expects
+//Expects
 ////
-bool DocTypeParser::expect(DocTokenType::Enum type)
+bool DocTypeParser::fail(DocParseError::Enum error)
 {
-  if (accept(type))
+  // only the first error is kept, everything after it is fallout
+  if (!Failed())
   {
-    return true;
+    mError = error;
+    mErrorIndex = mIndex;
   }
 
-  throw ParsingException();
+  return false;
 }
 
-
-bool DocTypeParser::expect(DocTokenType::Enum type, String errorMsg)
+bool DocTypeParser::expect(DocTokenType::Enum type, DocParseError::Enum error)
 {
   if (accept(type))
   {
     return true;
   }
 
-  throw ParsingException(errorMsg);
-}
-
-bool DocTypeParser::expect(bool expected)
-{
-  if (expected)
-    return true;
-
-  throw ParsingException();
+  return fail(error);
 }
 
-bool DocTypeParser::expect(bool expected, String errorMsg)
+bool DocTypeParser::expect(bool expected, DocParseError::Enum error)
 {
   if (expected)
   {
     return true;
   }
 
-  throw ParsingException(errorMsg);
+  return fail(error);
 }
 
-////
-//Token out expects
-////
-void DocTypeParser::expect(DocTokenType::Enum type, DocToken*& output)
+bool DocTypeParser::expect(DocTokenType::Enum type, DocParseError::Enum error, DocToken*& output)
 {
   if (accept(type, output))
   {
-    return;
+    return true;
   }
 
-  throw ParsingException();
+  return fail(error);
 }
 
-void DocTypeParser::expect(DocTokenType::Enum type, String errorMsg, DocToken*& output)
+String DocTypeParser::GetErrorMessage(void) const
 {
-  if (accept(type, output))
+  const char* message = "Unknown parsing error";
+
+  switch (mError)
   {
-    return;
+  case DocParseError::MissingCallOpenParen:
+    message = "Expected OpenParentheses for call";
+    break;
+  case DocParseError::MissingParameterListOpenParen:
+    message = "Expected OpenParentheses for parameter specification";
+    break;
+  case DocParseError::TrailingComma:
+    message = "Expected parameter after comma, did you leave a trailing comma?";
+    break;
+  case DocParseError::MissingCloseParen:
+    message = "Expected CloseParentheses after parameter list";
+    break;
+  case DocParseError::MissingParameterName:
+    message = "Expected identifier for parameter";
+    break;
+  case DocParseError::InvalidConstQualifier:
+    message = "Invalid Const Qualifier Found";
+    break;
+  default:
+    break;
   }
 
-  throw ParsingException(errorMsg);
-}
-
-////
-//Template type expects
-////
-template < typename T >
-T DocTypeParser::expect(T expectedValue)
-{
-  if (expectedValue)
-    return expectedValue;
-
-  throw ParsingException();
-}
-
-template < typename T >
-T DocTypeParser::expect(T expectedValue, String errorMsg)
-{
-  if (expectedValue)
-    return expectedValue;
+  if (mErrorIndex < mTokens.Size())
+    return String::Format("%s (at '%s')", message, mTokens[mErrorIndex].mText.c_str());
 
-  throw ParsingException(errorMsg);
+  return String::Format("%s (at end of tokens)", message);
 }
 
-
 ////////////////////////////////////////////////////////////////////////
 // DocTypeParser (rules)
 ////////////////////////////////////////////////////////////////////////
 
 //--------------------------------------------------------------------------------Block
 // Block = (Function|BlockNode|CallNode)*
-UniquePointer<BlockNode> DocTypeParser::Block(void)
+BlockNode* DocTypeParser::Block(void)
 {
   Make_Node(BlockNode);
 
   for (;;)
   {
-    UniquePointer<AbstractNode> newNode = Function();
+    AbstractNode* newNode = Function();
+
+    Return_If_Failed;
 
     if (!newNode)
     {
       newNode = Call();
+
+      Return_If_Failed;
     }
 
 
     if (newNode != nullptr)
     {
-      node->mGlobals.PushBack(newNode.Release());
+      node->mGlobals.PushBack(newNode);
       continue;
     }
     break;
@@ -200,12 +251,12 @@ UniquePointer<BlockNode> DocTypeParser::Block(void)
 }
 
 // check for macro expansion, create a new code block if one is found
-void BlockNode::AddToClassDoc(RawClassDoc* doc)
+void BlockNode::AddToClassDoc(RawClassDoc* doc, MacroExpandContext* context)
 {
 
   forRange(AbstractNode *node, mGlobals.All())
   {
-    node->AddToClassDoc(doc);
+    node->AddToClassDoc(doc, context);
   }
 
 }
@@ -219,7 +270,7 @@ CallNode* DocTypeParser::Call(void)
 
   accept(DocTokenType::Comment, comment);
 
-  DocToken *name;
+  DocToken *name = nullptr;
 
   accept(DocTokenType::Identifier, name);
 
@@ -234,7 +285,8 @@ CallNode* DocTypeParser::Call(void)
   node->mName = name;
 
 
-  expect(DocTokenType::OpenParen, "Expected OpenParentheses for call");
+  if (!expect(DocTokenType::OpenParen, DocParseError::MissingCallOpenParen))
+    return nullptr;
 
   DocToken *arg;
 
@@ -246,13 +298,15 @@ CallNode* DocTypeParser::Call(void)
     while (accept(DocTokenType::Comma))
     {
       arg = nullptr;
-      expect(accept(DocTokenType::Identifier, arg) || accept(DocTokenType::StringLiteral, arg)
-        , "Expected parameter after comma, did you leave a trailing comma?");
+      if (!expect(accept(DocTokenType::Identifier, arg) || accept(DocTokenType::StringLiteral, arg)
+        , DocParseError::TrailingComma))
+        return nullptr;
       node->mArguments.PushBack(arg);
     }
   }
 
-  expect(DocTokenType::CloseParen, "Expected CloseParentheses after parameter list");
+  if (!expect(DocTokenType::CloseParen, DocParseError::MissingCloseParen))
+    return nullptr;
 
   // just eat the semicolon because macros are gonna macro sometimes
   accept(DocTokenType::Semicolon);
@@ -261,7 +315,7 @@ CallNode* DocTypeParser::Call(void)
 }
 
 // check for macro expansion, create a new code block if one is found
-void CallNode::AddToClassDoc(RawClassDoc* doc)
+void CallNode::AddToClassDoc(RawClassDoc* doc, MacroExpandContext* context)
 {
   if (mComment.Empty())
     return;
@@ -281,6 +335,7 @@ void CallNode::AddToClassDoc(RawClassDoc* doc)
   MacroCall call;
 
   call.mClass = doc;
+  call.mContext = context;
 
   // parse any options in the comment really quick
   call.ParseOptions(commentTokens);
@@ -294,8 +349,6 @@ void CallNode::AddToClassDoc(RawClassDoc* doc)
     call.mMacroArgs.PushBack(token->mText);
   }
 
-  MacroDatabase* database = MacroDatabase::GetInstance();
-
   // just return out if we do not load the macro
   if (!call.LoadMacroWithName(mName->mText))
     return;
@@ -303,16 +356,19 @@ void CallNode::AddToClassDoc(RawClassDoc* doc)
   // expand our new call
   call.ExpandCall();
 
-  UniquePointer<BlockNode> parsedMacro = ParseBlock(&call.mExpandedMacro);
+  // everything parsed out of this expansion is freed in one go once it has been added
+  DocParseArena arena;
+
+  BlockNode* parsedMacro = ParseBlock(&call.mExpandedMacro, context, arena);
 
   // Will recurse again if more macros are present
   if (parsedMacro)
-    parsedMacro->AddToClassDoc(doc);
+    parsedMacro->AddToClassDoc(doc, context);
 
-  MacroDatabase::GetInstance()->mMacroExpandStack.PopBack();
+  context->mExpandStack.PopBack();
 }
 
-void ExpandCommentVariables(String* comment)
+void ExpandCommentVariables(String* comment, MacroExpandContext* context)
 {
   // if we have no comment just return 
   if (!comment)
@@ -343,7 +399,10 @@ void ExpandCommentVariables(String* comment)
       commentToken = &commentTokens[i];
 
       // check if this token is actually a comment variable/option
-      String value = MacroDatabase::GetInstance()->SearchMacroExpandStackForOption(commentToken->mText);
+      String value;
+
+      if (context)
+        value = context->SearchExpandStackForOption(commentToken->mText);
 
       // make sure we actually found the option
       if (value != "")
@@ -376,7 +435,7 @@ FunctionNode* DocTypeParser::Function(void)
 
   accept(DocTokenType::Comment, comment);
 
-  UniquePointer<TypeNode> retType = Type();
+  TypeNode* retType = Type();
 
   if (!retType)
     return nullptr;
@@ -386,7 +445,7 @@ FunctionNode* DocTypeParser::Function(void)
   if (comment)
     node->mComment = comment->mText;
 
-  node->mReturnType = retType.Release();
+  node->mReturnType = retType;
 
   // we are going to reset the index to before
   if (!accept(DocTokenType::Identifier, node->mName))
@@ -395,24 +454,33 @@ FunctionNode* DocTypeParser::Function(void)
     return nullptr;
   }
 
-  ExpandCommentVariables(&(node->mComment));
+  ExpandCommentVariables(&(node->mComment), mContext);
+
+  if (!expect(DocTokenType::OpenParen, DocParseError::MissingParameterListOpenParen))
+    return nullptr;
+
+  ParameterNode* param = Parameter();
 
-  expect(DocTokenType::OpenParen, "Expected OpenParentheses for parameter specification");
+  Return_If_Failed;
 
-  UniquePointer<ParameterNode> param = Parameter();
   if (param)
   {
-    node->mParameters.PushBack(param.Release());
+    node->mParameters.PushBack(param);
 
     while (accept(DocTokenType::Comma))
     {
       param = Parameter();
-      expect(param != nullptr, "Expected parameter after comma, did you leave a trailing comma?");
-      node->mParameters.PushBack(param.Release());
+
+      Return_If_Failed;
+
+      if (!expect(param != nullptr, DocParseError::TrailingComma))
+        return nullptr;
+      node->mParameters.PushBack(param);
     }
   }
 
-  expect(DocTokenType::CloseParen, "Expected CloseParentheses after parameter list");
+  if (!expect(DocTokenType::CloseParen, DocParseError::MissingCloseParen))
+    return nullptr;
 
   // eat any trailing identifiers, they would have been thrown away anyway
   while (accept(DocTokenType::Identifier) || accept(DocTokenType::ConstQualifier)) {}
@@ -423,7 +491,7 @@ FunctionNode* DocTypeParser::Function(void)
   return Accept_Rule;
 }
 
-void FunctionNode::AddToClassDoc(RawClassDoc *doc)
+void FunctionNode::AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context)
 {
   RawMethodDoc* newMethod = new RawMethodDoc();
 
@@ -431,14 +499,14 @@ void FunctionNode::AddToClassDoc(RawClassDoc *doc)
 
   newMethod->mName = mName->mText;
 
-  CopyArrayOfTokenPtrToTypeTokens(mReturnType->mTokens, newMethod->mReturnTokens);
+  CopyTokenRangeToTypeTokens(mReturnType->mFirstToken, mReturnType->mTokenCount, newMethod->mReturnTokens);
 
   // since param needs to save to the method doc we will implement it here
   forRange(ParameterNode *param, mParameters.All())
   {
     RawMethodDoc::Parameter *newParam = new RawMethodDoc::Parameter;
 
-    CopyArrayOfTokenPtrToTypeTokens(param->mType->mTokens, newParam->mTokens);
+    CopyTokenRangeToTypeTokens(param->mType->mFirstToken, param->mType->mTokenCount, newParam->mTokens);
 
     newParam->mName = param->mName->mText;
 
@@ -447,31 +515,30 @@ void FunctionNode::AddToClassDoc(RawClassDoc *doc)
 
   newMethod->NormalizeAllTypes(RawTypedefLibrary::Get(), doc->mNamespace);
 
-  // if we find a match, fill that instead of adding a duplicate function
-  doc->FillMatchingMethod(newMethod);
-
-  delete newMethod;
+  // the context fills the matching method (instead of adding a duplicate) once it is merged
+  context->AddMethod(newMethod);
 }
 
 //--------------------------------------------------------------------------------Parameter
 // Parameter = Type <Identifier>
-UniquePointer<ParameterNode> DocTypeParser::Parameter(void)
+ParameterNode* DocTypeParser::Parameter(void)
 {
-  UniquePointer<TypeNode> type = Type();
+  TypeNode* type = Type();
 
   if (!type)
     return nullptr;
 
   Make_Node(ParameterNode);
 
-  expect(DocTokenType::Identifier, "Expected identifier for parameter", node->mName);
+  if (!expect(DocTokenType::Identifier, DocParseError::MissingParameterName, node->mName))
+    return nullptr;
 
-  node->mType = type.Release();
+  node->mType = type;
 
   return Accept_Rule;
 }
 
-void ParameterNode::AddToClassDoc(RawClassDoc* doc)
+void ParameterNode::AddToClassDoc(RawClassDoc* doc, MacroExpandContext* context)
 {
   Error("ParameterNodes should never directly be added to doc, \
 ld be automatically added by FunctionNode instead");
@@ -479,9 +546,11 @@ ld be automatically added by FunctionNode instead");
 
 //--------------------------------------------------------------------------------TypeNode
 /// Type = NamedType | FunctionType
-UniquePointer<TypeNode> DocTypeParser::Type(void)
+TypeNode* DocTypeParser::Type(void)
 {
-  UniquePointer<TypeNode> node = NamedType();
+  TypeNode* node = NamedType();
+
+  Return_If_Failed;
 
   if (node == nullptr)
   {
@@ -491,7 +560,7 @@ UniquePointer<TypeNode> DocTypeParser::Type(void)
   return Accept_Rule;
 }
 
-void TypeNode::AddToClassDoc(RawClassDoc* doc)
+void TypeNode::AddToClassDoc(RawClassDoc* doc, MacroExpandContext* context)
 {
   Error("TypeNodes should never directly be added to doc");
 }
@@ -499,63 +568,43 @@ void TypeNode::AddToClassDoc(RawClassDoc* doc)
 //NamedType = Namespace*<Identifier> <Asterisk>* <Ampersand>?
 //For templates, could be changed to:
 //NamedType = Namespace*<Identifier> (<LessThen><NamedType><GreaterThen>)? <Asterisk>* <Ampersand>?
-UniquePointer<TypeNode> DocTypeParser::NamedType(void)
+TypeNode* DocTypeParser::NamedType(void)
 {
-  DocToken *currToken = nullptr;
-
   accept(DocTokenType::StaticQualifier);
 
-  Make_Node(TypeNode);
+  // everything that makes up the type is contiguous so it is saved as a range of tokens
+  unsigned startIndex = mIndex;
 
-  if (accept(DocTokenType::ConstQualifier, currToken))
-  {
-    node->mTokens.PushBack(currToken);
-  }
+  bool isConst = accept(DocTokenType::ConstQualifier);
 
-  if (!accept(DocTokenType::Identifier, currToken)
-    && !accept(DocTokenType::Void, currToken))
+  if (!accept(DocTokenType::Identifier)
+    && !accept(DocTokenType::Void))
   {
-    if (!node->mTokens.Empty())
-      throw ParsingException("Invalid Const Qualifier Found");
+    if (isConst)
+      fail(DocParseError::InvalidConstQualifier);
 
     return nullptr;
   }
 
+  while (accept(DocTokenType::Pointer)) {}
 
-  node->mTokens.PushBack(currToken);
+  accept(DocTokenType::Reference);
 
-  while (accept(DocTokenType::Pointer, currToken))
-  {
-    node->mTokens.PushBack(currToken);
-  }
+  Make_Node(TypeNode);
 
-  if (accept(DocTokenType::Reference, currToken))
-  {
-    node->mTokens.PushBack(currToken);
-  }
+  node->mFirstToken = &mTokens[startIndex];
+  node->mTokenCount = mIndex - startIndex;
 
   return Accept_Rule;
 }
 
 // FunctionType = Type <Asterisk>+ <Ampersand>? 
 //   <OpenParentheses> Type (<Comma> Type)* <CloseParentheses>
-UniquePointer<TypeNode> DocTypeParser::FunctionType(void)
+TypeNode* DocTypeParser::FunctionType(void)
 {
   // not supporting this for now, has not come up and seems annoying
   return nullptr;
 }
 
 
-////////////////////////////////////////////////////////////////////////
-// ParsingException
-////////////////////////////////////////////////////////////////////////
-ParsingException::ParsingException() : mError("ParsingException Occured") {}
-
-ParsingException::ParsingException(StringParam error) : mError(error) {}
-
-const char* ParsingException::what() const
-{
-  return mError.c_str();
-}
-
 }
\ No newline at end of file
@@ -18,19 +18,78 @@ namespace Zero
     class TypeNode;
     class StatementNode;
 
-    /// Parses block of code pointed to by tokens and returns the initial block for parsed code
-    UniquePointer<BlockNode> ParseBlock(TypeTokens* tokens);
+    class MacroExpandContext;
+
+    /// Everything that can make a parse fail, the message is only built if it gets reported
+    DeclareEnum7(DocParseError, None, MissingCallOpenParen, MissingParameterListOpenParen,
+      TrailingComma, MissingCloseParen, MissingParameterName, InvalidConstQualifier);
+
+    /// Owns every node created during one parse. Nodes are carved out of large blocks instead
+    /// of being allocated one at a time, and all of them are destroyed at once with the arena.
+    class DocParseArena
+    {
+    public:
+      DocParseArena() : mCurrentBlock(nullptr), mBlockUsed(cBlockSize) {}
+
+      ~DocParseArena() { Release(); }
+
+      /// default constructs a NodeType inside the arena
+      template <typename NodeType>
+      NodeType* New(void)
+      {
+        NodeType* node = new (Allocate(sizeof(NodeType))) NodeType();
+
+        DestructorEntry& entry = mDestructors.PushBack();
+        entry.mObject = node;
+        entry.mDestroy = &Destroy<NodeType>;
+
+        return node;
+      }
+
+      /// destroys every node and frees every block, anything from New is invalid afterwards
+      void Release(void);
+
+    private:
+      struct DestructorEntry
+      {
+        void* mObject;
+        void (*mDestroy)(void*);
+      };
+
+      template <typename NodeType>
+      static void Destroy(void* node) { static_cast<NodeType*>(node)->~NodeType(); }
+
+      void* Allocate(size_t size);
+
+      static const size_t cBlockSize = 4096;
+
+      // every block the arena owns, including ones made for oversized nodes
+      Array<byte*> mBlocks;
+      // the block small nodes are currently carved out of
+      byte* mCurrentBlock;
+      size_t mBlockUsed;
+
+      Array<DestructorEntry> mDestructors;
+    };
+
+    /// Parses block of code pointed to by tokens and returns the initial block for parsed code,
+    /// or null if the tokens failed to parse. The nodes live until arena is released.
+    /// Comment variables are looked up in the expand stack of context, and a parse error is
+    /// added to its mParseErrors instead of being reported right away.
+    BlockNode* ParseBlock(TypeTokens* tokens, MacroExpandContext* context, DocParseArena& arena);
 
     /// Replaces any MacroComment options used in comment if it exists in the macro expansion scope
     void DoCommentVariableReplacements(TypeTokens &comment);
 
-    /// contains the grammar for interpreting tokens into useful language constructs 
+    /// contains the grammar for interpreting tokens into useful language constructs
     class DocTypeParser
     {
     public:
-      /// Parser requires being constructed with a token list and optionally an index into tokens
-      explicit DocTypeParser(TypeTokens& tokens, int index = 0)
-        : mTokens(tokens), mIndex(index) {}
+      /// Parser requires being constructed with a token list, the arena nodes are created in,
+      /// and optionally an index into tokens
+      DocTypeParser(TypeTokens& tokens, DocParseArena& arena, int index = 0, MacroExpandContext* context = nullptr)
+        : mTokens(tokens), mArena(arena), mIndex(index), mContext(context)
+        , mError(DocParseError::None), mErrorIndex(0) {}
 
 
       ////////////////////
@@ -38,7 +97,7 @@ namespace Zero
       ////////////////////
 
       /// Creates and returns a block node if a block of code exists
-      UniquePointer<BlockNode> Block(void);
+      BlockNode* Block(void);
 
       /// Creates and returns a FunctionNode if a function call exists at index
       FunctionNode* Function(void);
@@ -47,16 +106,29 @@ namespace Zero
       CallNode* Call(void);
 
       /// Used by Function And Call to get any parameters that exists in Function or Macro call
-      UniquePointer<ParameterNode> Parameter(void);
+      ParameterNode* Parameter(void);
 
       /// Returns a TypeNode if a NamedType or a FunctionType node exists
-      UniquePointer<TypeNode> Type(void);
+      TypeNode* Type(void);
 
       /// Returns a TypeNode if we have an identifier that can have a namespace and pointer/ref
-      UniquePointer<TypeNode> NamedType(void);
+      TypeNode* NamedType(void);
 
       /// TODO: currently not implemented because no documented macros seem to have need yet
-      UniquePointer<TypeNode> FunctionType(void);
+      TypeNode* FunctionType(void);
+
+      ////////////////////
+      //Errors
+      ////////////////////
+
+      /// true once any rule failed, every rule returns null from then on
+      bool Failed(void) const { return mError != DocParseError::None; }
+
+      /// the first error that was hit
+      DocParseError::Enum GetError(void) const { return mError; }
+
+      /// builds the message for the first error, only call this when it is going to be reported
+      String GetErrorMessage(void) const;
 
     private:
       ////////////////////
@@ -68,31 +140,15 @@ namespace Zero
       /// Will iterate past a token of type 'type' and return true if it exists at token
       bool accept(DocTokenType::Enum type, DocToken*& token);
 
-      /// Will iterate past a token with expectedValue if it exists and throw if it does not
-      template <typename T>
-      T expect(T expectedValue);
-
-      /// Will iterate past token with expectedValue if it exists and throw errorMsg if it does not
-      template <typename T>
-      T expect(T expectedValue, String errorMsg);
-
-      // bool output
-
-      /// Will iterate past a token of type if it exists and throw if it does not
-      bool expect(DocTokenType::Enum type);
-      /// Will iterate past a token of type if it exists and throw errorMsg if it does not
-      bool expect(DocTokenType::Enum type, String errorMsg);
-      /// Will iterate past a token of type if it exists and throw if it does not
-      bool expect(bool expected);
-      /// Will iterate past a token of type if it exists and throw errorMsg if it does not
-      bool expect(bool expected, String errorMsg);
+      /// Will iterate past a token of type if it exists and record error if it does not
+      bool expect(DocTokenType::Enum type, DocParseError::Enum error);
+      /// Records error if expected is false
+      bool expect(bool expected, DocParseError::Enum error);
+      /// Same as the bool version except the accepted token is returned in 'output'
+      bool expect(DocTokenType::Enum type, DocParseError::Enum error, DocToken*& output);
 
-      // token name output
-
-      /// Same as bool return expect FNs except returns token in 'output'
-      void expect(DocTokenType::Enum type, DocToken*& output);
-      /// Same as bool return expect FNs except returns token in 'output'.
-      void expect(DocTokenType::Enum type, String errorMsg, DocToken*& output);
+      /// records error at the current token if nothing failed yet and returns false
+      bool fail(DocParseError::Enum error);
 
       ////////////////////
       //Data
@@ -100,7 +156,16 @@ namespace Zero
 
       TypeTokens& mTokens;
 
+      DocParseArena& mArena;
+
       unsigned mIndex;
+
+      // the macro expansion these tokens came from, can be null
+      MacroExpandContext* mContext;
+
+      DocParseError::Enum mError;
+      // where the error happened, kept so the message can be built later
+      unsigned mErrorIndex;
     };
 
     class AbstractNode
@@ -108,50 +173,55 @@ namespace Zero
     public:
       AbstractNode() {};
 
-      /// documentation that should never be written to classDoc should override this to throw
-      virtual void AddToClassDoc(RawClassDoc *doc) = 0;
+      virtual ~AbstractNode() {};
+
+      /// documentation that should never be written to classDoc should override this to throw.
+      /// Anything parsed out of a macro expansion is buffered in context until it is merged.
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) = 0;
     };
 
     class BlockNode : public AbstractNode
     {
     public:
       /// throws error since BlockNodes have no proper way to be added to class doc
-      virtual void AddToClassDoc(RawClassDoc *doc) override;
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) override;
 
-      Array<UniquePointer<AbstractNode> > mGlobals;
+      // owned by the arena the block was parsed into
+      Array<AbstractNode*> mGlobals;
     };
 
     class StatementNode : public AbstractNode
     {
     public:
       /// remains pure virtual because if you are calling add to class on this you are wrong
-      virtual void AddToClassDoc(RawClassDoc *doc) = 0;
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) = 0;
 
     };
 
     class TypeNode : public AbstractNode
     {
     public:
-      TypeNode() {};
+      TypeNode() : mFirstToken(nullptr), mTokenCount(0) {};
 
       /// remains pure virtual because if you are calling add to class on this you are wrong
-      virtual void AddToClassDoc(RawClassDoc *doc) override;
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) override;
 
-      // for ease of extracting info we are going to maintain a list of our tokens
-      Array<DocToken *> mTokens;
+      // a type is always a contiguous run of the parsed tokens
+      DocToken* mFirstToken;
+      uint mTokenCount;
     };
 
     class VariableNode : public StatementNode
     {
     public:
-      VariableNode() {};
+      VariableNode() : mName(nullptr), mType(nullptr), mSymbol(nullptr) {};
 
       /// remains pure virtual because if you are calling add to class on this you are wrong
-      virtual void AddToClassDoc(RawClassDoc *doc) = 0;
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) = 0;
 
       DocToken *mName;
 
-      UniquePointer<TypeNode> mType;
+      TypeNode* mType;
 
       // The variable node should create the following symbol
       Variable* mSymbol;
@@ -161,24 +231,24 @@ namespace Zero
     {
     public:
       /// Throws error becuase this should not be called but can be by mistake easily
-      virtual void AddToClassDoc(RawClassDoc *doc) override;
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) override;
 
     };
 
     class FunctionNode : public AbstractNode
     {
     public:
-      FunctionNode() {};
+      FunctionNode() : mName(nullptr), mReturnType(nullptr) {};
 
       /// Adds function call to ClassDoc by filling a "RawMethodDoc" class
-      virtual void AddToClassDoc(RawClassDoc *doc) override;
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) override;
 
       DocToken *mName;
 
-      Array<UniquePointer<ParameterNode> > mParameters;
+      Array<ParameterNode*> mParameters;
 
       // Can be null
-      UniquePointer<TypeNode> mReturnType;
+      TypeNode* mReturnType;
 
       String mComment;
     };
@@ -186,9 +256,10 @@ namespace Zero
     class CallNode : public StatementNode
     {
     public:
+      CallNode() : mName(nullptr) {};
 
       /// Will throw error because if this is called it means there is an unexpanded macro in block
-      virtual void AddToClassDoc(RawClassDoc *doc) override;
+      virtual void AddToClassDoc(RawClassDoc *doc, MacroExpandContext *context) override;
 
       Array<DocToken *> mArguments;
 
@@ -196,14 +267,4 @@ namespace Zero
 
       String mComment;
     };
-
-    // Throw this exception type when a parsing error occurrs
-    class ParsingException : public std::exception
-    {
-    public:
-      ParsingException();
-      ParsingException(StringParam error);
-      const char* what() const override;
-      String mError;
-    };
-}
\ No newline at end of file
+}
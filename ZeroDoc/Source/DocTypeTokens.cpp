@@ -66,12 +66,13 @@ namespace Zero
     return builder.ToString();
   }
 
-  void CopyArrayOfTokenPtrToTypeTokens(const Array<DocToken*>& in, TypeTokens*& out)
+  void CopyTokenRangeToTypeTokens(const DocToken* first, uint count, TypeTokens*& out)
   {
     out = new TypeTokens();
-    forRange(DocToken *tokenPtr, in.All())
+    out->Reserve(count);
+    for (uint i = 0; i < count; ++i)
     {
-      out->PushBack(*tokenPtr);
+      out->PushBack(first[i]);
     }
   }
 
@@ -114,6 +115,112 @@ namespace Zero
 
   }
 
+  ////////////////////////////////////////////////////////////
+  //////////TokenCache
+  ////////////////////////////////////////////////////////////
+  TokenCache::TokenCache()
+    : mHits(0)
+    , mMisses(0)
+    , mSkipped(0)
+  {
+  }
+
+  TokenCache::~TokenCache()
+  {
+    forRange(auto& entry, mEntries.All())
+    {
+      delete entry.second;
+    }
+  }
+
+  const TypeTokens* TokenCache::Find(StringParam str)
+  {
+    if (str.SizeInBytes() >= cMaxLength)
+    {
+      ++mSkipped;
+      return nullptr;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+
+      TypeTokens* tokens = mEntries.FindValue(str, nullptr);
+
+      if (tokens)
+      {
+        ++mHits;
+        return tokens;
+      }
+
+      if (mEntries.Size() >= cMaxEntries)
+      {
+        ++mSkipped;
+        return nullptr;
+      }
+    }
+
+    // short strings lex quickly, but there is no reason to hold the lock while they do
+    TypeTokens* tokens = new TypeTokens();
+    AppendTokensFromString(DocLangDfa::Get(), str, tokens);
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    // another thread may have lexed the same string meanwhile, the first one stays shared
+    TypeTokens* existing = mEntries.FindValue(str, nullptr);
+
+    if (existing)
+    {
+      delete tokens;
+      ++mHits;
+      return existing;
+    }
+
+    ++mMisses;
+    mEntries[str] = tokens;
+    return tokens;
+  }
+
+  void TokenCache::Append(StringParam str, TypeTokens* output)
+  {
+    const TypeTokens* tokens = Find(str);
+
+    if (tokens == nullptr)
+    {
+      AppendTokensFromString(DocLangDfa::Get(), str, output);
+      return;
+    }
+
+    if (output == nullptr)
+      return;
+
+    output->Reserve(output->Size() + tokens->Size());
+    forRange(const DocToken& token, tokens->All())
+    {
+      output->PushBack(token);
+    }
+  }
+
+  void TokenCache::PrintStats(void)
+  {
+    uint hits = mHits;
+    uint misses = mMisses;
+    uint skipped = mSkipped;
+    uint lookups = hits + misses + skipped;
+
+    if (lookups == 0)
+      return;
+
+    printf("token cache: %u lookups, %u hits (%.1f%%), %u lexed and cached, %u lexed uncached\n",
+      lookups, hits, 100.0 * hits / lookups, misses, skipped);
+  }
+
+  TokenCache* TokenCache::Get(void)
+  {
+    static TokenCache cache;
+
+    return &cache;
+  }
+
   void InitializeTokens(void)
   {
     DocTypeStringEnumMap = new Zero::UnsortedMap<Zero::String, DocTokenType::Enum>();
@@ -357,29 +464,45 @@ bool DocToken::operator==(const DocToken& right)
 //////////ParsingFunctions
 ////////////////////////////////////////////////////////////
 
-int checkForKeyword(const char*stream, int tokenLen)
+// keywords are told apart by their length, first and last character. The switch in
+// ClassifyKeyword is generated from DocTypeKeywords.inl, so adding a keyword that
+// collides with an existing one fails to compile as a duplicate case label.
+constexpr uint KeywordHash(const char* text, uint length)
 {
-  char token[50] = { '\0' };
-  int index = 0;
-  for (; stream[index] != '\0'; ++index)
+  return length == 0 ? 0 : (length << 16)
+    | ((uint)(unsigned char)text[0] << 8)
+    | (uint)(unsigned char)text[length - 1];
+}
+
+DocTokenType::Enum ClassifyKeyword(const char* text, uint length)
+{
+  DocTokenType::Enum keyword;
+
+  switch (KeywordHash(text, length))
   {
-    if (stream[index] == ' ')
-    {
-      break;
-    }
+#define TOKEN(Name, Value) case KeywordHash(Value, sizeof(Value) - 1): keyword = DocTokenType::Name; break;
+#include "DocTypeKeywords.inl"
+#undef TOKEN
+    default:
+      return DocTokenType::Identifier;
   }
 
-  strncpy(token, stream, tokenLen);
+  // the hash only looked at the length and two characters, confirm the rest of the text
+  if (std::memcmp(text, DocTokens[keyword], length) != 0)
+    return DocTokenType::Identifier;
 
-  index = 0;
-  for (const char *keyword : DocKeywords)
-  {
-    if (std::strcmp(keyword, token) == 0)
-      return DocTokenType::KeywordStart + 1 + index;
+  return keyword;
+}
 
-    ++index;
+void CheckForKeywordLinear(DocToken& outToken)
+{
+  for (uint i = 0; i < DocTokenType::EnumCount - DocTokenType::KeywordStart; ++i)
+  {
+    if (outToken.mText == DocKeywords[i])
+    {
+      outToken.mEnumTokenType = static_cast<DocTokenType::Enum>(DocTokenType::KeywordStart + 1 + i);
+    }
   }
-  return DocTokenType::Identifier;
 }
 
 DocDfaEdge *FindEdge(DocDfaState *state, char c)
@@ -392,13 +515,11 @@ DocDfaEdge *FindEdge(DocDfaState *state, char c)
 
 void CheckForKeyword(DocToken& outToken)
 {
-  for (uint i = 0; i < DocTokenType::EnumCount - DocTokenType::KeywordStart; ++i)
-  {
-    if (outToken.mText == DocKeywords[i])
-    {
-      outToken.mEnumTokenType = static_cast<DocTokenType::Enum>(DocTokenType::KeywordStart + 1 + i);
-    }
-  }
+  // keywords are always lexed as identifiers, nothing else can be one
+  if (outToken.mEnumTokenType != DocTokenType::Identifier)
+    return;
+
+  outToken.mEnumTokenType = ClassifyKeyword(outToken.mText.c_str(), outToken.mText.SizeInBytes());
 }
 
 
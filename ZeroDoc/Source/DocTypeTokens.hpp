@@ -2,6 +2,9 @@
 
 #include "Engine/EngineContainers.hpp"
 
+#include <atomic>
+#include <mutex>
+
 
 
 namespace DocTokenType
@@ -45,8 +48,8 @@ namespace Zero
   /// Builds a string from a list of tokens
   String ConvertTokenListToString(const TypeTokens& tokens);
 
-  /// allocates new typetokens array in out
-  void CopyArrayOfTokenPtrToTypeTokens(const Array<DocToken*>& in, TypeTokens*& out);
+  /// allocates new typetokens array in out holding a copy of the count tokens starting at first
+  void CopyTokenRangeToTypeTokens(const DocToken* first, uint count, TypeTokens*& out);
 
   /// Hacky function to fix bad formating or extra quotes left in a string token
   void CleanupStringToken(DocToken *String);
@@ -109,9 +112,52 @@ namespace Zero
   /// Creates Dfa starting from a root token
   DocDfaState* CreateLangDfa(void);
 
+  /// Returns the keyword text names with a single probe, or Identifier if it is not a keyword
+  DocTokenType::Enum ClassifyKeyword(const char* text, uint length);
+
+  /// Old linear scan over every keyword, only kept so the lexer benchmark can compare against it
+  void CheckForKeywordLinear(DocToken& outToken);
+
   /// Read token starting at startingState and using stream with Dfa to create outToken
   void ReadToken(DocDfaState* startingState, const char* stream, DocToken& outToken);
 
   /// Appends tokens from str to the end of the TypeTokens in output
   void AppendTokensFromString(DocDfaState* startingState, StringParam str, TypeTokens *output);
+
+  /// Remembers the tokens of the short strings that get tokenized over and over, type strings
+  /// like "const String&", compound and namespace names. Every string is lexed once and its
+  /// tokens are shared from then on, their text is never copied again. Only strings shorter
+  /// than cMaxLength are kept and the cache stops growing at cMaxEntries, so anything it hands
+  /// out stays valid until the process exits. Every string is lexed with the DocLang dfa.
+  class TokenCache
+  {
+  public:
+    static const uint cMaxLength = 96;
+    static const uint cMaxEntries = 32768;
+
+    TokenCache();
+    ~TokenCache();
+
+    /// the shared tokens of str, null if str is too long to be cached. Never modify them
+    const TypeTokens* Find(StringParam str);
+
+    /// same as AppendTokensFromString with the DocLang dfa, but served from the cache whenever possible
+    void Append(StringParam str, TypeTokens* output);
+
+    /// prints how many lookups were served without lexing
+    void PrintStats(void);
+
+    /// gets a pointer to the shared cache
+    static TokenCache* Get(void);
+
+    std::atomic<uint> mHits;
+    std::atomic<uint> mMisses;
+    /// lookups that were lexed without caching, too long or the cache was full
+    std::atomic<uint> mSkipped;
+
+  private:
+    std::mutex mLock;
+
+    HashMap<String, TypeTokens*> mEntries;
+  };
 }
\ No newline at end of file
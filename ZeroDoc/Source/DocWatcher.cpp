@@ -0,0 +1,580 @@
+#include "Precompiled.hpp"
+
+#include "Platform/FileSystem.hpp"
+#include "DocWatcher.hpp"
+#include "DocConfiguration.hpp"
+#include "RawDocumentation.hpp"
+#include "MacroDatabase.hpp"
+#include "FlattenedSource.hpp"
+#include "DoxygenIndex.hpp"
+#include "MarkupWriter.hpp"
+#include "TrimDocBinary.hpp"
+
+#include <Engine/Documentation.hpp>
+
+namespace Zero
+{
+  // doxygen rewrites its files one after another, a batch ends once it has been quiet this long
+  static const DWORD cQuietTimeMs = 500;
+
+  // watched paths and the paths the library stores are compared in this form
+  static String NormalizeWatchPath(StringParam path)
+  {
+    return FilePath::Normalize(path).ToLower();
+  }
+
+  // the doxygen listing of a file the library read. With scanSources the library keeps the
+  // paths of the original source files, only their listings are in the watched directory
+  static String GetListingPath(StringParam path, StringParam doxyPath)
+  {
+    if (path.EndsWith(".xml"))
+      return path;
+
+    String normalized = FilePath::Normalize(path);
+    String fileName = normalized.SubString(normalized.FindLastOf('\\').End(), normalized.End());
+
+    String listing = DoxygenIndex::Get()->FindSourceFile(fileName);
+
+    if (listing.Empty())
+      listing = GetFileWithExactName(doxyPath, GetDoxyfileNameFromSourceFileName(fileName));
+
+    return listing;
+  }
+
+  // adds the name of every identifier in tokens the way typedef lookups see it
+  static void AddUsedTypeNames(TypeTokens& tokens, HashSet<String>& usedNames)
+  {
+    forRange(DocToken& token, tokens.All())
+    {
+      if (token.mEnumTokenType != DocTokenType::Identifier)
+        continue;
+
+      // NormalizeTokensFromTypedefs trims the same suffix before looking the name up
+      StringRange paramRange = token.mText.FindLastOf("Param");
+
+      if (paramRange.Empty())
+        usedNames.Insert(token.mText);
+      else
+        usedNames.Insert(token.mText.SubString(token.mText.Begin(), paramRange.Begin()));
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // DocWatcher
+  ////////////////////////////////////////////////////////////////////////
+  DocWatcher::DocWatcher(DocGeneratorConfig& config, DocumentationLibrary& trimLib,
+    ReMarkupSources& markupSources)
+    : mConfig(config)
+    , mTrimLib(trimLib)
+    , mMarkupSources(markupSources)
+    , mLibrary(nullptr)
+    , mNamespacesChanged(false)
+    , mTypedefsChanged(false)
+    , mDirectory(INVALID_HANDLE_VALUE)
+    , mReadPending(false)
+    , mLostChanges(false)
+    , mFirstChangeTime(0)
+  {
+    memset(&mOverlapped, 0, sizeof(mOverlapped));
+
+    // 64k is the most ReadDirectoryChangesW can fill for a network share
+    mChangeBuffer.Resize(16384);
+  }
+
+  DocWatcher::~DocWatcher()
+  {
+    if (mDirectory != INVALID_HANDLE_VALUE)
+    {
+      if (mReadPending)
+      {
+        DWORD bytes = 0;
+        CancelIo(mDirectory);
+        GetOverlappedResult(mDirectory, &mOverlapped, &bytes, TRUE);
+      }
+
+      CloseHandle(mDirectory);
+    }
+
+    if (mOverlapped.hEvent)
+      CloseHandle(mOverlapped.hEvent);
+  }
+
+  void DocWatcher::RecordTypeUsage(RawDocumentationLibrary& library)
+  {
+    forRange(RawClassDoc* classDoc, library.mClasses.All())
+    {
+      RecordClassTypeUsage(classDoc);
+    }
+  }
+
+  void DocWatcher::Run(RawDocumentationLibrary& library)
+  {
+    mLibrary = &library;
+
+    mDirectory = CreateFileA(mConfig.mDoxygenPath.c_str(), FILE_LIST_DIRECTORY,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+    if (mDirectory == INVALID_HANDLE_VALUE)
+    {
+      Error("Unable to watch doxygen directory: %s", mConfig.mDoxygenPath.c_str());
+      return;
+    }
+
+    mOverlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+    printf("\nwatching %s for changes...\n\n", mConfig.mDoxygenPath.c_str());
+
+    for (;;)
+    {
+      HashSet<String> changedFiles;
+
+      if (!WaitForChanges(changedFiles))
+      {
+        Error("Stopped watching doxygen directory: %s", mConfig.mDoxygenPath.c_str());
+        return;
+      }
+
+      HashSet<String> affected;
+
+      CollectAffectedClasses(changedFiles, affected);
+      AddDerivedClasses(affected);
+
+      if (affected.Empty() && !mNamespacesChanged)
+        continue;
+
+      RegenerateClasses(affected);
+
+      // unsigned math keeps this right across the tick count wrapping
+      DWORD latency = GetTickCount() - mFirstChangeTime;
+
+      printf("watch: %u changed files, %u classes regenerated, %u ms from change to output\n",
+        changedFiles.Size(), affected.Size(), latency);
+      WriteLog("watch: %u changed files, %u classes regenerated, %u ms from change to output\n",
+        changedFiles.Size(), affected.Size(), latency);
+    }
+  }
+
+  bool DocWatcher::WaitForChanges(HashSet<String>& changedFiles)
+  {
+    static const DWORD cNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME
+      | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+    DWORD timeout = INFINITE;
+
+    for (;;)
+    {
+      if (!mReadPending)
+      {
+        ResetEvent(mOverlapped.hEvent);
+
+        if (!ReadDirectoryChangesW(mDirectory, mChangeBuffer.Data(),
+          mChangeBuffer.Size() * sizeof(DWORD), TRUE, cNotifyFilter, nullptr, &mOverlapped, nullptr))
+        {
+          return false;
+        }
+
+        mReadPending = true;
+      }
+
+      DWORD result = WaitForSingleObject(mOverlapped.hEvent, timeout);
+
+      // quiet long enough, the read stays pending so nothing is missed while regenerating
+      if (result == WAIT_TIMEOUT)
+        return true;
+
+      if (result != WAIT_OBJECT_0)
+        return false;
+
+      mReadPending = false;
+
+      DWORD bytes = 0;
+
+      if (!GetOverlappedResult(mDirectory, &mOverlapped, &bytes, FALSE))
+      {
+        if (GetLastError() != ERROR_NOTIFY_ENUM_DIR)
+          return false;
+
+        bytes = 0;
+      }
+
+      if (timeout == INFINITE)
+        mFirstChangeTime = GetTickCount();
+
+      // more changed than the buffer could hold, which files is lost
+      if (bytes == 0)
+        mLostChanges = true;
+      else
+        ReadChangeBuffer(changedFiles);
+
+      timeout = cQuietTimeMs;
+    }
+  }
+
+  void DocWatcher::ReadChangeBuffer(HashSet<String>& changedFiles)
+  {
+    const byte* entry = (const byte*)mChangeBuffer.Data();
+
+    for (;;)
+    {
+      const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)entry;
+
+      char name[MAX_PATH * 4];
+      int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName,
+        info->FileNameLength / sizeof(WCHAR), name, sizeof(name) - 1, nullptr, nullptr);
+
+      if (length > 0)
+      {
+        name[length] = '\0';
+
+        String relativePath = name;
+
+        if (relativePath.EndsWith(".xml"))
+          changedFiles.Insert(FilePath::Combine(mConfig.mDoxygenPath, relativePath));
+      }
+
+      if (info->NextEntryOffset == 0)
+        break;
+
+      entry += info->NextEntryOffset;
+    }
+  }
+
+  void DocWatcher::CollectAffectedClasses(const HashSet<String>& changedFiles,
+    HashSet<String>& affected)
+  {
+    RawDocumentationLibrary& library = *mLibrary;
+    MacroDatabase* macroDb = MacroDatabase::GetInstance();
+
+    mNamespacesChanged = false;
+    mTypedefsChanged = false;
+
+    // nothing can be trusted once changes were lost, so everything is loaded again
+    if (mLostChanges)
+    {
+      WriteLog("watch: too many changes to track, regenerating every class\n");
+
+      forRange(RawClassDoc* classDoc, library.mClasses.All())
+      {
+        affected.Insert(classDoc->mName);
+      }
+
+      mLostChanges = false;
+      mNamespacesChanged = true;
+    }
+
+    // normalized source listing paths that changed
+    HashSet<String> changedListings;
+
+    forRange(const String& path, changedFiles.All())
+    {
+      if (library.mIgnoreList.DirectoryIsOnIgnoreList(path))
+        continue;
+
+      String fileName = path.SubString(path.FindLastOf('\\').End(), path.End()).ToLower();
+
+      if (fileName.StartsWith("namespace"))
+      {
+        mNamespacesChanged = true;
+        continue;
+      }
+
+      if (!fileName.StartsWith("class_") && !fileName.StartsWith("struct_"))
+      {
+        changedListings.Insert(NormalizeWatchPath(path));
+        continue;
+      }
+
+      // deleted files fail to load, the class stays as it was until it is regenerated
+      TiXmlDocument doc;
+
+      if (!doc.LoadFile(path.c_str()))
+        continue;
+
+      TiXmlElement* doxygen = doc.FirstChildElement(gElementTags[eDOXYGEN]);
+      TiXmlElement* compoundDef = doxygen ? doxygen->FirstChildElement(gElementTags[eCOMPOUNDDEF]) : nullptr;
+      TiXmlElement* compoundName = compoundDef ? compoundDef->FirstChildElement("compoundname") : nullptr;
+
+      if (!compoundName)
+        continue;
+
+      // same name the class got when it was first loaded
+      TypeTokens tokens;
+
+      AppendTokensFromString(DocLangDfa::Get(), GetTextFromAllChildrenNodesRecursively(compoundName), &tokens);
+
+      if (tokens.Empty())
+        continue;
+
+      String className = tokens.Back().mText;
+
+      mClassFiles[className] = path;
+      affected.Insert(className);
+
+      // zilch types can be documented by several cpp classes
+      forRange(auto& entry, library.mZilchTypeToCppClassList.All())
+      {
+        if (entry.second.Contains(className))
+          affected.Insert(entry.first);
+      }
+    }
+
+    if (!changedListings.Empty())
+    {
+      // events and exceptions are scanned from the listing the class is implemented in
+      forRange(RawClassDoc* classDoc, library.mClasses.All())
+      {
+        String bodyPath = classDoc->GetBodySourcePath(mConfig.mDoxygenPath);
+
+        if (bodyPath.Empty())
+          continue;
+
+        String listingPath = GetListingPath(bodyPath, mConfig.mDoxygenPath);
+
+        if (!listingPath.Empty() && changedListings.Contains(NormalizeWatchPath(listingPath)))
+          affected.Insert(classDoc->mName);
+      }
+
+      // every call site of a macro defined in a changed listing has to be expanded again
+      HashSet<MacroData*> staleMacros;
+
+      forRange(auto& entry, macroDb->mMacroFiles.All())
+      {
+        String listingPath = GetListingPath(entry.first, mConfig.mDoxygenPath);
+
+        if (listingPath.Empty() || !changedListings.Contains(NormalizeWatchPath(listingPath)))
+          continue;
+
+        mStaleMacroFiles.PushBack(entry.first);
+
+        forRange(auto& macroEntry, entry.second->mMacros.All())
+        {
+          staleMacros.Insert(macroEntry.second);
+        }
+      }
+
+      forRange(MacroCall& call, macroDb->mMacroCalls.All())
+      {
+        if (staleMacros.Contains(call.mMacro))
+          affected.Insert(call.mClass->mName);
+      }
+    }
+
+    if (mNamespacesChanged && mConfig.mLoadTypedefsFromDoxygen)
+      ReloadTypedefs(affected);
+  }
+
+  void DocWatcher::ReloadTypedefs(HashSet<String>& affected)
+  {
+    RawTypedefLibrary* tdLibrary = RawTypedefLibrary::Get();
+
+    // remember what every typedef expanded to so only the ones that changed count
+    HashMap<String, String> oldDefinitions;
+    HashMap<String, String> oldNames;
+
+    forRange(RawTypedefDoc& typedefDoc, tdLibrary->mTypedefArray.All())
+    {
+      String key = typedefDoc.GenerateMapKey();
+      oldDefinitions[key] = TrimTypeTokens(typedefDoc.mDefinition);
+      oldNames[key] = typedefDoc.mType;
+    }
+
+    // same steps the generator takes
+    tdLibrary->mTypedefs.Clear();
+    tdLibrary->mTypedefArray.Clear();
+
+    if (mConfig.mLoadTypedefs)
+      tdLibrary->LoadFromFile(mConfig.mTrimmedTypedefFile);
+
+    tdLibrary->LoadTypedefsFromNamespaceDocumentation(mConfig.mDoxygenPath);
+    tdLibrary->BuildMap();
+    tdLibrary->ExpandAllTypedefs();
+
+    HashSet<String> changedNames;
+
+    forRange(RawTypedefDoc& typedefDoc, tdLibrary->mTypedefArray.All())
+    {
+      String key = typedefDoc.GenerateMapKey();
+      String* oldDefinition = oldDefinitions.FindPointer(key);
+
+      if (!oldDefinition || *oldDefinition != TrimTypeTokens(typedefDoc.mDefinition))
+        changedNames.Insert(typedefDoc.mType);
+
+      oldDefinitions.Erase(key);
+    }
+
+    // anything left over was removed
+    forRange(auto& entry, oldDefinitions.All())
+    {
+      changedNames.Insert(oldNames[entry.first]);
+    }
+
+    if (changedNames.Empty())
+      return;
+
+    mTypedefsChanged = true;
+
+    forRange(auto& entry, mTypeUsage.All())
+    {
+      forRange(String& typeName, changedNames.All())
+      {
+        if (entry.second.Contains(typeName))
+        {
+          affected.Insert(entry.first);
+          break;
+        }
+      }
+    }
+  }
+
+  void DocWatcher::AddDerivedClasses(HashSet<String>& affected)
+  {
+    // derived classes copy descriptions and macro documentation from their bases,
+    // keep sweeping until a pass adds nothing since base chains are short
+    bool added = true;
+
+    while (added)
+    {
+      added = false;
+
+      forRange(RawClassDoc* classDoc, mLibrary->mClasses.All())
+      {
+        if (classDoc->mBaseClass.Empty() || affected.Contains(classDoc->mName))
+          continue;
+
+        if (affected.Contains(classDoc->mBaseClass))
+        {
+          affected.Insert(classDoc->mName);
+          added = true;
+        }
+      }
+    }
+  }
+
+  void DocWatcher::RegenerateClasses(const HashSet<String>& affected)
+  {
+    RawDocumentationLibrary& library = *mLibrary;
+    MacroDatabase* macroDb = MacroDatabase::GetInstance();
+    String& doxyPath = mConfig.mDoxygenPath;
+
+    // the stale classes go first so their macro calls are gone before any macro is freed
+    forRange(const String& className, affected.All())
+    {
+      RawClassDoc* oldClass = library.mClassMap.FindValue(className, nullptr);
+
+      if (oldClass)
+        library.RemoveClass(oldClass);
+    }
+
+    forRange(String& path, mStaleMacroFiles.All())
+    {
+      macroDb->InvalidateMacroFile(path);
+    }
+    mStaleMacroFiles.Clear();
+
+    if (mNamespacesChanged && library.mSkeleton)
+      library.LoadAllEnumDocumentationFromDoxygen(doxyPath);
+
+    uint firstCall = macroDb->mMacroCalls.Size();
+
+    Array<RawClassDoc*> reloaded;
+
+    forRange(const String& className, affected.All())
+    {
+      String xmlPath = mClassFiles.FindValue(className, String());
+
+      if (xmlPath.Empty())
+        xmlPath = DoxygenIndex::Get()->FindClass(className);
+
+      RawClassDoc* classDoc = library.LoadSingleClass(className, doxyPath, xmlPath);
+
+      if (classDoc)
+        reloaded.PushBack(classDoc);
+    }
+
+    library.LoadEventsForQueuedClasses(doxyPath);
+    macroDb->ProcessMacroCalls(firstCall);
+    FlattenedSourceCache::Get()->Clear();
+
+    library.BuildAddedClasses(reloaded);
+    library.FillOverloadDescriptions();
+
+    forRange(RawClassDoc* classDoc, reloaded.All())
+    {
+      RecordClassTypeUsage(classDoc);
+
+      if (mConfig.mReplaceTypes)
+        classDoc->NormalizeAllTypes(RawTypedefLibrary::Get());
+
+      if (mConfig.mTagAllAsUnbound)
+        classDoc->mTags.PushBack("Non-Zilch");
+    }
+
+    if (mConfig.mOutputDirectory.SizeInBytes())
+    {
+      forRange(RawClassDoc* classDoc, reloaded.All())
+      {
+        if (library.GenerateClassDocumentationFile(mConfig.mOutputDirectory, classDoc)
+          && !library.mClassPaths.Contains(classDoc->mRelativePath))
+        {
+          library.mClassPaths.PushBack(classDoc->mRelativePath);
+        }
+      }
+
+      library.SaveToFile(BuildString(mConfig.mOutputDirectory, "\\Library.data"));
+
+      if (mTypedefsChanged)
+        RawTypedefLibrary::Get()->GenerateTypedefDataFile(mConfig.mOutputDirectory);
+    }
+
+    if (mConfig.mEventsOutputLocation.SizeInBytes())
+      library.SaveEventListToFile(mConfig.mEventsOutputLocation);
+
+    if (mConfig.mCreateTrimmed)
+    {
+      if (!mConfig.mTrimmedTypedefFile.Empty())
+      {
+        RawTypedefLibrary trimTypedef;
+
+        if (trimTypedef.LoadFromFile(mConfig.mTrimmedTypedefFile))
+        {
+          forRange(RawClassDoc* classDoc, reloaded.All())
+          {
+            classDoc->NormalizeAllTypes(&trimTypedef);
+          }
+        }
+      }
+
+      library.RefillTrimmedClasses(mTrimLib, affected);
+
+      SaveTrimDocToDataFile(mTrimLib, mConfig.mTrimmedOutput);
+      SaveTrimDocToBinaryFile(mTrimLib, mConfig.mTrimmedBinaryOutput);
+    }
+
+    // every page links to other classes so all of them are built, the sink only
+    // rewrites the pages that came out different
+    if (!mConfig.mMarkupDirectory.Empty())
+      WriteOutAllReMarkupFiles(mConfig, mMarkupSources);
+  }
+
+  void DocWatcher::RecordClassTypeUsage(RawClassDoc* classDoc)
+  {
+    HashSet<String>& usedNames = mTypeUsage[classDoc->mName];
+    usedNames.Clear();
+
+    forRange(RawVariableDoc* variable, classDoc->mVariables.All())
+    {
+      AddUsedTypeNames(*variable->mTokens, usedNames);
+    }
+
+    forRange(RawMethodDoc* method, classDoc->mMethods.All())
+    {
+      AddUsedTypeNames(*method->mReturnTokens, usedNames);
+
+      forRange(RawMethodDoc::Parameter* parameter, method->mParsedParameters.All())
+      {
+        AddUsedTypeNames(*parameter->mTokens, usedNames);
+      }
+    }
+  }
+}
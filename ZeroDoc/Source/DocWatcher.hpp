@@ -0,0 +1,79 @@
+#pragma once
+
+namespace Zero
+{
+  struct DocGeneratorConfig;
+  struct ReMarkupSources;
+  class RawDocumentationLibrary;
+  class RawClassDoc;
+  class DocumentationLibrary;
+
+  /// Keeps everything the generator built resident after a normal run and watches the doxygen
+  /// directory. Classes whose xml changed are loaded again along with every class depending on
+  /// them (derived classes, typedef users and macro call sites) and only their outputs are redone.
+  class DocWatcher
+  {
+  public:
+    DocWatcher(DocGeneratorConfig& config, DocumentationLibrary& trimLib,
+      ReMarkupSources& markupSources);
+
+    ~DocWatcher();
+
+    /// remembers which type names every class of library uses. Has to run before the types
+    /// are normalized since the typedef names are gone from the tokens afterwards
+    void RecordTypeUsage(RawDocumentationLibrary& library);
+
+    /// watches the doxygen directory and regenerates outputs until the process is closed
+    void Run(RawDocumentationLibrary& library);
+
+  private:
+    /// blocks until something in the doxygen directory changes, then keeps collecting changed
+    /// xml files until it has been quiet for a moment. False if the directory can't be watched
+    bool WaitForChanges(HashSet<String>& changedFiles);
+
+    /// adds every xml file named in the change buffer to changedFiles
+    void ReadChangeBuffer(HashSet<String>& changedFiles);
+
+    /// works out which classes the changed doxygen files affect directly
+    void CollectAffectedClasses(const HashSet<String>& changedFiles, HashSet<String>& affected);
+
+    /// loads the typedefs again and adds every class using one that changed to affected
+    void ReloadTypedefs(HashSet<String>& affected);
+
+    /// adds every class deriving from an affected class, however indirectly
+    void AddDerivedClasses(HashSet<String>& affected);
+
+    /// loads the affected classes again and rewrites the outputs depending on them
+    void RegenerateClasses(const HashSet<String>& affected);
+
+    void RecordClassTypeUsage(RawClassDoc* classDoc);
+
+    DocGeneratorConfig& mConfig;
+    DocumentationLibrary& mTrimLib;
+    ReMarkupSources& mMarkupSources;
+    RawDocumentationLibrary* mLibrary;
+
+    // unqualified type names every class referred to before typedefs were replaced, by class
+    HashMap<String, HashSet<String> > mTypeUsage;
+
+    // class xml files that were seen changing by class name, dependents look theirs up in the index
+    HashMap<String, String> mClassFiles;
+
+    // macro tables parsed from changed listings, thrown out once their call sites are removed
+    Array<String> mStaleMacroFiles;
+
+    // set when a namespace file changed, enums and typedefs have to be loaded again
+    bool mNamespacesChanged;
+    bool mTypedefsChanged;
+
+    HANDLE mDirectory;
+    OVERLAPPED mOverlapped;
+    bool mReadPending;
+    // set when the change buffer overflowed and the individual changes were lost
+    bool mLostChanges;
+    Array<DWORD> mChangeBuffer;
+
+    // when the first change of the batch being collected came in
+    DWORD mFirstChangeTime;
+  };
+}
@@ -0,0 +1,128 @@
+#include "Precompiled.hpp"
+
+#include "DoxygenIndex.hpp"
+#include "RawDocumentation.hpp"
+#include "..\TinyXml\tinyxml.h"
+
+namespace Zero
+{
+  ////////////////////////////////////////////////////////////////////////
+  // DoxygenIndex
+  ////////////////////////////////////////////////////////////////////////
+  void DoxygenIndex::Load(StringParam doxyPath)
+  {
+    if (doxyPath.Empty() || mLoadedPaths.Contains(doxyPath))
+      return;
+
+    mLoadedPaths.Insert(doxyPath);
+
+    Array<String> indexFiles;
+    GetFilesWithPartialName(doxyPath, "index.xml", &indexFiles);
+
+    forRange(String& path, indexFiles.All())
+    {
+      // the partial name match also catches things like 'foo_index.xml'
+      if (!path.EndsWith("\\index.xml") && !path.EndsWith("/index.xml"))
+        continue;
+
+      if (!LoadIndexFile(path))
+        WriteLog("ERROR: unable to load doxygen index at: %s\n", path.c_str());
+    }
+
+    if (!IsLoaded())
+      WriteLog("No doxygen index.xml found under %s, guessing file names instead\n", doxyPath.c_str());
+  }
+
+  String DoxygenIndex::FindClass(StringParam className) const
+  {
+    // same as GetDoxygenName, template arguments are not part of the doxygen name
+    String name = className;
+    if (name.Contains("["))
+      name = name.SubString(name.Begin(), name.FindFirstOf("[").Begin());
+
+    // in the same order the old file name guesses were tried
+    const char* namespaces[] = { "Zero::", "Zilch::", "Zero::Physics::", "" };
+
+    for (uint i = 0; i < sizeof(namespaces) / sizeof(namespaces[0]); ++i)
+    {
+      String path = mClasses.FindValue(BuildString(namespaces[i], name), String());
+
+      if (!path.Empty())
+        return path;
+    }
+
+    return String();
+  }
+
+  String DoxygenIndex::FindNamespace(StringParam qualifiedName) const
+  {
+    return mNamespaces.FindValue(qualifiedName, String());
+  }
+
+  String DoxygenIndex::FindSourceFile(StringParam fileName) const
+  {
+    return mSourceFiles.FindValue(fileName, String());
+  }
+
+  void DoxygenIndex::GetFilesOfKind(StringParam kind, Array<String>* output) const
+  {
+    forRange(const Compound& compound, mCompounds.All())
+    {
+      if (compound.mKind == kind)
+        output->PushBack(compound.mPath);
+    }
+  }
+
+  DoxygenIndex* DoxygenIndex::Get(void)
+  {
+    static DoxygenIndex index;
+
+    return &index;
+  }
+
+  bool DoxygenIndex::LoadIndexFile(StringParam indexPath)
+  {
+    TiXmlDocument doc;
+
+    if (!doc.LoadFile(indexPath.c_str()))
+      return false;
+
+    TiXmlElement* root = doc.FirstChildElement("doxygenindex");
+
+    if (root == nullptr)
+      return false;
+
+    // keep the trailing separator so the refid can just be appended
+    String directory = indexPath.SubStringFromByteIndices(0, indexPath.SizeInBytes() - String("index.xml").SizeInBytes());
+
+    for (TiXmlElement* element = root->FirstChildElement("compound");
+      element != nullptr; element = element->NextSiblingElement("compound"))
+    {
+      const char* refid = element->Attribute("refid");
+      const char* kind = element->Attribute("kind");
+      TiXmlElement* nameElement = element->FirstChildElement("name");
+
+      if (refid == nullptr || kind == nullptr || nameElement == nullptr || nameElement->GetText() == nullptr)
+        continue;
+
+      Compound& compound = mCompounds.PushBack();
+      compound.mKind = kind;
+      compound.mName = nameElement->GetText();
+      compound.mPath = BuildString(directory, refid, ".xml");
+
+      HashMap<String, String>* nameMap = nullptr;
+
+      if (compound.mKind == "class" || compound.mKind == "struct")
+        nameMap = &mClasses;
+      else if (compound.mKind == "namespace")
+        nameMap = &mNamespaces;
+      else if (compound.mKind == "file")
+        nameMap = &mSourceFiles;
+
+      if (nameMap != nullptr && !nameMap->ContainsKey(compound.mName))
+        (*nameMap)[compound.mName] = compound.mPath;
+    }
+
+    return true;
+  }
+}
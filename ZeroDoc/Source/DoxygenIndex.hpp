@@ -0,0 +1,53 @@
+#pragma once
+
+namespace Zero
+{
+  /// Maps the compounds doxygen lists in its index.xml files to the xml file documenting
+  /// them, so class, namespace and source file lookups never have to guess file names.
+  class DoxygenIndex
+  {
+  public:
+    /// loads every index.xml found under doxyPath, paths that were already loaded are skipped.
+    /// Has to happen before any parallel pass looks anything up.
+    void Load(StringParam doxyPath);
+
+    /// returns true if at least one index.xml has been loaded
+    bool IsLoaded(void) const { return !mCompounds.Empty(); }
+
+    /// returns the xml file of the class or struct named className. Unqualified names are
+    /// looked for in the Zero, Zilch and Zero::Physics namespaces. Empty if it is not indexed.
+    String FindClass(StringParam className) const;
+
+    /// returns the xml file of the namespace with the fully qualified name, empty if not indexed
+    String FindNamespace(StringParam qualifiedName) const;
+
+    /// returns the xml file of the source listing of fileName (no directory), empty if not indexed
+    String FindSourceFile(StringParam fileName) const;
+
+    /// appends the xml file of every compound of kind, in index order
+    void GetFilesOfKind(StringParam kind, Array<String>* output) const;
+
+    /// gets a pointer to the shared index
+    static DoxygenIndex* Get(void);
+
+  private:
+    struct Compound
+    {
+      String mKind;
+      String mName;
+      String mPath;
+    };
+
+    /// reads one index.xml, every refid is relative to the directory it is in
+    bool LoadIndexFile(StringParam indexPath);
+
+    Array<Compound> mCompounds;
+
+    // qualified name to xml file, the first compound with a name wins
+    HashMap<String, String> mClasses;
+    HashMap<String, String> mNamespaces;
+    HashMap<String, String> mSourceFiles;
+
+    HashSet<String> mLoadedPaths;
+  };
+}
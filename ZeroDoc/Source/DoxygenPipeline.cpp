@@ -0,0 +1,162 @@
+#include "Precompiled.hpp"
+
+#include "DoxygenPipeline.hpp"
+#include "DocTaskPool.hpp"
+#include "RawDocumentation.hpp"
+#include "..\TinyXml\tinyxml.h"
+
+namespace Zero
+{
+  /// parses bytes the same way TiXmlDocument::LoadFile does, line breaks are normalized first
+  static TiXmlDocument* ParseDoxygenFile(StringParam path, Array<char>& bytes)
+  {
+    // translate \r\n and lone \r to \n in place, the text only ever gets shorter
+    uint write = 0;
+    for (uint read = 0; read < bytes.Size(); ++read)
+    {
+      char c = bytes[read];
+
+      if (c == '\r')
+      {
+        c = '\n';
+        if (read + 1 < bytes.Size() && bytes[read + 1] == '\n')
+          ++read;
+      }
+
+      bytes[write++] = c;
+    }
+    bytes.Resize(write);
+    bytes.PushBack('\0');
+
+    TiXmlDocument* doc = new TiXmlDocument();
+    doc->SetValue(path.c_str());
+    doc->Parse(bytes.Data(), 0, TIXML_DEFAULT_ENCODING);
+
+    if (doc->Error())
+    {
+      delete doc;
+      return nullptr;
+    }
+
+    return doc;
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // DoxygenPipeline
+  ////////////////////////////////////////////////////////////////////////
+  DoxygenPipeline::DoxygenPipeline(uint maxFilesInFlight, uint maxBytesInFlight)
+    : mMaxFilesInFlight(Math::Max(maxFilesInFlight, 1u))
+    , mMaxBytesInFlight(maxBytesInFlight)
+    , mPaths(nullptr)
+    , mFilesInFlight(0)
+    , mBytesInFlight(0)
+  {
+  }
+
+  void DoxygenPipeline::Start(const Array<String>& paths)
+  {
+    mPaths = &paths;
+    mSlots.Clear();
+    mSlots.Resize(paths.Size());
+    mFilesInFlight = 0;
+    mBytesInFlight = 0;
+
+    // the dispatcher only waits for budget and takes the calling thread's place in the pool's
+    // loops, the parsing itself happens on the pool's threads
+    mDispatcher = std::thread(&DoxygenPipeline::DispatchBatches, this);
+  }
+
+  TiXmlDocument* DoxygenPipeline::WaitForFile(uint index)
+  {
+    Slot& slot = mSlots[index];
+
+    {
+      std::unique_lock<std::mutex> lock(mLock);
+      mParseDone.wait(lock, [&]() { return slot.mParsed; });
+    }
+
+    if (!slot.mDoc)
+      WriteLog("ERROR: unable to load file at: %s\n", (*mPaths)[index].c_str());
+
+    return slot.mDoc;
+  }
+
+  void DoxygenPipeline::ReleaseFile(uint index)
+  {
+    Slot& slot = mSlots[index];
+
+    delete slot.mDoc;
+    slot.mDoc = nullptr;
+
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+      --mFilesInFlight;
+      mBytesInFlight -= slot.mSize;
+    }
+    mSpaceFreed.notify_one();
+  }
+
+  void DoxygenPipeline::Finish(void)
+  {
+    mDispatcher.join();
+
+    mSlots.Clear();
+    mPaths = nullptr;
+  }
+
+  void DoxygenPipeline::DispatchBatches(void)
+  {
+    uint fileCount = mPaths->Size();
+    uint next = 0;
+
+    while (next < fileCount)
+    {
+      uint batchSize;
+
+      // backpressure, a batch waits until at least half the file budget is free so the loops
+      // stay big enough to be worth dispatching. Nothing in flight always lets a batch through
+      // so a single huge file can not stall us
+      {
+        std::unique_lock<std::mutex> lock(mLock);
+        mSpaceFreed.wait(lock, [&]()
+        {
+          return mFilesInFlight == 0
+            || (mFilesInFlight <= mMaxFilesInFlight / 2 && mBytesInFlight < mMaxBytesInFlight);
+        });
+
+        batchSize = Math::Min(mMaxFilesInFlight - mFilesInFlight, fileCount - next);
+        mFilesInFlight += batchSize;
+      }
+
+      uint first = next;
+      DocTaskPool::Get()->ParallelFor(batchSize, [&](uint i)
+      {
+        ParseFile(first + i);
+      });
+
+      next += batchSize;
+    }
+  }
+
+  void DoxygenPipeline::ParseFile(uint index)
+  {
+    const String& path = (*mPaths)[index];
+
+    Array<char> bytes;
+    TiXmlDocument* doc = nullptr;
+
+    if (ReadWholeFile(path, bytes) && !bytes.Empty())
+      doc = ParseDoxygenFile(path, bytes);
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    // the raw size stands in for the document it was parsed into, which is never smaller
+    Slot& slot = mSlots[index];
+    slot.mSize = bytes.Size();
+    mBytesInFlight += slot.mSize;
+
+    slot.mDoc = doc;
+    slot.mParsed = true;
+    mParseDone.notify_all();
+  }
+}
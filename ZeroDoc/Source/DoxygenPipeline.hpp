@@ -0,0 +1,85 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class TiXmlDocument;
+
+namespace Zero
+{
+  /// Overlaps reading and parsing doxygen xml files with converting them. Batches of files are
+  /// read and parsed as tasks on the shared task pool while the calling thread converts the
+  /// files that are done in the original order. A new batch only starts once enough files and
+  /// bytes were released by the converter, so memory stays bounded however far ahead the pool
+  /// gets.
+  class DoxygenPipeline
+  {
+  public:
+    DoxygenPipeline(uint maxFilesInFlight = 64, uint maxBytesInFlight = 64 * 1024 * 1024);
+
+    /// reads and parses every file in paths in the background and calls
+    /// convert(index, path, doc) on the calling thread for each of them, in path order. doc is
+    /// null if the file could not be read or parsed and is deleted once convert returns.
+    /// Returns once every file was converted.
+    template <typename ConvertFn>
+    void Run(const Array<String>& paths, ConvertFn convert)
+    {
+      if (paths.Empty())
+        return;
+
+      Start(paths);
+
+      for (uint i = 0; i < paths.Size(); ++i)
+      {
+        TiXmlDocument* doc = WaitForFile(i);
+        convert(i, paths[i], doc);
+        ReleaseFile(i);
+      }
+
+      Finish();
+    }
+
+  private:
+    struct Slot
+    {
+      Slot() : mParsed(false), mSize(0), mDoc(nullptr) {}
+
+      bool mParsed;
+      // how many bytes this file counts against the in flight budget
+      uint mSize;
+      TiXmlDocument* mDoc;
+    };
+
+    /// starts handing batches of paths to the task pool
+    void Start(const Array<String>& paths);
+    /// blocks until file index was parsed, null if it could not be read or parsed
+    TiXmlDocument* WaitForFile(uint index);
+    /// deletes the document of file index and returns its share of the budget
+    void ReleaseFile(uint index);
+    /// waits for the last batch, every file has to be released by now
+    void Finish(void);
+
+    /// runs on mDispatcher, runs one parallel loop per batch until every file was parsed
+    void DispatchBatches(void);
+    /// reads and parses one file, runs as a pool task
+    void ParseFile(uint index);
+
+    uint mMaxFilesInFlight;
+    uint mMaxBytesInFlight;
+
+    const Array<String>* mPaths;
+    std::thread mDispatcher;
+
+    std::mutex mLock;
+    // signaled when a file was parsed, the converter may be waiting on it
+    std::condition_variable mParseDone;
+    // signaled when the converter released a file, the next batch may be ready to start
+    std::condition_variable mSpaceFreed;
+
+    Array<Slot> mSlots;
+
+    uint mFilesInFlight;
+    uint mBytesInFlight;
+  };
+}
@@ -0,0 +1,333 @@
+#include "Precompiled.hpp"
+
+#include "FlattenedSource.hpp"
+#include "RawDocumentation.hpp"
+#include "Platform/FileSystem.hpp"
+
+namespace Zero
+{
+  ////////////////////////////////////////////////////////////////////////
+  // FlattenedSource
+  ////////////////////////////////////////////////////////////////////////
+  void FlattenedSource::Build(TiXmlDocument* doc)
+  {
+    // grab the class
+    TiXmlElement* cppDef = doc->FirstChildElement(gElementTags[eDOXYGEN])
+      ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
+
+    TiXmlNode* programListNode = GetFirstNodeOfChildType(cppDef, "programlisting");
+
+    // pure documentation pages do not have any code
+    if (programListNode == nullptr)
+      return;
+
+    TiXmlElement *programList = programListNode->ToElement();
+
+    TiXmlNode *firstCodeline = GetFirstNodeOfChildType(programList, gElementTags[eCODELINE]);
+    TiXmlNode *endCodeline = GetEndNodeOfChildType(programList, gElementTags[eCODELINE]);
+
+    DocDfaState* dfa = DocLangDfa::Get();
+
+    for (TiXmlNode *codeline = firstCodeline;
+      codeline != endCodeline;
+      codeline = codeline->NextSibling())
+    {
+      StringBuilder builder;
+
+      GetTextFromAllChildrenNodesRecursively(codeline, &builder);
+
+      mLines.PushBack(builder.ToString());
+      String& codeString = mLines.Back();
+
+      TypeTokens& tokens = mTokens.PushBack();
+
+      if (!codeString.Empty())
+        AppendTokensFromString(dfa, codeString, &tokens);
+    }
+  }
+
+  void FlattenedSource::BuildFromText(const char* text, uint size)
+  {
+    const char* end = text + size;
+
+    // skip the utf-8 byte order mark, doxygen never shows it
+    if (size >= 3 && (byte)text[0] == 0xEF && (byte)text[1] == 0xBB && (byte)text[2] == 0xBF)
+      text += 3;
+
+    DocDfaState* dfa = DocLangDfa::Get();
+
+    while (text < end)
+    {
+      const char* lineEnd = text;
+      while (lineEnd < end && *lineEnd != '\n')
+        ++lineEnd;
+
+      const char* nextLine = lineEnd < end ? lineEnd + 1 : lineEnd;
+
+      if (lineEnd > text && lineEnd[-1] == '\r')
+        --lineEnd;
+
+      mLines.PushBack(String(text, lineEnd - text));
+      String& codeString = mLines.Back();
+
+      TypeTokens& tokens = mTokens.PushBack();
+
+      if (!codeString.Empty())
+        AppendTokensFromString(dfa, codeString, &tokens);
+
+      text = nextLine;
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // FlattenedSourceCache
+  ////////////////////////////////////////////////////////////////////////
+  FlattenedSourceCache::~FlattenedSourceCache()
+  {
+    Clear();
+  }
+
+  FlattenedSource* FlattenedSourceCache::GetSource(StringParam path)
+  {
+    Entry* entry = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+
+      entry = mEntries.FindValue(path, nullptr);
+
+      if (entry == nullptr)
+      {
+        entry = new Entry();
+        mEntries[path] = entry;
+      }
+    }
+
+    // files are flattened outside of the lock so different files can be flattened at once
+    std::call_once(entry->mBuilt, [&]()
+    {
+      if (!path.ToLower().EndsWith(".xml"))
+      {
+        Array<char> text;
+
+        if (!ReadWholeFile(path, text))
+        {
+          WriteLog("Failed to load file: %s\n", path.c_str());
+          return;
+        }
+
+        FlattenedSource* source = new FlattenedSource();
+        source->BuildFromText(text.Data(), text.Size());
+        entry->mSource = source;
+        return;
+      }
+
+      TiXmlDocument doc;
+
+      if (!doc.LoadFile(path.c_str()))
+      {
+        WriteLog("Failed to load file: %s\n", path.c_str());
+        return;
+      }
+
+      FlattenedSource* source = new FlattenedSource();
+      source->Build(&doc);
+      entry->mSource = source;
+    });
+
+    return entry->mSource;
+  }
+
+  void FlattenedSourceCache::Clear(void)
+  {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    forRange(auto& pair, mEntries.All())
+    {
+      delete pair.second->mSource;
+      delete pair.second;
+    }
+
+    mEntries.Clear();
+  }
+
+  FlattenedSourceCache* FlattenedSourceCache::Get(void)
+  {
+    static FlattenedSourceCache cache;
+
+    return &cache;
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // SourceFileIndex
+  ////////////////////////////////////////////////////////////////////////
+  // doxygen writes forward slashes, the file system and the command line may not
+  static char NormalizePathChar(char c)
+  {
+    if (c == '\\')
+      return '/';
+
+    return (char)tolower((unsigned char)c);
+  }
+
+  // how many whole path components at the end of both paths are the same
+  static uint CountMatchingTail(StringParam a, StringParam b)
+  {
+    const char* aBegin = a.c_str();
+    const char* bBegin = b.c_str();
+    const char* aEnd = aBegin + a.SizeInBytes();
+    const char* bEnd = bBegin + b.SizeInBytes();
+
+    uint components = 0;
+    while (aEnd != aBegin && bEnd != bBegin)
+    {
+      char c = NormalizePathChar(*--aEnd);
+      if (c != NormalizePathChar(*--bEnd))
+        return components;
+
+      if (c == '/')
+        ++components;
+    }
+
+    // a component only counts once it matched up to its separator or the start of the path
+    bool aDone = aEnd == aBegin || NormalizePathChar(aEnd[-1]) == '/';
+    bool bDone = bEnd == bBegin || NormalizePathChar(bEnd[-1]) == '/';
+
+    if (aDone && bDone)
+      ++components;
+
+    return components;
+  }
+
+  static bool IsSamePath(StringParam a, StringParam b)
+  {
+    if (a.SizeInBytes() != b.SizeInBytes())
+      return false;
+
+    const char* aChar = a.c_str();
+    const char* bChar = b.c_str();
+    for (; *aChar; ++aChar, ++bChar)
+    {
+      if (NormalizePathChar(*aChar) != NormalizePathChar(*bChar))
+        return false;
+    }
+
+    return true;
+  }
+
+  void SourceFileIndex::Enable(StringParam directory)
+  {
+    mEnabled = true;
+
+    if (!directory.Empty())
+      AddDirectory(directory);
+  }
+
+  void SourceFileIndex::AddFile(StringParam fullPath)
+  {
+    if (!mEnabled || fullPath.Empty())
+      return;
+
+    const char* name = fullPath.c_str();
+    for (const char* c = name; *c; ++c)
+    {
+      if (NormalizePathChar(*c) == '/')
+        name = c + 1;
+    }
+
+    String fileName = String(name).ToLower();
+
+    // doxygen may have run on another machine, only keep paths that can be read here
+    if (!FileExists(fullPath.c_str()))
+      return;
+
+    std::lock_guard<std::mutex> lock(mLock);
+    AddCandidate(fileName, fullPath);
+  }
+
+  String SourceFileIndex::FindFile(StringParam fileName, StringParam hintPath)
+  {
+    if (!mEnabled)
+      return String();
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    Array<String>* candidates = mFiles.FindPointer(fileName.ToLower());
+    if (candidates == nullptr)
+      return String();
+
+    // headers like Precompiled.hpp exist in every project, the directories tell them apart
+    String* bestPath = &(*candidates)[0];
+    uint bestMatch = 0;
+
+    if (candidates->Size() > 1 && !hintPath.Empty())
+    {
+      forRange(String& path, candidates->All())
+      {
+        uint match = CountMatchingTail(path, hintPath);
+        if (match > bestMatch)
+        {
+          bestPath = &path;
+          bestMatch = match;
+        }
+      }
+    }
+
+    return *bestPath;
+  }
+
+  void SourceFileIndex::FindFiles(StringParam fileName, Array<String>* output)
+  {
+    if (!mEnabled)
+      return;
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    Array<String>* candidates = mFiles.FindPointer(fileName.ToLower());
+    if (candidates == nullptr)
+      return;
+
+    forRange(String& path, candidates->All())
+    {
+      output->PushBack(path);
+    }
+  }
+
+  SourceFileIndex* SourceFileIndex::Get(void)
+  {
+    static SourceFileIndex index;
+
+    return &index;
+  }
+
+  void SourceFileIndex::AddDirectory(StringParam directory)
+  {
+    FileRange range(directory);
+    for (; !range.Empty(); range.PopFront())
+    {
+      FileEntry entry = range.frontEntry();
+
+      String filePath = entry.GetFullPath();
+      if (IsDirectory(filePath))
+      {
+        AddDirectory(filePath);
+        continue;
+      }
+
+      AddCandidate(entry.mFileName.ToLower(), filePath);
+    }
+  }
+
+  void SourceFileIndex::AddCandidate(StringParam fileName, StringParam fullPath)
+  {
+    Array<String>& candidates = mFiles[fileName];
+
+    // doxygen names the same files again for every class declared in them
+    forRange(String& path, candidates.All())
+    {
+      if (IsSamePath(path, fullPath))
+        return;
+    }
+
+    candidates.PushBack(fullPath);
+  }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "DocTypeTokens.hpp"
+
+#include <mutex>
+
+class TiXmlDocument;
+
+namespace Zero
+{
+  /// The programlisting of one doxygen file flattened into plain text lines and their tokens,
+  /// so the event, exception and macro scanners never walk or tokenize the xml themselves.
+  class FlattenedSource
+  {
+  public:
+    /// flattens and tokenizes every codeline in the programlisting of doc
+    void Build(TiXmlDocument* doc);
+
+    /// splits the text of an original source file into lines and tokenizes them, giving the
+    /// same lines doxygen writes as codelines so scanners can not tell the difference
+    void BuildFromText(const char* text, uint size);
+
+    /// returns the number of codelines (empty lines included)
+    uint GetLineCount(void) const { return mLines.Size(); }
+
+    /// text of every codeline in order, exactly as GetTextFromAllChildrenNodesRecursively builds it
+    Array<String> mLines;
+
+    /// tokens of every codeline in order
+    Array<TypeTokens> mTokens;
+  };
+
+  /// Caches the flattened source of every doxygen file that gets scanned
+  class FlattenedSourceCache
+  {
+  public:
+    ~FlattenedSourceCache();
+
+    /// returns the flattened source of the file at path, loading and flattening it the first
+    /// time it is asked for. Paths ending in .xml are doxygen programlistings, anything else
+    /// is read as an original source file. Returns null if the file could not be loaded.
+    FlattenedSource* GetSource(StringParam path);
+
+    /// frees every cached source, anything returned by GetSource is invalid after this
+    void Clear(void);
+
+    /// gets a pointer to the shared cache
+    static FlattenedSourceCache* Get(void);
+
+  private:
+    struct Entry
+    {
+      Entry() : mSource(nullptr) {}
+
+      std::once_flag mBuilt;
+      FlattenedSource* mSource;
+    };
+
+    std::mutex mLock;
+
+    UnsortedMap<String, Entry*> mEntries;
+  };
+
+  /// Finds the original source files doxygen documented so they can be scanned directly,
+  /// instead of the programlisting xml doxygen only writes with XML_PROGRAMLISTING on.
+  /// Files are known from the location doxygen gives for class members and, if a source
+  /// directory is given, from every file under it.
+  class SourceFileIndex
+  {
+  public:
+    SourceFileIndex() : mEnabled(false) {}
+
+    /// turns source scanning on, every file under directory is indexed if it is not empty
+    void Enable(StringParam directory);
+
+    bool IsEnabled(void) const { return mEnabled; }
+
+    /// remembers the full path of a source file if it exists. Files with the same name in
+    /// different directories are all kept
+    void AddFile(StringParam fullPath);
+
+    /// full path of the source file named fileName (no directory), empty if it is not known.
+    /// If several files have that name the one whose directories match the most of the end of
+    /// hintPath wins, like the path doxygen gave, otherwise the first one found
+    String FindFile(StringParam fileName, StringParam hintPath = String());
+
+    /// appends the full path of every source file named fileName, in the order they were found
+    void FindFiles(StringParam fileName, Array<String>* output);
+
+    /// gets a pointer to the shared index
+    static SourceFileIndex* Get(void);
+
+  private:
+    void AddDirectory(StringParam directory);
+
+    /// adds fullPath under fileName unless it is already there, expects the lock to be held
+    void AddCandidate(StringParam fileName, StringParam fullPath);
+
+    bool mEnabled;
+
+    std::mutex mLock;
+
+    // lower case file name to the full path of every file by that name
+    HashMap<String, Array<String> > mFiles;
+  };
+}
@@ -0,0 +1,208 @@
+#include "Precompiled.hpp"
+
+#include "LoopbackServer.hpp"
+#include "RawDocumentation.hpp"
+
+#pragma comment(lib, "ws2_32.lib")
+
+namespace Zero
+{
+  // longest a round waits, so Stop is noticed even when nothing happens
+  static const double cMaxWaitMs = 100.0;
+
+  ////////////////////////////////////////////////////////////////////////
+  // LoopbackServer
+  ////////////////////////////////////////////////////////////////////////
+  LoopbackServer::LoopbackServer(cstr name)
+    : mAcceptedCount(0)
+    , mName(name)
+    , mListenSocket(INVALID_SOCKET)
+    , mPort(0)
+    , mStartedWinsock(false)
+    , mStopping(false)
+  {
+  }
+
+  LoopbackServer::~LoopbackServer()
+  {
+    forRange(LoopbackConnection* connection, mConnections.All())
+    {
+      closesocket(connection->mSocket);
+      delete connection;
+    }
+
+    if (mListenSocket != INVALID_SOCKET)
+      closesocket(mListenSocket);
+
+    if (mStartedWinsock)
+      WSACleanup();
+  }
+
+  bool LoopbackServer::Start(uint port)
+  {
+    WSADATA wsaData;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    {
+      WriteLog("Error: unable to start winsock for the %s\n", mName);
+      return false;
+    }
+    mStartedWinsock = true;
+
+    mListenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    if (mListenSocket == INVALID_SOCKET)
+    {
+      WriteLog("Error: unable to create the %s socket\n", mName);
+      return false;
+    }
+
+    // only local tools are meant to reach the server
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((u_short)port);
+
+    if (bind(mListenSocket, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR
+      || listen(mListenSocket, SOMAXCONN) == SOCKET_ERROR)
+    {
+      WriteLog("Error: the %s is unable to listen on port %u\n", mName, port);
+      return false;
+    }
+
+    int addressSize = sizeof(address);
+    getsockname(mListenSocket, (sockaddr*)&address, &addressSize);
+    mPort = ntohs(address.sin_port);
+
+    return true;
+  }
+
+  void LoopbackServer::Run(void)
+  {
+    double waitMs = cMaxWaitMs;
+
+    while (!mStopping)
+    {
+      fd_set readSet;
+      FD_ZERO(&readSet);
+      FD_SET(mListenSocket, &readSet);
+
+      // FD_SETSIZE caps how many connections are served at once, the rest wait to be accepted
+      for (uint i = 0; i < mConnections.Size() && i < FD_SETSIZE - 1; ++i)
+      {
+        if (WantsToReceive(*mConnections[i]))
+          FD_SET(mConnections[i]->mSocket, &readSet);
+      }
+
+      long waitUs = (long)(waitMs * 1000.0);
+      timeval timeout = { waitUs / 1000000, waitUs % 1000000 };
+
+      int ready = select(0, &readSet, nullptr, nullptr, &timeout);
+
+      if (ready == SOCKET_ERROR)
+      {
+        WriteLog("Error: %s select failed with %d\n", mName, WSAGetLastError());
+        return;
+      }
+
+      // connections accepted now were not part of the select
+      uint selectedCount = mConnections.Size();
+
+      if (FD_ISSET(mListenSocket, &readSet))
+      {
+        SOCKET client = accept(mListenSocket, nullptr, nullptr);
+
+        if (client != INVALID_SOCKET)
+        {
+          // responses are small, do not let them wait on acks
+          BOOL noDelay = TRUE;
+          setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+          LoopbackConnection* connection = CreateConnection();
+          connection->mSocket = client;
+          mConnections.PushBack(connection);
+          ++mAcceptedCount;
+        }
+      }
+
+      waitMs = cMaxWaitMs;
+
+      for (uint i = 0; i < mConnections.Size();)
+      {
+        LoopbackConnection* connection = mConnections[i];
+        bool open = true;
+
+        if (i < selectedCount && FD_ISSET(connection->mSocket, &readSet))
+          open = Receive(*connection);
+
+        // read the clock after receiving so an answer due right away goes out this round
+        if (open)
+          open = Update(*connection, GetDocTimeMs(), waitMs);
+
+        if (open)
+        {
+          ++i;
+          continue;
+        }
+
+        closesocket(connection->mSocket);
+        delete connection;
+        mConnections.EraseAt(i);
+      }
+
+      waitMs = Math::Max(waitMs, 0.0);
+    }
+  }
+
+  void LoopbackServer::Stop(void)
+  {
+    mStopping = true;
+  }
+
+  LoopbackConnection* LoopbackServer::CreateConnection(void)
+  {
+    return new LoopbackConnection();
+  }
+
+  bool LoopbackServer::WantsToReceive(LoopbackConnection& connection)
+  {
+    return true;
+  }
+
+  bool LoopbackServer::Update(LoopbackConnection& connection, double now, double& waitMs)
+  {
+    return true;
+  }
+
+  bool LoopbackServer::SendAll(SOCKET socket, const char* data, uint size)
+  {
+    int remaining = (int)size;
+
+    while (remaining > 0)
+    {
+      int sent = send(socket, data, remaining, 0);
+
+      if (sent == SOCKET_ERROR)
+        return false;
+
+      data += sent;
+      remaining -= sent;
+    }
+
+    return true;
+  }
+
+  bool LoopbackServer::Receive(LoopbackConnection& connection)
+  {
+    char buffer[16384];
+    int received = recv(connection.mSocket, buffer, sizeof(buffer), 0);
+
+    if (received <= 0)
+      return false;
+
+    connection.mPending.append(buffer, received);
+
+    return HandleReceived(connection);
+  }
+}
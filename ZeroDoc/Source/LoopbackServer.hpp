@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+namespace Zero
+{
+  /// what a LoopbackServer keeps for every connection it accepted, servers derive their own
+  struct LoopbackConnection
+  {
+    LoopbackConnection() : mSocket(INVALID_SOCKET) {}
+    virtual ~LoopbackConnection() {}
+
+    SOCKET mSocket;
+    // bytes received that the server has not handled yet
+    std::string mPending;
+  };
+
+  /// Accepts TCP connections on 127.0.0.1 and serves all of them from the thread calling Run,
+  /// waiting on every socket at once with select. Derived servers only handle the bytes that
+  /// arrive on a connection and answer them.
+  class LoopbackServer
+  {
+  public:
+    /// name is what the error log calls the server
+    LoopbackServer(cstr name);
+    virtual ~LoopbackServer();
+
+    /// starts listening on port, 0 picks a free port. False if the socket could not be set up
+    bool Start(uint port);
+
+    /// the port the server listens on once started
+    uint GetPort(void) const { return mPort; }
+
+    /// serves connections until Stop is called from another thread
+    void Run(void);
+
+    void Stop(void);
+
+    /// connections accepted since the server started
+    uint mAcceptedCount;
+
+  protected:
+    /// makes the state kept for a connection that was just accepted
+    virtual LoopbackConnection* CreateConnection(void);
+
+    /// handles what was added to the connection's mPending, false to close the connection
+    virtual bool HandleReceived(LoopbackConnection& connection) = 0;
+
+    /// false while the connection is not waiting for anything from the client
+    virtual bool WantsToReceive(LoopbackConnection& connection);
+
+    /// called every round for every open connection whether anything arrived or not, false to
+    /// close it. Lowering waitMs makes the next round come no later than that
+    virtual bool Update(LoopbackConnection& connection, double now, double& waitMs);
+
+    /// sends every byte of data, false if the connection broke
+    static bool SendAll(SOCKET socket, const char* data, uint size);
+
+  private:
+    /// reads what the connection sent and hands it to HandleReceived, false once it closed
+    bool Receive(LoopbackConnection& connection);
+
+    cstr mName;
+    SOCKET mListenSocket;
+    uint mPort;
+    bool mStartedWinsock;
+
+    std::atomic<bool> mStopping;
+
+    Array<LoopbackConnection*> mConnections;
+  };
+}
@@ -3,6 +3,8 @@
 #include "MacroDatabase.hpp"
 #include "TinyXmlHelpers.hpp"
 #include "DocTypeParser.hpp"
+#include "DocTaskPool.hpp"
+#include "DoxygenIndex.hpp"
 
 namespace Zero
 {
@@ -27,13 +29,13 @@ namespace Zero
     AppendTokensFromString(DocLangDfa::Get(), macroString, &mMacroBody);
   }
 
-  MacroData::MacroData(TiXmlNode* startCodeline,
-    TiXmlNode* endCodeline, TypeTokens& startTokens)
+  MacroData::MacroData(FlattenedSource* source, uint startLine, TypeTokens& startTokens)
   {
     //mMacroBody = startTokens;
 
     // skip past the first two tokens as they are just '#' and 'Define'
-    DocTypeParser macroCallParser(startTokens,2);
+    DocParseArena arena;
+    DocTypeParser macroCallParser(startTokens, arena, 2);
 
     CallNode *node = macroCallParser.Call();
 
@@ -45,27 +47,200 @@ namespace Zero
       }
     }
 
-    for (TiXmlNode *codeline = startCodeline;
-      codeline != endCodeline;
-      codeline = codeline->NextSibling())
+    for (uint line = startLine; line < source->GetLineCount(); ++line)
     {
-      StringBuilder builder;
+      if (source->mLines[line].Empty())
+        continue;
 
-      GetTextFromAllChildrenNodesRecursively(codeline, &builder);
+      forRange(DocToken& token, source->mTokens[line].All())
+      {
+        mMacroBody.PushBack(token);
+      }
 
-      if (builder.GetSize() <= 0)
-        continue;
+      if (mMacroBody[mMacroBody.Size() - 1].mEnumTokenType != DocTokenType::BackwardSlash)
+        break;
+    }
+  }
+
+  const MacroExpansionTemplate& MacroData::GetExpansionTemplate(void)
+  {
+    // calls for different classes can expand the same macro at the same time
+    std::call_once(mTemplateCompiled, [this]() { CompileExpansionTemplate(); });
 
-      String codeString = builder.ToString();
+    return mTemplate;
+  }
 
+  int MacroData::FindParameterSlot(StringParam name)
+  {
+    // search backwards so a repeated parameter name resolves to the last one, like the old arg map
+    for (int i = (int)mParameters.Size() - 1; i >= 0; --i)
+    {
+      if (mParameters[i] == name)
+        return i;
+    }
+    return -1;
+  }
 
-      AppendTokensFromString(DocLangDfa::Get(), codeString, &mMacroBody);
+  void MacroData::CompileExpansionTemplate(void)
+  {
+    TypeTokens& literals = mTemplate.mLiterals;
+    Array<MacroTemplateOp>& ops = mTemplate.mOps;
+    mTemplate.mOutputSize = 0;
 
-      if (mMacroBody[mMacroBody.Size() - 1].mEnumTokenType != DocTokenType::BackwardSlash)
+    // skip past the parameter list, the body starts after the first ')'
+    uint start = 0;
+    for (; start < mMacroBody.Size(); ++start)
+    {
+      if (mMacroBody[start].mEnumTokenType == DocTokenType::CloseParen)
+      {
+        ++start;
         break;
+      }
+    }
+
+    for (uint i = start; i < mMacroBody.Size(); ++i)
+    {
+      DocToken &currToken = mMacroBody[i];
+      DocTokenType::Enum type = currToken.mEnumTokenType;
+
+      // strip out the line endings
+      if (type == DocTokenType::BackwardSlash)
+        continue;
+
+      MacroTemplateOp op;
+      op.mBegin = 0;
+      op.mEnd = 0;
+
+      // stringify and concatenate always consume the token after them
+      if (type == DocTokenType::Pound || type == DocTokenType::Concatenate)
+      {
+        if (++i >= mMacroBody.Size())
+          break;
+
+        DocToken& operand = mMacroBody[i];
+        int slot = FindParameterSlot(operand.mText);
+
+        if (type == DocTokenType::Pound)
+        {
+          ++mTemplate.mOutputSize;
+
+          if (slot < 0)
+          {
+            literals.PushBack(DocToken(operand.mText, DocTokenType::StringLiteral));
+            op.mType = MacroTemplateOpType::LiteralRun;
+            op.mBegin = literals.Size() - 1;
+            op.mEnd = literals.Size();
+          }
+          else
+          {
+            op.mType = MacroTemplateOpType::Stringify;
+            op.mBegin = slot;
+          }
+        }
+        else if (slot < 0)
+        {
+          literals.PushBack(DocToken(operand.mText, DocTokenType::Identifier));
+          op.mType = MacroTemplateOpType::ConcatText;
+          op.mBegin = literals.Size() - 1;
+        }
+        else
+        {
+          op.mType = MacroTemplateOpType::ConcatParameter;
+          op.mBegin = slot;
+        }
+      }
+      // check for arg substitution
+      else if (type == DocTokenType::Identifier && FindParameterSlot(currToken.mText) >= 0)
+      {
+        ++mTemplate.mOutputSize;
+        op.mType = MacroTemplateOpType::Parameter;
+        op.mBegin = FindParameterSlot(currToken.mText);
+      }
+      // just copy the token, comments right after comments get combined
+      else
+      {
+        if (type == DocTokenType::Comment && !ops.Empty()
+          && ops.Back().mType == MacroTemplateOpType::LiteralRun
+          && literals.Back().mEnumTokenType == DocTokenType::Comment)
+        {
+          literals.Back().mText = BuildString(literals.Back().mText, currToken.mText);
+          continue;
+        }
+
+        ++mTemplate.mOutputSize;
+        literals.PushBack(DocToken(currToken.mText, type));
+        op.mType = MacroTemplateOpType::LiteralRun;
+        op.mBegin = literals.Size() - 1;
+        op.mEnd = literals.Size();
+      }
+
+      // extend the previous run instead of starting a new one
+      if (op.mType == MacroTemplateOpType::LiteralRun && !ops.Empty()
+        && ops.Back().mType == MacroTemplateOpType::LiteralRun && ops.Back().mEnd == op.mBegin)
+      {
+        ops.Back().mEnd = op.mEnd;
+        continue;
+      }
+
+      ops.PushBack(op);
     }
   }
 
+  ////////////////////////////////////////////////////////////////////////
+  // MacroExpandContext
+  ////////////////////////////////////////////////////////////////////////
+  MacroExpandContext::~MacroExpandContext()
+  {
+    forRange(RawMethodDoc* method, mMethods.All())
+    {
+      delete method;
+    }
+  }
+
+  String MacroExpandContext::SearchExpandStackForOption(StringParam option)
+  {
+    for (int i = mExpandStack.Size() - 1; i >= 0; --i)
+    {
+      MacroCall* call = mExpandStack[i];
+
+      String optionValue = call->GetOption(option);
+
+      if (optionValue != "")
+      {
+        return optionValue;
+      }
+    }
+    return gEmptyString;
+  }
+
+  void MacroExpandContext::AddMethod(RawMethodDoc* method)
+  {
+    mMethods.PushBack(method);
+  }
+
+  void MacroExpandContext::MergeIntoClass(void)
+  {
+    forRange(RawMethodDoc* method, mMethods.All())
+    {
+      // if we find a match, fill that instead of adding a duplicate function
+      mClass->FillMatchingMethod(method);
+
+      delete method;
+    }
+
+    mMethods.Clear();
+  }
+
+  void MacroExpandContext::ReportParseErrors(void)
+  {
+    forRange(String& message, mParseErrors.All())
+    {
+      Zero::DoNotifyError("Parsing error", message.c_str());
+    }
+
+    mParseErrors.Clear();
+  }
+
   ////////////////////////////////////////////////////////////////////////
   // MacroCall
   ////////////////////////////////////////////////////////////////////////
@@ -110,7 +285,10 @@ namespace Zero
 
       StringRange varName = commentVar.SubStringFromByteIndices(1, commentVar.SizeInBytes());
 
-      String varValue = MacroDatabase::GetInstance()->SearchMacroExpandStackForOption(varName);
+      if (mContext == nullptr)
+        return;
+
+      String varValue = mContext->SearchExpandStackForOption(varName);
 
       if (varValue != "")
       {
@@ -176,122 +354,102 @@ namespace Zero
     }
   }
 
-  String replaceIdentifier(DocToken &token, UnsortedMap<String, String>& argMap)
+  const String& MacroCall::GetArgument(uint slot)
   {
-    if (argMap.ContainsKey(token.mText))
-    {
-      return argMap[token.mText];
-    }
-    return token.mText;
+    // with mismatched counts unfilled parameters are left as they are
+    if (slot < mMacroArgs.Size())
+      return mMacroArgs[slot];
+
+    return mMacro->mParameters[slot];
   }
 
   void MacroCall::ExpandCall(void)
   {
-    // first create a little map for our parameters
-    UnsortedMap<String,String> argMap;
-
     if (mMacro->mParameters.Size() != mMacroArgs.Size())
       Error("Param and Arg counts do not match for call to '%s'", mMacro->mName.c_str());
 
-    for (uint i = 0; i < mMacro->mParameters.Size(); ++i)
-    {
-      String& param = mMacro->mParameters[i];
-      argMap[param] = mMacroArgs[i];
-    }
+    if (mContext)
+      mContext->mExpandStack.PushBack(this);
 
-    MacroDatabase::GetInstance()->mMacroExpandStack.PushBack(this);
+    const MacroExpansionTemplate& expansion = mMacro->GetExpansionTemplate();
+    const TypeTokens& literals = expansion.mLiterals;
 
-    // we are going to unwrap the loop a bit to make things easier,
-    // so first we are going to find the first ')' and jump to parsing after
-    // that point
-    TypeTokens &macroBody = mMacro->mMacroBody;
-    uint start = 0;
-    for (; start < macroBody.Size(); ++start)
-    {
-      if (macroBody[start].mEnumTokenType == DocTokenType::CloseParen)
-      {
-        ++start;
-        break;
-      }
-    }
+    mExpandedMacro.Reserve(mExpandedMacro.Size() + expansion.mOutputSize);
 
-    for (uint i = start; i < macroBody.Size(); ++i)
+    forRange(const MacroTemplateOp& op, expansion.mOps.All())
     {
-      DocToken &currToken = macroBody[i];
-
-      switch (currToken.mEnumTokenType)
+      switch (op.mType)
       {
-        // strip out the line endings
-      case DocTokenType::BackwardSlash:
-        continue;
-
-        // stringify
-      case DocTokenType::Pound:
-      {
-        mExpandedMacro.PushBack(DocToken(replaceIdentifier(macroBody[++i], argMap), DocTokenType::StringLiteral));
-      }
-        break;
-
-        // concatinate
-      case DocTokenType::Concatenate:
+      case MacroTemplateOpType::LiteralRun:
       {
-        // combine the text from it and the next token
-        StringBuilder newTokenBuilder;
+        uint i = op.mBegin;
 
-        // get last token
-        DocToken &lastToken = mExpandedMacro.Back();
+        // a leading comment still combines with a comment we already output
+        const DocToken& firstToken = literals[i];
+        if (firstToken.mEnumTokenType == DocTokenType::Comment && !mExpandedMacro.Empty()
+          && mExpandedMacro.Back().mEnumTokenType == DocTokenType::Comment)
+        {
+          DocToken& prevToken = mExpandedMacro.Back();
+          prevToken.mText = BuildString(prevToken.mText, firstToken.mText);
+          ++i;
+        }
 
-        // concatinate the two tokens into one string
-        newTokenBuilder << lastToken.mText;
-        // we still have to check if it is one of our arguments
-        newTokenBuilder << replaceIdentifier(macroBody[++i], argMap);
-        
-        // delete the last token that we added (as it is now invalid)
-        mExpandedMacro.PopBack();
+        for (; i < op.mEnd; ++i)
+          mExpandedMacro.PushBack(literals[i]);
+      }
+      break;
 
-        String newTokString = newTokenBuilder.ToString();
+      case MacroTemplateOpType::Parameter:
+        mExpandedMacro.PushBack(DocToken(GetArgument(op.mBegin), DocTokenType::Identifier));
+        break;
 
-        mExpandedMacro.PushBack(DocToken(newTokString, DocTokenType::Identifier));
-      }
+        // stringify
+      case MacroTemplateOpType::Stringify:
+        mExpandedMacro.PushBack(DocToken(GetArgument(op.mBegin), DocTokenType::StringLiteral));
         break;
 
-        // check for arg substitution
-      case DocTokenType::Identifier:
+        // concatinate the last token we output with the next piece into one identifier
+      case MacroTemplateOpType::ConcatParameter:
+      case MacroTemplateOpType::ConcatText:
       {
-        DocToken &newTok = mExpandedMacro.PushBack();
+        const String& piece = op.mType == MacroTemplateOpType::ConcatText
+          ? literals[op.mBegin].mText : GetArgument(op.mBegin);
 
-        newTok.mText = replaceIdentifier(macroBody[i], argMap);
-        newTok.mEnumTokenType = DocTokenType::Identifier;
-      }
-      break;
-
-      case DocTokenType::Comment:
-      if (!mExpandedMacro.Empty())
-      {
-        DocToken& prevToken = mExpandedMacro.Back();
-        // combine comment tokens
-        if (prevToken.mEnumTokenType == DocTokenType::Comment)
-        {
-          prevToken.mText = BuildString(prevToken.mText, currToken.mText);
-          break;
-        }
+        DocToken& lastToken = mExpandedMacro.Back();
+        lastToken.mText = BuildString(lastToken.mText, piece);
+        lastToken.mEnumTokenType = DocTokenType::Identifier;
       }
-      mExpandedMacro.PushBack(currToken);
       break;
-      // just copy the token into the expanded macro list
-      default:
-        mExpandedMacro.PushBack(currToken);
-        break;
       }
     }
   }
 
   void MacroCall::AddExpandedMacroDocToRawClass(void)
   {
-    UniquePointer<BlockNode> parsedMacro = ParseBlock(&mExpandedMacro);
+    // a call made on its own (like from the tests) expands in a context of its own
+    MacroExpandContext localContext(mClass);
+    MacroExpandContext* context = mContext;
+
+    if (context == nullptr)
+    {
+      context = &localContext;
+      localContext.mExpandStack.PushBack(this);
+    }
+
+    // the parsed nodes are only needed until they have been added to the class
+    DocParseArena arena;
+
+    BlockNode* parsedMacro = ParseBlock(&mExpandedMacro, context, arena);
     
     // all the work now happens here due to wanting to do recursive expansion
-    parsedMacro->AddToClassDoc(mClass);
+    if (parsedMacro)
+      parsedMacro->AddToClassDoc(mClass, context);
+
+    if (context == &localContext)
+    {
+      localContext.MergeIntoClass();
+      localContext.ReportParseErrors();
+    }
   }
 
   ////////////////////////////////////////////////////////////////////////
@@ -306,80 +464,118 @@ namespace Zero
 
   MacroData *MacroDatabase::FindMacro(StringParam name, StringParam location)
   {
-    // there are some macro loading scenarios where we store macros by non-unique names, check for that
-    if (mMacrosByName.ContainsKey(name))
+    if (!mDoxyPath.Empty())
     {
-      return mMacrosByName[name];
-    }
+      MacroLocationFiles* locationFiles;
+      {
+        std::lock_guard<std::mutex> lock(mMacroLock);
 
-    Array<String> fileList;
-    String doxyName = GetDoxyfileNameFromSourceFileName(location);
-    // first get the list of all possible files that could contain the macro
-    GetFilesWithPartialName(mDoxyPath, doxyName, &fileList);
+        locationFiles = mLocationFiles.FindValue(location, nullptr);
 
-    // if we didn't find any matching files, we have failed in our mission, return nothing
-    if (fileList.Empty())
-      return nullptr;
+        if (locationFiles == nullptr)
+        {
+          locationFiles = new MacroLocationFiles();
+          mLocationFiles[location] = locationFiles;
+        }
+      }
 
-    // if we get here, we have not already loaded the macro, go ahead and try to load it
-    forRange(String& path, fileList.All())
-    {
-      String macroId = BuildString(path, name);
+      // the directory walk for a location only ever has to happen once
+      std::call_once(locationFiles->mFound, [&]()
+      {
+        Array<String>* fileList = &locationFiles->mFiles;
+
+        // every header by that name is searched, the first one defining the macro wins
+        SourceFileIndex::Get()->FindFiles(location, fileList);
 
-      // attempt to load macro from file
+        if (!fileList->Empty())
+          return;
 
-      // load the file
-      TiXmlDocument macroFile;
+        String indexedFile = DoxygenIndex::Get()->FindSourceFile(location);
 
-      if (!macroFile.LoadFile(path.c_str()))
+        if (!indexedFile.Empty())
+        {
+          fileList->PushBack(indexedFile);
+        }
+        else
+        {
+          String doxyName = GetDoxyfileNameFromSourceFileName(location);
+          // first get the list of all possible files that could contain the macro
+          GetFilesWithPartialName(mDoxyPath, doxyName, fileList);
+        }
+      });
+
+      // every file is only parsed once, after that all of its macros are served from its table
+      forRange(String& path, locationFiles->mFiles.All())
       {
-        continue;
-      }
+        MacroFileTable* table = GetMacroFileTable(path);
+
+        MacroData* macro = table->mMacros.FindValue(name, nullptr);
 
-      // pass it to the parser so we can actually save the macro
-      MacroData* macro = SaveMacroFromDoxyfile(&macroFile, name);
+        if (macro != nullptr)
+        {
+          std::lock_guard<std::mutex> lock(mMacroLock);
 
-      mMacrosByName[name] = macro;
+          // remember the first definition we found so lookups from other locations can use it
+          if (!mMacrosByName.ContainsKey(name))
+            mMacrosByName[name] = macro;
 
-      if (macro != nullptr)
-        return macro;
+          return macro;
+        }
+      }
     }
 
-    WriteLog("Error: Unable to load macro '%s' from file: '%s'\n", name, location);
+    // there are some macro loading scenarios where we store macros by non-unique names, check for that
+    MacroData* namedMacro;
+    {
+      std::lock_guard<std::mutex> lock(mMacroLock);
+      namedMacro = mMacrosByName.FindValue(name, nullptr);
+    }
+
+    if (namedMacro)
+      return namedMacro;
+
+    WriteLog("Error: Unable to load macro '%s' from file: '%s'\n", name.c_str(), location.c_str());
     // if we make it out of the loop, we didn't find the macro definition
     return nullptr;
   }
 
-  /// searches codelines for the definition of the macro we are looking for, then saves it
-  MacroData* MacroDatabase::SaveMacroFromDoxyfile(TiXmlDocument* macroFile, StringParam name)
+  MacroFileTable* MacroDatabase::GetMacroFileTable(StringParam path)
   {
-    // start looping over codelines
-    TiXmlElement* cppDef = macroFile->FirstChildElement(gElementTags[eDOXYGEN])
-      ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
+    MacroFileTable* table;
+    {
+      std::lock_guard<std::mutex> lock(mMacroLock);
 
-    TiXmlElement *programList = GetFirstNodeOfChildType(cppDef, "programlisting")->ToElement();
+      table = mMacroFiles.FindValue(path, nullptr);
 
-    TiXmlNode *firstCodeline = GetFirstNodeOfChildType(programList, gElementTags[eCODELINE]);
-    TiXmlNode *endCodeline = GetEndNodeOfChildType(programList, gElementTags[eCODELINE]);
+      if (table == nullptr)
+      {
+        table = new MacroFileTable();
+        mMacroFiles[path] = table;
+      }
+    }
 
-    // the majority of this loop is just getting the current function
-    for (TiXmlNode *codeline = firstCodeline;
-      codeline != endCodeline;
-      codeline = codeline->NextSibling())
+    // loading and tokenizing happens outside of the lock, lookups of other files go on
+    // meanwhile and lookups of this one wait here until the table is filled
+    std::call_once(table->mBuilt, [&]()
     {
-      // get the tokens from the current codeline and skip empty lines
-      StringBuilder builder;
-
-      GetTextFromAllChildrenNodesRecursively(codeline, &builder);
-
-      if (builder.GetSize() <= 0)
-        continue;
+      // files that fail to load just get an empty table so we never try them again
+      FlattenedSource* source = FlattenedSourceCache::Get()->GetSource(path);
 
-      String codeString = builder.ToString();
+      if (source)
+      {
+        SaveMacrosFromSource(source, table);
+      }
+    });
 
-      TypeTokens tokens;
+    return table;
+  }
 
-      AppendTokensFromString(DocLangDfa::Get(), codeString, &tokens);
+  /// searches codelines for the definition of every macro in the file, then saves them all
+  void MacroDatabase::SaveMacrosFromSource(FlattenedSource* source, MacroFileTable* table)
+  {
+    for (uint line = 0; line < source->GetLineCount(); ++line)
+    {
+      TypeTokens& tokens = source->mTokens[line];
 
       // we know there has to be at least 3 tokens for us to care [#,define,name]
       if (tokens.Size() < 4)
@@ -393,19 +589,17 @@ namespace Zero
       if (tokens[1].mText != "define")
         continue;
 
-      // if it was, check the next word to see if it is the name of the macro we are looking for
-      if (tokens[2].mText == name)
-      {
-        MacroData *macro = new MacroData(codeline, endCodeline, tokens);
-        // if it is, pass it to our other parsing function
-        macro->mName = name;
+      // if it was, the next word is the name of the macro, first definition in the file wins
+      String& name = tokens[2].mText;
 
-        mMacrosByName[name] = macro;
+      if (table->mMacros.ContainsKey(name))
+        continue;
 
-        return macro;
-      }
+      MacroData *macro = new MacroData(source, line, tokens);
+      macro->mName = name;
+
+      table->mMacros[name] = macro;
     }
-    return nullptr;
   }
 
   void MacroDatabase::SaveMacroCallFromClass(RawClassDoc *classDoc,
@@ -513,29 +707,86 @@ namespace Zero
       mMacroCalls.PopBack();
   }
 
-  void MacroDatabase::ProcessMacroCalls(void)
+  void MacroDatabase::ProcessMacroCalls(uint firstCall)
+  {
+    // group the calls by class, keeping the order the classes first made a call in
+    Array<MacroExpandContext*> contexts;
+    Array<Array<MacroCall*> > callsByContext;
+    HashMap<RawClassDoc*, uint> contextIndices;
+
+    for (uint i = firstCall; i < mMacroCalls.Size(); ++i)
+    {
+      MacroCall &call = mMacroCalls[i];
+      uint* index = contextIndices.FindPointer(call.mClass);
+
+      if (index == nullptr)
+      {
+        contextIndices[call.mClass] = contexts.Size();
+        contexts.PushBack(new MacroExpandContext(call.mClass));
+        callsByContext.PushBack().PushBack(&call);
+      }
+      else
+      {
+        callsByContext[*index].PushBack(&call);
+      }
+    }
+
+    // expanding only writes to the context, so classes can all expand at once
+    DocTaskPool::Get()->ParallelFor(contexts.Size(), [&](uint i)
+    {
+      MacroExpandContext* context = contexts[i];
+
+      forRange(MacroCall* call, callsByContext[i].All())
+      {
+        call->mContext = context;
+        call->ExpandCall();
+        call->AddExpandedMacroDocToRawClass();
+        context->mExpandStack.PopBack();
+        call->mContext = nullptr;
+      }
+    });
+
+    // merging touches base classes as well so it has to happen one class at a time
+    forRange(MacroExpandContext* context, contexts.All())
+    {
+      context->MergeIntoClass();
+      context->ReportParseErrors();
+      delete context;
+    }
+  }
+
+  void MacroDatabase::RemoveMacroCallsFromClass(RawClassDoc* classDoc)
   {
-    forRange(MacroCall &call, this->mMacroCalls.All())
+    for (uint i = 0; i < mMacroCalls.Size();)
     {
-      call.ExpandCall();
-      call.AddExpandedMacroDocToRawClass();
+      if (mMacroCalls[i].mClass == classDoc)
+        mMacroCalls.EraseAt(i);
+      else
+        ++i;
     }
   }
 
-  String MacroDatabase::SearchMacroExpandStackForOption(StringParam option)
+  void MacroDatabase::InvalidateMacroFile(StringParam path)
   {
-    for (int i = mMacroExpandStack.Size() - 1; i >= 0; --i)
+    MacroFileTable* table = mMacroFiles.FindValue(path, nullptr);
+
+    if (table == nullptr)
+      return;
+
+    mMacroFiles.Erase(path);
+
+    // name lookups can point into the table as well
+    forRange(auto& entry, table->mMacros.All())
     {
-      MacroCall* call = mMacroExpandStack[i];
+      MacroData* macro = entry.second;
 
-      String optionValue = call->GetOption(option);
+      if (mMacrosByName.FindValue(entry.first, nullptr) == macro)
+        mMacrosByName.Erase(entry.first);
 
-      if (optionValue != "")
-      {
-        return optionValue;
-      }
+      delete macro;
     }
-    return gEmptyString;
+
+    delete table;
   }
 
   ////////////////////////////////////////////////////////////////////////
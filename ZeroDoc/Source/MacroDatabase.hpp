@@ -3,6 +3,7 @@
 #include "DocTypeTokens.hpp"
 #include "RawDocumentation.hpp"
 #include "DocTypeParser.hpp"
+#include "FlattenedSource.hpp"
 
 namespace Zero
 {
@@ -15,29 +16,108 @@ namespace Zero
     "replacement"
   };
 
+  DeclareEnum5(MacroTemplateOpType, LiteralRun, Parameter, Stringify, ConcatParameter, ConcatText);
+
+  /// one step of a precompiled macro expansion
+  struct MacroTemplateOp
+  {
+    MacroTemplateOpType::Enum mType;
+
+    /// LiteralRun: first literal, Parameter/Stringify/ConcatParameter: parameter slot, ConcatText: literal
+    uint mBegin;
+
+    /// LiteralRun: one past the last literal, unused otherwise
+    uint mEnd;
+  };
+
+  /// A macro body compiled down to runs of literal tokens and parameter slots
+  /// so expanding a call is a linear fill with no lookups by name.
+  struct MacroExpansionTemplate
+  {
+    /// tokens copied as-is, adjacent comments already merged
+    TypeTokens mLiterals;
+
+    Array<MacroTemplateOp> mOps;
+
+    /// how many tokens an expansion adds before any concatenation
+    uint mOutputSize;
+  };
+
   struct MacroData
   {
     /// constructs MacroData by parsing code in string form
     MacroData(String& macroString);
 
-    /// constructs MacroData by getting code from given codeline range
-    MacroData(TiXmlNode* startCodeline, TiXmlNode* endCodeline, TypeTokens& startTokens);
+    /// constructs MacroData from the flattened codelines of source starting at startLine
+    MacroData(FlattenedSource* source, uint startLine, TypeTokens& startTokens);
+
+    /// compiles the macro body on first use, parameters must be set before the first call
+    const MacroExpansionTemplate& GetExpansionTemplate(void);
 
     String mName;
 
     TypeTokens mMacroBody;
 
     Array<String> mParameters;
+
+  private:
+    /// returns the slot of the parameter named name or -1 if it is not a parameter
+    int FindParameterSlot(StringParam name);
+
+    void CompileExpansionTemplate(void);
+
+    MacroExpansionTemplate mTemplate;
+
+    std::once_flag mTemplateCompiled;
+  };
+
+  struct MacroCall;
+
+  /// Expansion state for the macro calls made from one class. Each context has its own expand
+  /// stack and buffers what its expansions parse out, so different classes can expand at once.
+  class MacroExpandContext
+  {
+  public:
+    explicit MacroExpandContext(RawClassDoc* classDoc = nullptr) : mClass(classDoc) {}
+
+    ~MacroExpandContext();
+
+    /// returns option if it exists in one of the expanded macros on the stack. Otherwise returns empty string
+    String SearchExpandStackForOption(StringParam option);
+
+    /// saves a method parsed out of an expansion, the context takes ownership of it
+    void AddMethod(RawMethodDoc* method);
+
+    /// fills the matching methods of the class from every buffered method, in the order they were parsed
+    void MergeIntoClass(void);
+
+    /// notifies about every parse error collected during the expansion, on the thread that
+    /// joined the expansion tasks
+    void ReportParseErrors(void);
+
+    RawClassDoc* mClass;
+
+    Array<MacroCall *> mExpandStack;
+
+    Array<RawMethodDoc *> mMethods;
+
+    /// messages of the expansions that failed to parse, reported by ReportParseErrors
+    Array<String> mParseErrors;
   };
 
   struct MacroCall
   {
+    MacroCall() : mMacro(nullptr), mClass(nullptr), mContext(nullptr) {}
+
     /// Parses macroComment options that were in the comment of this MacroCall
     void ParseOptions(TypeTokens &tokens);
 
     /// Expands the macro by replacing it with the macro itself while subing in passed arguments
     void ExpandCall(void);
 
+    /// returns the argument passed for the parameter in slot
+    const String& GetArgument(uint slot);
+
     /// Adds any documentatble code to the RawClassDoc of the class this call was made from
     void AddExpandedMacroDocToRawClass(void);
 
@@ -57,6 +137,9 @@ namespace Zero
 
     RawClassDoc *mClass;
 
+    /// context this call expands in, calls without one get a context of their own when added
+    MacroExpandContext *mContext;
+
     TypeTokens mExpandedMacro;
 
     Array<String> mMacroArgs;
@@ -67,35 +150,68 @@ namespace Zero
     UnsortedMap<String, String> mOptions;
   };
 
+  /// every macro defined in a single doxygen source file, keyed by macro name
+  struct MacroFileTable
+  {
+    /// the file is parsed into the table once, by whichever lookup needs it first
+    std::once_flag mBuilt;
+    UnsortedMap<String, MacroData *> mMacros;
+  };
+
+  /// the doxygen files that could define the macros used at one source location
+  struct MacroLocationFiles
+  {
+    /// the files are searched for once, by whichever lookup needs them first
+    std::once_flag mFound;
+    Array<String> mFiles;
+  };
+
   class MacroDatabase
   {
   public:
     /// get current instance of the macro database
     static MacroDatabase *GetInstance(void);
 
-    /// returns id for macro
+    /// returns the macro named 'name' defined in the source file at location, or null
     MacroData* FindMacro(StringParam name, StringParam location);
 
-    /// saves macro into a macrodata object witha unique id so we are guarenteed not over override macros
-    MacroData* MacroDatabase::SaveMacroFromDoxyfile(TiXmlDocument* macroFile, StringParam name);
+    /// returns the table of every macro defined in the doxygen file at path, parsing it on first use
+    MacroFileTable* GetMacroFileTable(StringParam path);
+
+    /// saves every #define in the flattened programlisting of a doxygen file into table
+    void SaveMacrosFromSource(FlattenedSource* source, MacroFileTable* table);
 
     /// Saves MacroCall and comment from code IF it has the 'MacroComment' keyword in comment
     void SaveMacroCallFromClass(RawClassDoc *classDoc, TiXmlElement* element, 
       TiXmlNode* currMethod);
 
-    /// Iterates over all saved MacroCall, expands them, and does any macro call substitution
-    void ProcessMacroCalls(void);
+    /// Iterates over all saved MacroCall from firstCall on, expands them, and does any macro call
+    /// substitution. Calls from different classes are expanded in parallel and merged in class order.
+    void ProcessMacroCalls(uint firstCall = 0);
 
-    /// returns option if it exists in one of the expanded macros on the stack. Otherwise returns empty string
-    String SearchMacroExpandStackForOption(StringParam option);
+    /// forgets every call made from classDoc, used before the class is deleted
+    void RemoveMacroCallsFromClass(RawClassDoc* classDoc);
 
-    String mDoxyPath;
+    /// deletes the macros parsed from the doxygen file at path so the next lookup parses it again.
+    /// Calls that expanded one of its macros have to be removed first.
+    void InvalidateMacroFile(StringParam path);
 
-    Array<MacroCall *> mMacroExpandStack;
+    String mDoxyPath;
 
     Array<MacroCall> mMacroCalls;
 
+    /// macros registered by name alone, used when the location has no definition for a name
     UnsortedMap<String, MacroData *> mMacrosByName;
+
+    /// parsed macro tables keyed by doxygen file path
+    UnsortedMap<String, MacroFileTable *> mMacroFiles;
+
+    /// doxygen files that could contain the macros for a source location
+    UnsortedMap<String, MacroLocationFiles *> mLocationFiles;
+
+    /// guards the maps above since nested expansions look macros up from several threads.
+    /// Only finding or adding an entry takes it, files are searched and parsed outside of it
+    std::mutex mMacroLock;
   };
 
 }
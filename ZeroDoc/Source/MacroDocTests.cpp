@@ -49,7 +49,6 @@ bool doTest0(void)
 /// this not only is a more complex Test0, it also tests MacroComment option extraction
 bool doTest1(void)
 {
-  MacroDatabase::GetInstance()->mMacroExpandStack.Clear();
   // For Test1
   String AnchorAccessorsMacroTestString =
     "#define DeclareAnchorAccessors(ConstraintType, anchor)                                  \\\
@@ -133,8 +132,6 @@ bool doTest1(void)
 /// Test2 checks if we handle the "strigify" macro operator correctly
 bool doTest2(void)
 {
-  MacroDatabase::GetInstance()->mMacroExpandStack.Clear();
-
   // For Test2
   String stringifyTestString =
     "#define TestStringify(Str)\\\
@@ -165,8 +162,6 @@ bool doTest2(void)
 /// Test3 tests if we do macro concatination correctly
 bool doTest3(void)
 {
-  MacroDatabase::GetInstance()->mMacroExpandStack.Clear();
-
   // For Test3
   String concatTestString =
     "#define TestConcat(A,B)\\\
@@ -198,8 +193,6 @@ bool doTest3(void)
 /// Test4 uses actual code to see if simple macro expand works on larger example (codename: Davis Testcase)
 bool doTest4(void)
 {
-  MacroDatabase::GetInstance()->mMacroExpandStack.Clear();
-
   // From Test1
   String AnchorAccessorsMacroTestString =
     "#define DeclareAnchorAccessors(ConstraintType, anchor)                                  \\\
@@ -290,8 +283,6 @@ bool doTest4(void)
 // Tests if macro expand and concat work on a non-trivial code example(codename: Andrew Testcase)
 bool doTest5(void)
 {
-  MacroDatabase::GetInstance()->mMacroExpandStack.Clear();
-
   String AndrewMacroTestString0 = "\
 #define DeclareVariantGetSetForArithmeticTypes(property)       \\\
 /* MacroComment*/                                              \\\
@@ -373,8 +364,6 @@ are considered changed during change detection\"";
 /// Test6 is just like Test5 except it also tests MacroComment option passing two layers deep
 bool doTest6(void)
 {
-  MacroDatabase::GetInstance()->mMacroExpandStack.Clear();
-
   // bringing back the andrew case to test variable passing
 
   String AndrewMacroTestString0 =
@@ -486,6 +475,65 @@ type Get##property##typeName() const";
   return retVal;
 }
 
+/// Test7 expands one macro several times to check the precompiled expansion template gives the
+/// same tokens on every call (comment merging, stringify of plain text, and concat with plain text)
+bool doTest7(void)
+{
+  String templateTestString =
+    "#define TestTemplateReuse(Name, Type)\\\
+      /* Gets the value.*/ /* Really.*/\\\
+      Type Get##Name##Value() const;\\\
+      void Set##Name(Type value = #Name);\\\
+      String GetLabel(String label = #Label);";
+
+  // the two comments are combined into a single comment token by the expansion
+  String commentString = "/* Gets the value.*/ /* Really.*/";
+
+  TypeTokens commentTokens;
+  AppendTokensFromString(DocLangDfa::Get(), commentString, &commentTokens);
+
+  if (commentTokens.Size() != 2)
+    return false;
+
+  DocToken mergedComment(BuildString(commentTokens[0].mText, commentTokens[1].mText),
+    DocTokenType::Comment);
+
+  // init the Macro
+  MacroData testMacro(templateTestString);
+  testMacro.mParameters.PushBack("Name");
+  testMacro.mParameters.PushBack("Type");
+
+  // expanding the same args again after a different call has to give the same result
+  const char* names[] = { "Speed", "Mass", "Speed" };
+  const char* types[] = { "float", "double", "float" };
+
+  bool retVal = true;
+
+  for (uint i = 0; i < 3; ++i)
+  {
+    StringBuilder exampleOutputBuilder;
+    exampleOutputBuilder << types[i] << " Get" << names[i] << "Value() const;";
+    exampleOutputBuilder << "void Set" << names[i] << "(" << types[i] << " value = \"" << names[i] << "\");";
+    exampleOutputBuilder << "String GetLabel(String label = \"Label\");";
+
+    TypeTokens exampleOutputTokens;
+    exampleOutputTokens.PushBack(mergedComment);
+    AppendTokensFromString(DocLangDfa::Get(), exampleOutputBuilder.ToString(), &exampleOutputTokens);
+
+    // init the MacroCall (we are cheating a bunch since parsing relies to heavy on xml)
+    MacroCall testCall;
+    testCall.mMacroArgs.PushBack(names[i]);
+    testCall.mMacroArgs.PushBack(types[i]);
+    testCall.mMacro = &testMacro;
+
+    testCall.ExpandCall();
+
+    retVal &= exampleOutputTokens == testCall.mExpandedMacro;
+  }
+
+  return retVal;
+}
+
 bool doAllTests(void)
 {
   bool retVal = doTest0();
@@ -496,6 +544,7 @@ bool doAllTests(void)
   retVal &= doTest4();
   retVal &= doTest5();
   retVal &= doTest6();
+  retVal &= doTest7();
 
   return retVal;
 }
@@ -518,6 +567,8 @@ bool RunMacroTests(int test)
     return doTest5();
   case 6:
     return doTest6();
+  case 7:
+    return doTest7();
   default:
     return doAllTests();
   }
@@ -9,6 +9,9 @@
 #include "MarkupWriter.hpp"
 #include "RawDocumentation.hpp"
 #include "DocTypeParser.hpp"
+#include "DocOutputSink.hpp"
+#include "DocSearchIndex.hpp"
+#include "DescriptionLinker.hpp"
 
 namespace Zero
 {
@@ -71,7 +74,7 @@ void WriteTagIndices(String outputDir, DocToTags& tagged, DocumentationLibrary &
 
   String text = markup.ToString();
 
-  WriteStringRangeToFile(fileName, text);
+  DocOutputSink::Get()->WriteText(fileName, text);
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -106,7 +109,7 @@ void BaseMarkupWriter::IndentToCurrentLevel(void)
 
 void BaseMarkupWriter::WriteOutputToFile(StringParam file)
 {
-  WriteStringRangeToFile(file, mOutput.ToString());
+  DocOutputSink::Get()->WriteText(file, mOutput.ToString());
 }
 
 void BaseMarkupWriter::InsertNewUnderline(uint length, uint headerLevel)
@@ -180,6 +183,12 @@ String GetLinkName(StringParam name)
 }
 
 void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config)
+{
+  ReMarkupSources sources;
+  WriteOutAllReMarkupFiles(config, sources);
+}
+
+void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config, ReMarkupSources& sources)
 {
   String baseFromMarkupDirectory = "zero_engine_documentation\\code_reference";
   String baseClassDirectory = FilePath::Combine(baseFromMarkupDirectory, "class_reference");
@@ -190,16 +199,25 @@ void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config)
   // https://phab.digipen.edu/w/curriculum_development_and_documentation/rst_documentation/
   //       classname, link
 
+  // standalone runs have to load the trimmed documentation the generator saved
+  DocumentationLibrary loadedLibrary;
+  DocumentationLibrary* library = sources.mLibrary;
+
+  if (!library && FileExists(config.mTrimmedOutput.c_str()))
+  {
+    LoadDocumentationSkeleton(loadedLibrary, config.mTrimmedOutput);
+    loadedLibrary.FinalizeDocumentation();
+    library = &loadedLibrary;
+  }
+
   // check if we are outputting class markup
-  if (FileExists(config.mTrimmedOutput.c_str()))
+  if (library)
   {
     String& directory = config.mMarkupDirectory;
 
     CreateDirectoryAndParents(directory);
 
-    DocumentationLibrary doc;
-    LoadDocumentationSkeleton(doc, config.mTrimmedOutput);
-    doc.FinalizeDocumentation();
+    DocumentationLibrary& doc = *library;
 
 
     DocToTags tagged;
@@ -252,6 +270,9 @@ void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config)
         }
       }
     }
+    // every name above can now be linked from inside descriptions
+    gDescriptionLinker.Build(gLinkMap);
+
     //Upload the class' page to the wiki, making sure to perform the link replacements
     forRange(ClassDoc* classDoc, doc.mClasses.All())
     {
@@ -307,10 +328,10 @@ void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config)
       }
     }
 
-    WriteStringRangeToFile(FilePath::Combine(directory, baseFromMarkupDirectory,"class_reference.txt"), codeRefIndex.ToString());
+    DocOutputSink::Get()->WriteText(FilePath::Combine(directory, baseFromMarkupDirectory,"class_reference.txt"), codeRefIndex.ToString());
     //gah what shuld it be named
-    WriteStringRangeToFile(FilePath::Combine(directory, baseFromMarkupDirectory, "classes_by_tag_reference.txt"), tagsCodeRefIndex.ToString());
-    WriteStringRangeToFile(FilePath::Combine(directory, baseFromMarkupDirectory,"zilch_base_types.txt"), zilchCoreIndex.ToString());
+    DocOutputSink::Get()->WriteText(FilePath::Combine(directory, baseFromMarkupDirectory, "classes_by_tag_reference.txt"), tagsCodeRefIndex.ToString());
+    DocOutputSink::Get()->WriteText(FilePath::Combine(directory, baseFromMarkupDirectory,"zilch_base_types.txt"), zilchCoreIndex.ToString());
 
     WriteTagIndices(directory, tagged, doc);
 
@@ -323,6 +344,11 @@ void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config)
     String flagsOutput = FilePath::Combine(directory, baseFromMarkupDirectory, "flags_reference.txt");
     flagsOutput = FilePath::Normalize(flagsOutput);
     ReMarkupFlagsReferenceWriter::WriteFlagsReference(flagsOutput, doc);
+
+    // full text search over everything written above
+    String searchOutput = FilePath::Combine(directory, baseFromMarkupDirectory, "search_index.bin");
+    searchOutput = FilePath::Normalize(searchOutput);
+    SaveSearchIndexFile(doc, searchOutput);
   }
 
   // check if we outputting commands
@@ -338,7 +364,11 @@ void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config)
   {
     String output = FilePath::Combine(config.mMarkupDirectory, baseFromMarkupDirectory, "event_reference.txt");
     output = FilePath::Normalize(output);
-    ReMarkupEventListWriter::WriteEventList(config.mEventsOutputLocation, output);
+
+    if (sources.mEvents)
+      ReMarkupEventListWriter::WriteEventList(*sources.mEvents, output);
+    else
+      ReMarkupEventListWriter::WriteEventList(config.mEventsOutputLocation, output);
   }
 
   if (!config.mAttributesOutputLocation.Empty())
@@ -430,7 +460,7 @@ void ReMarkupWriter::InsertTypeLink(StringParam className)
 
   TypeTokens tokens;
 
-  AppendTokensFromString(DocLangDfa::Get(), className, &tokens);
+  TokenCache::Get()->Append(className, &tokens);
 
   forRange(auto& token, tokens.All())
   {
@@ -447,6 +477,11 @@ void ReMarkupWriter::InsertTypeLink(StringParam className)
   }
 }
 
+void ReMarkupWriter::InsertDescription(StringParam description, StringParam skipName)
+{
+  gDescriptionLinker.AppendLinked(description, mOutput, skipName);
+}
+
 ////////////////////////////////////////////////////////////////////////
 // ReMarkupClassMarkupWriter
 ////////////////////////////////////////////////////////////////////////
@@ -499,7 +534,9 @@ void ReMarkupClassMarkupWriter::WriteClass(StringParam outputFile,
 
   if (!classDoc->mDescription.Empty())
   {
-    writer.mOutput << mNoteLine << classDoc->mDescription << mEndLine;
+    writer.mOutput << mNoteLine;
+    writer.InsertDescription(classDoc->mDescription, classDoc->mName);
+    writer.mOutput << mEndLine;
   }
 
   writer.BuildDerivedList(lib);
@@ -587,7 +624,9 @@ void ReMarkupClassMarkupWriter::InsertMethod(MethodDoc &method)
   //Note: every line is going to have a '>' prepended to it to make it in a quote box
 
   // print the description directly under the header
-  mOutput << mQuoteLine << method.mDescription << "\n";
+  mOutput << mQuoteLine;
+  InsertDescription(method.mDescription, mName);
+  mOutput << "\n";
 
   // print parameter table
   mOutput << mQuoteLine << "|Name|Type|Description|\n" << mQuoteLine << "|---|---|---|\n";
@@ -603,7 +642,7 @@ void ReMarkupClassMarkupWriter::InsertMethod(MethodDoc &method)
     }
     else
     {
-      mOutput << param->mDescription;
+      InsertDescription(param->mDescription, mName);
     }
     mOutput << "|\n";
   }
@@ -667,7 +706,9 @@ void ReMarkupClassMarkupWriter::InsertProperty(PropertyDoc &propDoc)
   mOutput << mEndLine;
 
   // print the description directly under the header
-  mOutput << mQuoteLine << propDoc.mDescription << "\n";
+  mOutput << mQuoteLine;
+  InsertDescription(propDoc.mDescription, mName);
+  mOutput << "\n";
 
   // TODO: print the cpp codeblock
 
@@ -850,7 +891,8 @@ void ReMarkupEnumReferenceWriter::InsertEnumEntry(EnumDoc* enumDoc)
   // subheader for the method name
   mOutput << "====" << enumDoc->mName << mEndLine;
   // print the description directly under the header
-  mOutput << enumDoc->mDescription << mEndLine;
+  InsertDescription(enumDoc->mDescription, enumDoc->mName);
+  mOutput << mEndLine;
 
   mOutput << "|EnumValue|Description|\n|---|---|\n";
 
@@ -931,7 +973,8 @@ void ReMarkupFlagsReferenceWriter::InsertFlagsEntry(EnumDoc *flags)
   // subheader for the method name
   mOutput << "====" << flags->mName << mEndLine;
   // print the description directly under the header
-  mOutput << flags->mDescription << mEndLine;
+  InsertDescription(flags->mDescription, flags->mName);
+  mOutput << mEndLine;
 
   mOutput << "|FlagName|Description|\n|---|---|\n";
 
@@ -974,7 +1017,12 @@ void ReMarkupEventListWriter::WriteEventList(StringParam eventListFilepath, Stri
   EventDocList eventListDoc;
   LoadEventList(eventListDoc, eventListFilepath);
 
-  Array<EventDoc *> &eventArray = eventListDoc.mEvents;
+  WriteEventList(eventListDoc, outputPath);
+}
+
+void ReMarkupEventListWriter::WriteEventList(EventDocList& eventList, StringParam outputPath)
+{
+  Array<EventDoc *> &eventArray = eventList.mEvents;
 
   // create the eventList
   ReMarkupEventListWriter writer("Event Reference", BuildString(gBaseLink, "event_reference/"));
@@ -1128,7 +1176,10 @@ void ReMarkupCommandRefWriter::WriteCommandEntry(CommandDoc &cmdDoc)
   }
 
   if (!cmdDoc.mDescription.Empty())
-    mOutput << cmdDoc.mDescription << mEndLine;
+  {
+    InsertDescription(cmdDoc.mDescription);
+    mOutput << mEndLine;
+  }
 
   mOutput << "|Tags|Shortcut|Menu Selection|\n" << "|---|---|---|\n";
 
@@ -1286,7 +1337,11 @@ void ReMarkupAttributeRefWriter::InsertAttributeEntry(AttributeDoc* attribToAdd)
 
   // print the description directly under the header
   if (!attribToAdd->mDescription.Empty())
-    mOutput << mQuoteLine << attribToAdd->mDescription << "\n";
+  {
+    mOutput << mQuoteLine;
+    InsertDescription(attribToAdd->mDescription);
+    mOutput << "\n";
+  }
 
   InsertDivider();
 }
@@ -34,7 +34,22 @@ namespace Zero
   };
 
   ///// ReMarkup(Phabricator) /////
+
+  /// documentation the generator already has in memory, anything left null is loaded from
+  /// the files named in the config instead
+  struct ReMarkupSources
+  {
+    ReMarkupSources() : mLibrary(nullptr), mEvents(nullptr) {}
+
+    /// finalized trimmed documentation, loaded from trimmedOutput if null
+    DocumentationLibrary* mLibrary;
+    /// sorted event list, loaded from eventsOutputLocation if null
+    EventDocList* mEvents;
+  };
+
+  /// standalone markup run, everything is loaded from the files named in config
   void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config);
+  void WriteOutAllReMarkupFiles(Zero::DocGeneratorConfig& config, ReMarkupSources& sources);
 
   class ReMarkupWriter : public BaseMarkupWriter
   {
@@ -57,6 +72,9 @@ namespace Zero
 
     void InsertTypeLink(StringParam className);
 
+    /// inserts description with every type it mentions linked, except skipName
+    void InsertDescription(StringParam description, StringParam skipName = String());
+
     void InsertHeaderLink(StringParam header);
 
     String CutLinkToMaxSize(StringParam Link);
@@ -130,6 +148,7 @@ namespace Zero
     ReMarkupEventListWriter(StringParam name, StringParam uri);
 
     static void WriteEventList(StringParam eventListFilepath, StringParam outputPath);
+    static void WriteEventList(EventDocList& eventList, StringParam outputPath);
 
     void WriteEventEntry(EventDoc* eventDoc, StringParam type);
 
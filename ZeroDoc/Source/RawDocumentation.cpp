@@ -14,6 +14,15 @@
 #include "Platform\FileSystem.hpp"
 #include "TinyXmlHelpers.hpp"
 #include "MacroDatabase.hpp"
+#include "DocTaskPool.hpp"
+#include "FlattenedSource.hpp"
+#include "DoxygenIndex.hpp"
+#include "DocOutputSink.hpp"
+#include "DoxygenPipeline.hpp"
+#include "SkeletonStream.hpp"
+#include "ClassTrimStream.hpp"
+
+#include <chrono>
 
 #include <Engine/Documentation.hpp>
 
@@ -98,16 +107,8 @@ namespace Zero
 
   bool SaveTrimDocToDataFile(DocumentationLibrary &lib, StringParam absPath)
   {
-    Status status;
-
     TextSaver saver;
-    saver.Open(status, absPath.c_str());
-
-    if (status.Failed())
-    {
-      Error(status.Message.c_str());
-      return false;
-    }
+    saver.OpenBuffer();
 
     saver.StartPolymorphic("DocumentationLibrary");
 
@@ -119,8 +120,7 @@ namespace Zero
 
     saver.EndPolymorphic();
 
-    saver.Close();
-    return true;
+    return DocOutputSink::Get()->WriteSaver(absPath, saver);
   }
 
   ////////////////////////////////////////////////////////////////////////
@@ -213,32 +213,15 @@ namespace Zero
     return "";
   }
 
-  String GetCodeFromDocumentFile(TiXmlDocument *doc)
+  String GetCodeFromDocumentFile(FlattenedSource *source)
   {
     StringBuilder codeBuilder;
 
-    // grab the class
-    TiXmlElement* cppDef = doc->FirstChildElement(gElementTags[eDOXYGEN])
-      ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
-
-    TiXmlElement *programList = GetFirstNodeOfChildType(cppDef, "programlisting")->ToElement();
-
-    TiXmlNode *firstCodeline = GetFirstNodeOfChildType(programList, gElementTags[eCODELINE]);
-    TiXmlNode *endCodeline = GetEndNodeOfChildType(programList, gElementTags[eCODELINE]);
-
-    for (TiXmlNode *codeline = firstCodeline;
-      codeline != endCodeline;
-      codeline = codeline->NextSibling())
+    forRange(String& codeString, source->mLines.All())
     {
-      StringBuilder lineBuilder;
-
-      GetTextFromAllChildrenNodesRecursively(codeline, &lineBuilder);
-
-      if (lineBuilder.GetSize() == 0)
+      if (codeString.Empty())
         continue;
 
-      String codeString = lineBuilder.ToString();
-
       if (codeString.c_str()[0] == '#' ||
         (codeString.SizeInBytes() > 1 && codeString.c_str()[0] == '/' && codeString.c_str()[1] == '/'))
       {
@@ -374,13 +357,14 @@ namespace Zero
 
   // just keep trodding our way down the node structure until we get every single text node
   // (I am tired of edge cases making us miss text so this is the brute force hammer)
-  void GetTextFromAllChildrenNodesRecursively(TiXmlNode* node, StringBuilder* output)
+  template <typename BuilderType>
+  static void AppendTextFromAllChildrenNodes(TiXmlNode* node, BuilderType* output)
   {
     for (TiXmlNode *child = node->FirstChild(); child != nullptr; child = child->NextSibling())
     {
       if (child->Type() != TiXmlNode::TEXT)
       {
-        GetTextFromAllChildrenNodesRecursively(child, output);
+        AppendTextFromAllChildrenNodes(child, output);
         continue;
       }
 
@@ -389,6 +373,16 @@ namespace Zero
     }
   }
 
+  void GetTextFromAllChildrenNodesRecursively(TiXmlNode* node, StringBuilder* output)
+  {
+    AppendTextFromAllChildrenNodes(node, output);
+  }
+
+  void GetTextFromAllChildrenNodesRecursively(TiXmlNode* node, DescriptionBuilder* output)
+  {
+    AppendTextFromAllChildrenNodes(node, output);
+  }
+
   // call other overload but return string instead of getting passed a string builder
   String GetTextFromAllChildrenNodesRecursively(TiXmlNode* node)
   {
@@ -443,7 +437,8 @@ namespace Zero
     }
   }
 
-  void getTextFromParaNodes(TiXmlNode* node, StringBuilder* output)
+  template <typename BuilderType>
+  static void AppendTextFromParaNodes(TiXmlNode* node, BuilderType* output)
   {
     TiXmlElement* element = node->ToElement();
 
@@ -465,7 +460,7 @@ namespace Zero
             eleChild != nullptr;
             eleChild = eleChild->NextSibling())
           {
-            output->Append(GetTextFromAllChildrenNodesRecursively(eleChild));
+            AppendTextFromAllChildrenNodes(eleChild, output);
             output->Append(" ");
           }
         }
@@ -473,6 +468,16 @@ namespace Zero
     }
   }
 
+  void getTextFromParaNodes(TiXmlNode* node, StringBuilder* output)
+  {
+    AppendTextFromParaNodes(node, output);
+  }
+
+  void getTextFromParaNodes(TiXmlNode* node, DescriptionBuilder* output)
+  {
+    AppendTextFromParaNodes(node, output);
+  }
+
   // replaces token at location with the tokens from the typedef passed in
   uint ReplaceTypedefAtLocation(TypeTokens& tokenArray
     , DocToken* location, RawTypedefDoc& tDef)
@@ -549,9 +554,11 @@ namespace Zero
         
         key = builder.ToString();
 
-        if (defLib->mTypedefs.ContainsKey(key))
+        RawTypedefDoc* typedefDoc = defLib->mTypedefs.FindValue(key, nullptr);
+
+        if (typedefDoc)
         {
-          TypeTokens* typedefTokens = &defLib->mTypedefs[key]->mDefinition;
+          TypeTokens* typedefTokens = &typedefDoc->mDefinition;
 
           // make sure they are not just the same tokens
           if (tokens.Size() >= typedefTokens->Size() 
@@ -581,7 +588,7 @@ namespace Zero
           }
 
           madeReplacements = true;
-          i += ReplaceTypedefAtLocation(tokens, &token,*defLib->mTypedefs[key]);
+          i += ReplaceTypedefAtLocation(tokens, &token, *typedefDoc);
           break;
         }
       }
@@ -626,7 +633,7 @@ namespace Zero
       if (ignoreList.DirectoryIsOnIgnoreList(filePath))
       {
         WriteLog("Ignoring file/directory: %s\n", filePath.c_str());
-        return;
+        continue;
       }
 
       if (IsDirectory(filePath))
@@ -693,6 +700,38 @@ namespace Zero
     return builder.ToString();
   }
 
+  bool ReadWholeFile(StringParam path, Array<char>& bytes)
+  {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+      FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+    LARGE_INTEGER size;
+    bool success = GetFileSizeEx(file, &size) && size.QuadPart < 0x7FFFFFFF;
+
+    bytes.Clear();
+
+    if (success && size.QuadPart > 0)
+    {
+      DWORD read = 0;
+      bytes.Resize((uint)size.QuadPart);
+      success = ReadFile(file, bytes.Data(), (DWORD)size.QuadPart, &read, nullptr) && read == bytes.Size();
+    }
+
+    CloseHandle(file);
+    return success;
+  }
+
+  double GetDocTimeMs(void)
+  {
+    typedef std::chrono::high_resolution_clock DocClock;
+
+    static const DocClock::time_point sStart = DocClock::now();
+    return std::chrono::duration<double, std::milli>(DocClock::now() - sStart).count();
+  }
+
   void OutputListOfObjectsWithoutDesc(const DocumentationLibrary &trimDoc,
     IgnoreList *ignoreList)
   {
@@ -834,6 +873,9 @@ namespace Zero
   {
     SerializeName(mDirectories);
     SerializeName(mIgnoredNames);
+
+    // loading replaces the directories, so the trie has to be rebuilt
+    Compile();
   }
 
   template<> struct Zero::Serialization::Trait<IgnoreList>
@@ -843,34 +885,108 @@ namespace Zero
     static inline cstr TypeName() { return "IgnoreList"; }
   };
 
-  bool IgnoreList::DirectoryIsOnIgnoreList(StringParam dir) const
+  // calls fn(component, length) for every non empty component of the path in [begin, end)
+  template <typename ComponentFn>
+  static bool ForEachPathComponent(const char* begin, const char* end, ComponentFn fn)
   {
-    StringRange locationRange = dir.FindFirstOf(mDoxyPath);
+    const char* componentStart = begin;
 
-    uint location = locationRange.SizeInBytes();
+    for (const char* c = begin; c <= end; ++c)
+    {
+      if (c != end && *c != '\\' && *c != '/')
+        continue;
 
-    String relativeDir;
-    if (location != (uint)-1)
-      relativeDir = dir.SubStringFromByteIndices(mDoxyPath.SizeInBytes(), dir.SizeInBytes());
-    else
-      relativeDir = dir;
+      if (c != componentStart && fn(componentStart, (uint)(c - componentStart)))
+        return true;
 
-    if (mDirectories.Contains(relativeDir))
-      return true;
+      componentStart = c + 1;
+    }
 
-    // now recursivly check to see if we are in a directory that was ignored
-    StringRange subPath = relativeDir.SubString(relativeDir.Begin(), relativeDir.FindLastOf('\\').Begin());
+    return false;
+  }
 
-    while (subPath.SizeInBytes() > 2)
+  uint IgnoreList::FindPathTrieChild(uint node, const char* component, uint length) const
+  {
+    for (uint child = mPathTrie[node].mFirstChild; child != (uint)-1; child = mPathTrie[child].mNextSibling)
     {
-      if (mDirectories.Contains(relativeDir))
-        return true;
+      const String& childComponent = mPathTrie[child].mComponent;
 
-      subPath.PopBack();
-      subPath = subPath.SubString(subPath.Begin(), subPath.FindLastOf('\\').Begin());
+      if (childComponent.SizeInBytes() == length
+        && std::memcmp(childComponent.c_str(), component, length) == 0)
+      {
+        return child;
+      }
     }
 
-    return false;
+    return (uint)-1;
+  }
+
+  void IgnoreList::Compile(void)
+  {
+    mPathTrie.Clear();
+
+    PathTrieNode& root = mPathTrie.PushBack();
+    root.mFirstChild = (uint)-1;
+    root.mNextSibling = (uint)-1;
+    root.mIgnored = false;
+
+    forRange(const String& directory, mDirectories.All())
+    {
+      uint node = 0;
+
+      ForEachPathComponent(directory.c_str(), directory.c_str() + directory.SizeInBytes(),
+        [&](const char* component, uint length)
+      {
+        uint child = FindPathTrieChild(node, component, length);
+
+        if (child == (uint)-1)
+        {
+          child = mPathTrie.Size();
+
+          PathTrieNode& newNode = mPathTrie.PushBack();
+          newNode.mComponent = String(component, length);
+          newNode.mFirstChild = (uint)-1;
+          newNode.mNextSibling = mPathTrie[node].mFirstChild;
+          newNode.mIgnored = false;
+
+          mPathTrie[node].mFirstChild = child;
+        }
+
+        node = child;
+        return false;
+      });
+
+      // an empty entry would mean everything is ignored, which is never what was meant
+      if (node != 0)
+        mPathTrie[node].mIgnored = true;
+    }
+  }
+
+  bool IgnoreList::DirectoryIsOnIgnoreList(StringParam dir) const
+  {
+    if (mPathTrie.Empty())
+      return false;
+
+    // ignored directories are relative to the doxygen directory
+    const char* begin = dir.c_str();
+    const char* end = begin + dir.SizeInBytes();
+
+    if (!mDoxyPath.Empty() && dir.StartsWith(mDoxyPath))
+      begin += mDoxyPath.SizeInBytes();
+
+    // walk down the trie, any ignored node on the way means we are inside an ignored directory
+    uint node = 0;
+
+    return ForEachPathComponent(begin, end, [&](const char* component, uint length)
+    {
+      node = FindPathTrieChild(node, component, length);
+
+      // stopping the walk without a match
+      if (node == (uint)-1)
+        return true;
+
+      return mPathTrie[node].mIgnored;
+    }) && node != (uint)-1;
   }
 
   bool IgnoreList::NameIsOnIgnoreList(StringParam name) const
@@ -948,6 +1064,8 @@ namespace Zero
 
     va_end(args);
 
+    std::lock_guard<std::mutex> lock(mWriteLock);
+
     printf(msgBuffer);
 
     if (mStarted)
@@ -1067,11 +1185,25 @@ namespace Zero
     return true;
   }
 
+  // looks the namespace up in the doxygen index and only walks the directory if it is not there
+  static String FindNamespaceFile(StringParam doxyPath, StringParam qualifiedName, StringParam fileName)
+  {
+    String indexedFile = DoxygenIndex::Get()->FindNamespace(qualifiedName);
+
+    if (!indexedFile.Empty())
+      return indexedFile;
+
+    return FindFile(doxyPath, fileName);
+  }
+
   bool AttributeLoader::LoadAttributeListsFromDoxygen(StringParam doxyPath)
   {
     FinalizeAttributeFile();
-    // if loading the class file  failed, search for a struct file
-    String fileName = FindFile(doxyPath, "namespace_zero_1_1_object_attributes.xml");
+
+    DoxygenIndex::Get()->Load(doxyPath);
+
+    String fileName = FindNamespaceFile(doxyPath, "Zero::ObjectAttributes",
+      "namespace_zero_1_1_object_attributes.xml");
 
     if (!fileName.Empty())
     {
@@ -1088,7 +1220,8 @@ namespace Zero
       return false;
     }
 
-    fileName = FindFile(doxyPath, "namespace_zero_1_1_function_attributes.xml");
+    fileName = FindNamespaceFile(doxyPath, "Zero::FunctionAttributes",
+      "namespace_zero_1_1_function_attributes.xml");
 
     if (!fileName.Empty())
     {
@@ -1105,7 +1238,8 @@ namespace Zero
       return false;
     }
 
-    fileName = FindFile(doxyPath, "namespace_zero_1_1_property_attributes.xml");
+    fileName = FindNamespaceFile(doxyPath, "Zero::PropertyAttributes",
+      "namespace_zero_1_1_property_attributes.xml");
 
     if (!fileName.Empty())
     {
@@ -1206,16 +1340,141 @@ namespace Zero
     return newClass;
   }
 
+  void RawDocumentationLibrary::RemoveClass(RawClassDoc* classDoc)
+  {
+    for (uint i = 0; i < mClasses.Size(); ++i)
+    {
+      if (mClasses[i] == classDoc)
+      {
+        mClasses.EraseAt(i);
+        break;
+      }
+    }
+
+    // the class is mapped by its name when added and by its namespaced name once built
+    if (mClassMap.FindValue(classDoc->mName, nullptr) == classDoc)
+      mClassMap.Erase(classDoc->mName);
+
+    String mapKey = classDoc->GenerateMapKey();
+
+    if (mClassMap.FindValue(mapKey, nullptr) == classDoc)
+      mClassMap.Erase(mapKey);
+
+    for (uint i = 0; i < mEventScanQueue.Size(); ++i)
+    {
+      if (mEventScanQueue[i] == classDoc)
+      {
+        mEventScanQueue.EraseAt(i);
+        break;
+      }
+    }
+
+    MacroDatabase::GetInstance()->RemoveMacroCallsFromClass(classDoc);
+
+    delete classDoc;
+  }
+
+  RawClassDoc* RawDocumentationLibrary::LoadSingleClass(StringParam className,
+    StringParam doxyPath, StringParam xmlPath)
+  {
+    if (mClassMap.ContainsKey(className) || mIgnoreList.NameIsOnIgnoreList(className))
+      return nullptr;
+
+    // same steps the skeleton load takes for every class
+    if (mSkeleton)
+    {
+      ClassDoc* skeletonClass = mSkeleton->mClassMap.FindValue(className, nullptr);
+
+      if (!skeletonClass)
+        return nullptr;
+
+      return LoadSkeletonClass(doxyPath, *skeletonClass);
+    }
+
+    // same steps LoadFromDoxygenDirectory takes for every class file
+    TiXmlDocument doc;
+
+    if (xmlPath.Empty() || !doc.LoadFile(xmlPath.c_str()))
+    {
+      WriteLog("Error: unable to load class '%s' from doxygen file: '%s'\n",
+        className.c_str(), xmlPath.c_str());
+      return nullptr;
+    }
+
+    RawClassDoc* newClass = AddNewClass(className);
+
+    newClass->LoadFromXmlDoc(&doc, doxyPath, xmlPath);
+
+    return newClass;
+  }
+
+  void RawDocumentationLibrary::BuildAddedClasses(Array<RawClassDoc*>& classes)
+  {
+    forRange(RawClassDoc* classDoc, classes.All())
+    {
+      classDoc->Build();
+      mClassMap[classDoc->GenerateMapKey()] = classDoc;
+    }
+    Zero::Sort(mClasses.All(), DocComparePtrFn<RawClassDoc* >);
+  }
+
+  void RawDocumentationLibrary::RefillTrimmedClasses(DocumentationLibrary &trimLib,
+    const HashSet<String>& classNames)
+  {
+    // throw out the stale trimmed docs first
+    for (uint i = 0; i < trimLib.mClasses.Size();)
+    {
+      ClassDoc* trimClass = trimLib.mClasses[i];
+
+      if (!classNames.Contains(trimClass->mName))
+      {
+        ++i;
+        continue;
+      }
+
+      trimLib.mClassMap.Erase(trimClass->mName);
+      trimLib.mClasses.EraseAt(i);
+      delete trimClass;
+    }
+
+    forRange(const String& className, classNames.All())
+    {
+      RawClassDoc* rawClass = mClassMap.FindValue(className, nullptr);
+
+      if (!rawClass)
+        continue;
+
+      ClassDoc* newClass = new ClassDoc();
+      rawClass->FillTrimmedClass(newClass);
+
+      trimLib.mClasses.PushBack(newClass);
+      trimLib.mClassMap[newClass->mName] = newClass;
+    }
+
+    // puts the classes back in order and rebuilds the lookups of the new ones
+    trimLib.FinalizeDocumentation();
+  }
+
   void RawDocumentationLibrary::FillTrimmedDocumentation(DocumentationLibrary &trimLib)
   {
     trimLib.mEnums = mEnums;
     trimLib.mFlags = mFlags;
-    for (uint i = 0; i < mClasses.Size(); ++i)
+
+    // every class only touches its own raw doc and the trimmed doc it creates,
+    // so fill them in parallel and merge them in class order afterwards
+    Array<ClassDoc*> trimmedClasses;
+    trimmedClasses.Resize(mClasses.Size(), nullptr);
+
+    DocTaskPool::Get()->ParallelFor(mClasses.Size(), [&](uint i)
     {
       ClassDoc* newClass = new ClassDoc();
-      trimLib.mClasses.PushBack(newClass);
       mClasses[i]->FillTrimmedClass(newClass);
+      trimmedClasses[i] = newClass;
+    });
 
+    forRange(ClassDoc* newClass, trimmedClasses.All())
+    {
+      trimLib.mClasses.PushBack(newClass);
       trimLib.mClassMap[newClass->mName] = newClass;
     }
   }
@@ -1229,51 +1488,64 @@ namespace Zero
     WriteLog("writing raw documentation library to directory: %s\n\n", directory.c_str());
     forRange(RawClassDoc* classDoc, mClasses.All())
     {
-      String absOutputPath = BuildString(directory, classDoc->mRelativePath);
+      if (GenerateClassDocumentationFile(directory, classDoc))
+        mClassPaths.PushBack(classDoc->mRelativePath);
+    }
 
-      // if we have no classpath that means the class was never loaded to begin with
-      if (classDoc->mRelativePath == "")
-      {
-        if (classDoc->mLibrary == "Core")
-        {
-          classDoc->mRelativePath = BuildString("\\BaseZilchTypes\\", classDoc->mName, ".data");
-        }
-        else
-        {
-          WriteLog("empty Class found by the name of: %s\n", classDoc->mName.c_str());
-          continue;
-        }
-      }
+    SaveLibraryDataFile(directory);
+  }
 
-      StringRange path = 
-        absOutputPath.SubString(absOutputPath.Begin(), absOutputPath.FindLastOf('\\').Begin());
+  bool RawDocumentationLibrary::SaveLibraryDataFile(StringParam directory)
+  {
+    String docLibFile = BuildString(directory, "\\", "Library", ".data");
+    //SaveToFile
+    if (!SaveToFile(docLibFile))
+    {
+      WriteLog("failed to write library data file at: %s\n", docLibFile.c_str());
+      Error("failed to write library data file at: %s\n", docLibFile.c_str());
+      return false;
+    }
 
-      if (!DirectoryExists(path))
+    printf("done writing raw documentation library\n");
+    return true;
+  }
+
+  bool RawDocumentationLibrary::GenerateClassDocumentationFile(StringParam directory,
+    RawClassDoc* classDoc)
+  {
+    // if we have no classpath that means the class was never loaded to begin with
+    if (classDoc->mRelativePath == "")
+    {
+      if (classDoc->mLibrary == "Core")
       {
-        CreateDirectoryAndParents(path);
+        classDoc->mRelativePath = BuildString("\\BaseZilchTypes\\", classDoc->mName, ".data");
       }
-
-      // save class to file by the classes name, check return for fail print output
-      if (!classDoc->SaveToFile(absOutputPath))
+      else
       {
-        WriteLog("failed to write raw class data file at: %s\n", absOutputPath.c_str());
-        Error("failed to write documentation to file at: %s\n", absOutputPath.c_str());
-        continue;
+        WriteLog("empty Class found by the name of: %s\n", classDoc->mName.c_str());
+        return false;
       }
+    }
+
+    String absOutputPath = BuildString(directory, classDoc->mRelativePath);
+
+    StringRange path = 
+      absOutputPath.SubString(absOutputPath.Begin(), absOutputPath.FindLastOf('\\').Begin());
 
-      mClassPaths.PushBack(classDoc->mRelativePath);
+    if (!DirectoryExists(path))
+    {
+      CreateDirectoryAndParents(path);
     }
 
-    String docLibFile = BuildString(directory, "\\", "Library", ".data");
-    //SaveToFile
-    if (!SaveToFile(docLibFile))
+    // save class to file by the classes name, check return for fail print output
+    if (!classDoc->SaveToFile(absOutputPath))
     {
-      WriteLog("failed to write library data file at: %s\n", docLibFile.c_str());
-      Error("failed to write library data file at: %s\n", docLibFile.c_str());
-      return;
+      WriteLog("failed to write raw class data file at: %s\n", absOutputPath.c_str());
+      Error("failed to write documentation to file at: %s\n", absOutputPath.c_str());
+      return false;
     }
 
-    printf("done writing raw documentation library\n");
+    return true;
   }
 
   void RawDocumentationLibrary::FillOverloadDescriptions(void)
@@ -1320,10 +1592,11 @@ namespace Zero
 
   void RawDocumentationLibrary::NormalizeAllTypes(RawTypedefLibrary* defLib)
   {
-    forRange(RawClassDoc* classDoc, mClasses.All())
+    // classes only read from the typedef library so they can all be normalized at once
+    DocTaskPool::Get()->ParallelFor(mClasses.Size(), [&](uint i)
     {
-      classDoc->NormalizeAllTypes(defLib);
-    }
+      mClasses[i]->NormalizeAllTypes(defLib);
+    });
   }
 
   void RawDocumentationLibrary::LoadZilchTypeCppClassList(StringParam absPath)
@@ -1368,22 +1641,13 @@ namespace Zero
 
   bool RawDocumentationLibrary::SaveToFile(StringParam absPath)
   {
-    Status status;
-
     TextSaver saver;
-    saver.Open(status, absPath.c_str());
-
-    if (status.Failed())
-    {
-      Error(status.Message.c_str());
-      return false;
-    }
+    saver.OpenBuffer();
 
     saver.StartPolymorphic("Doc");
     saver.SerializeField("RawDocumentationLibrary", *this);
 
-    saver.Close();
-    return true;
+    return DocOutputSink::Get()->WriteSaver(absPath, saver);
   }
 
   bool RawDocumentationLibrary::LoadFromDocumentationDirectory(StringParam directory)
@@ -1416,7 +1680,11 @@ namespace Zero
       {
         mClasses.PopBack();
         delete newClass;
+        continue;
       }
+
+      // saved classes have their macros and events in them already
+      StreamLoadedClass(String(), newClass, MacroDatabase::GetInstance()->mMacroCalls.Size());
     }
 
     Build();
@@ -1432,54 +1700,58 @@ namespace Zero
 
     MacroDatabase::GetInstance()->mDoxyPath = doxyPath;
 
+    DoxygenIndex::Get()->Load(doxyPath);
+
     Array<String> classFilepaths;
 
     GetFilesWithPartialName(doxyPath, "class_", mIgnoreList, &classFilepaths);
     GetFilesWithPartialName(doxyPath, "struct_", mIgnoreList, &classFilepaths);
 
-    // for each filepath
-    for (uint i = 0; i < classFilepaths.Size(); ++i)
+    // files are read and parsed ahead on other threads, classes are still added in file order
+    DoxygenPipeline pipeline;
+    pipeline.Run(classFilepaths, [&](uint i, StringParam filepath, TiXmlDocument* doc)
     {
-      String& filepath = classFilepaths[i];
-
-      // open the doxy file
-      TiXmlDocument doc;
-      if (!doc.LoadFile(filepath.c_str()))
-      {
-        WriteLog("ERROR: unable to load file at: %s\n", filepath.c_str());
-
-        continue;
-      }
+      if (!doc)
+        return;
 
       // get the class name
-      TiXmlElement* compoundName = doc.FirstChildElement(gElementTags[eDOXYGEN])
+      TiXmlElement* compoundName = doc->FirstChildElement(gElementTags[eDOXYGEN])
         ->FirstChildElement(gElementTags[eCOMPOUNDDEF])->FirstChildElement("compoundname");
 
       String className = GetTextFromAllChildrenNodesRecursively(compoundName);
 
       if (mIgnoreList.NameIsOnIgnoreList(className))
       {
-        continue;
+        return;
       }
 
       TypeTokens tokens;
 
-      AppendTokensFromString(DocLangDfa::Get(), className, &tokens);
+      TokenCache::Get()->Append(className, &tokens);
 
       className = tokens.Back().mText;
       
+      uint firstMacroCall = MacroDatabase::GetInstance()->mMacroCalls.Size();
+
       RawClassDoc* newClass = AddNewClass(className);
 
-      newClass->LoadFromXmlDoc(&doc, doxyPath, classFilepaths[i]);
-    }
+      newClass->LoadFromXmlDoc(doc, doxyPath, filepath);
+
+      StreamLoadedClass(doxyPath, newClass, firstMacroCall);
+    });
 
-    if (mClasses.Size() != 0)
+    LoadEventsForQueuedClasses(doxyPath);
+
+    if (mClasses.Size() != 0 || (mTrimStream && mTrimStream->HasClasses()))
     {
       printf("\n...Done Loading Classes from Doxygen Class XML Files\n\n");
       printf("\nExpanding and parsing any macros found in Doxygen XML Files...\n\n");
       MacroDatabase::GetInstance()->ProcessMacroCalls();
       printf("\n...Done processing macros found in Doxygen XML Files\n\n");
 
+      // every scan is done so the flattened listings are no longer needed
+      FlattenedSourceCache::Get()->Clear();
+
       return true;
     }
     return false;
@@ -1496,166 +1768,176 @@ namespace Zero
 
     GetFilesWithPartialName(justSystems, "namespace", mIgnoreList, &namespaceFilepaths);
 
-    forRange(String& filepath, namespaceFilepaths.All())
+    // every namespace file is read and parsed ahead on other threads
+    DoxygenPipeline pipeline;
+    pipeline.Run(namespaceFilepaths, [&](uint i, StringParam filepath, TiXmlDocument* doc)
     {
-      // load the file
-      TiXmlDocument macroFile;
-
-      if (!macroFile.LoadFile(filepath.c_str()))
-      {
-        Error("unable to load file '%s", filepath.c_str());
-      }
+      if (!doc)
+        return;
 
+      // get doxygen node
+      // get compounddef node
+      TiXmlElement* namespaceDef = doc->FirstChildElement(gElementTags[eDOXYGEN])
+        ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
 
-      // for each filepath
-      forRange(String& filename, namespaceFilepaths.All())
-      {
-        // open the doxy file
-        TiXmlDocument doc;
-        if (!doc.LoadFile(filename.c_str()))
-        {
-          // print error on failure to load
-          WriteLog("ERROR: unable to load file at: %s\n", filename.c_str());
-          continue;
-        }
+      TiXmlNode* firstSectDef = GetFirstNodeOfChildType(namespaceDef, gElementTags[eSECTIONDEF]);
+      TiXmlNode* endSectDef = GetEndNodeOfChildType(namespaceDef, gElementTags[eSECTIONDEF]);
 
-        // get doxygen node
-        // get compounddef node
-        TiXmlElement* namespaceDef = doc.FirstChildElement(gElementTags[eDOXYGEN])
-          ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
+      TiXmlElement* funcSection = nullptr;
 
-        TiXmlNode* firstSectDef = GetFirstNodeOfChildType(namespaceDef, gElementTags[eSECTIONDEF]);
-        TiXmlNode* endSectDef = GetEndNodeOfChildType(namespaceDef, gElementTags[eSECTIONDEF]);
+      // find the function section
+      for (TiXmlNode* node = firstSectDef; node != endSectDef; node = node->NextSibling())
+      {
+        TiXmlElement* element = node->ToElement();
 
-        TiXmlElement* funcSection = nullptr;
+        // kind is always first attribute for sections
+        TiXmlAttribute* attrib = element->FirstAttribute();
 
-        // find the function section
-        for (TiXmlNode* node = firstSectDef; node != endSectDef; node = node->NextSibling())
+        if (attrib && strcmp(attrib->Value(), "func") == 0)
         {
-          TiXmlElement* element = node->ToElement();
+          funcSection = element;
+          break;
+        }
+      }
+      // now that we find the function section, look for function with "DeclareEnum"
+      if (!funcSection)
+        return;
 
-          // kind is always first attribute for sections
-          TiXmlAttribute* attrib = element->FirstAttribute();
+      // for each function
+      for (TiXmlNode* funcNode = funcSection->FirstChild();
+        funcNode != nullptr; funcNode = funcNode->NextSibling())
+      {
+        TiXmlElement* funcAsElement = funcNode->ToElement();
 
-          if (attrib && strcmp(attrib->Value(), "func") == 0)
-          {
-            funcSection = element;
-            break;
-          }
-        }
-        // now that we find the function section, look for function with "DeclareEnum"
-        if (!funcSection)
-          continue;
+        TiXmlNode* fnNameNode = GetFirstNodeOfChildType(funcAsElement, gElementTags[eNAME]);
 
-        // for each function
-        for (TiXmlNode* funcNode = funcSection->FirstChild();
-          funcNode != nullptr; funcNode = funcNode->NextSibling())
+        if (fnNameNode)
         {
-          TiXmlElement* funcAsElement = funcNode->ToElement();
+          String functionName = fnNameNode->FirstChild()->Value();
 
-          TiXmlNode* fnNameNode = GetFirstNodeOfChildType(funcAsElement, gElementTags[eNAME]);
-
-          if (fnNameNode)
+          if (functionName.Contains("DeclareEnum") || functionName.Contains("DeclareBitfield"))
           {
-            String functionName = fnNameNode->FirstChild()->Value();
+            // get the first param because it should have the enum/bitfield's name
+            // paramNode->typenode->textnode->value
+            String enumName = GetFirstNodeOfChildType(funcAsElement, gElementTags[ePARAM])
+              ->FirstChild()->FirstChild()->Value();
 
-            if (functionName.Contains("DeclareEnum") || functionName.Contains("DeclareBitfield"))
+            if (!mEnumAndFlagMap.ContainsKey(enumName))
             {
-              // get the first param because it should have the enum/bitfield's name
-              // paramNode->typenode->textnode->value
-              String enumName = GetFirstNodeOfChildType(funcAsElement, gElementTags[ePARAM])
-                ->FirstChild()->FirstChild()->Value();
-
-              if (!mEnumAndFlagMap.ContainsKey(enumName))
-              {
-                continue;
-              }
+              continue;
+            }
 
-              EnumDoc* enumDocToFill = mEnumAndFlagMap[enumName];
+            EnumDoc* enumDocToFill = mEnumAndFlagMap[enumName];
 
-              // get the description
-              TiXmlNode* descNode = GetFirstNodeOfChildType(funcAsElement, gElementTags[eBRIEFDESCRIPTION]);
+            // get the description
+            TiXmlNode* descNode = GetFirstNodeOfChildType(funcAsElement, gElementTags[eBRIEFDESCRIPTION]);
 
-              if (!descNode || !descNode->FirstChild())
-              {
-                continue;
-              }
+            if (!descNode || !descNode->FirstChild())
+            {
+              continue;
+            }
 
-              // now we see if there is a brief description to load
-              StringBuilder descriptionBuilder;
+            // now we see if there is a brief description to load
+            StringBuilder descriptionBuilder;
 
-              TiXmlNode* descIterNode;
+            TiXmlNode* descIterNode;
 
-              for (descIterNode = descNode->FirstChild()->FirstChild();
-                descIterNode != nullptr && strcmp(descIterNode->Value(),"parameterlist") != 0;
-                descIterNode = descIterNode->NextSibling())
+            for (descIterNode = descNode->FirstChild()->FirstChild();
+              descIterNode != nullptr && strcmp(descIterNode->Value(),"parameterlist") != 0;
+              descIterNode = descIterNode->NextSibling())
+            {
+              String nodeVal = descIterNode->Value();
+              if (nodeVal == "ref")
               {
-                String nodeVal = descIterNode->Value();
-                if (nodeVal == "ref")
-                {
-                  descriptionBuilder << " " << descIterNode->FirstChild()->Value() << " ";
-                }
-                else
-                {
-                  descriptionBuilder << descIterNode->Value();
-                }
+                descriptionBuilder << " " << descIterNode->FirstChild()->Value() << " ";
+              }
+              else
+              {
+                descriptionBuilder << descIterNode->Value();
               }
+            }
 
-              String description = descriptionBuilder.ToString();
+            String description = descriptionBuilder.ToString();
 
-              if (description.Empty() || description == "para")
-                continue;
+            if (description.Empty() || description == "para")
+              continue;
 
-              enumDocToFill->mDescription = description.Trim();
+            enumDocToFill->mDescription = description.Trim();
 
-              const String paramNameList = "paramnamelist";
-              const String parameterDescription = "parameterdescription";
+            const String paramNameList = "paramnamelist";
+            const String parameterDescription = "parameterdescription";
 
-              //accessing: para->text->paramList
-              TiXmlNode* paramList = descIterNode;
+            //accessing: para->text->paramList
+            TiXmlNode* paramList = descIterNode;
 
-              if (!paramList || String("parameterlist") != paramList->Value())
-                continue;
+            if (!paramList || String("parameterlist") != paramList->Value())
+              continue;
 
-              //Node Structure:
-              //para
-              //  parameterlist
-              //    parameteritem
-              //      paramnamelist
-              //        paramname (child actually has name text)
-              //      parameterdescription
-              //       para (Child contains actual description)
+            //Node Structure:
+            //para
+            //  parameterlist
+            //    parameteritem
+            //      paramnamelist
+            //        paramname (child actually has name text)
+            //      parameterdescription
+            //       para (Child contains actual description)
 
-              // loop over every parameter item
-              for(TiXmlNode* node = paramList->FirstChild(); 
-                node != nullptr; node = node->NextSibling())
-              {
-                // paramnamelist->paramname->text
-                String value = node->FirstChild()->FirstChild()->FirstChild()->Value();
+            // loop over every parameter item
+            for(TiXmlNode* node = paramList->FirstChild(); 
+              node != nullptr; node = node->NextSibling())
+            {
+              // paramnamelist->paramname->text
+              String value = node->FirstChild()->FirstChild()->FirstChild()->Value();
 
-                if (enumDocToFill->mEnumValues.Contains(value))
-                {
-                  String valDescription = GetTextFromAllChildrenNodesRecursively(node->FirstChild()->NextSibling()->FirstChild()).Trim();
-                  //accessing paramnamelist->paramdescript->para->text
-                  enumDocToFill->mEnumValues.InsertOrAssign(value, valDescription);
-                }
+              if (enumDocToFill->mEnumValues.Contains(value))
+              {
+                String valDescription = GetTextFromAllChildrenNodesRecursively(node->FirstChild()->NextSibling()->FirstChild()).Trim();
+                //accessing paramnamelist->paramdescript->para->text
+                enumDocToFill->mEnumValues.InsertOrAssign(value, valDescription);
               }
             }
           }
         }
       }
-    }
+    });
   }
 
-  bool RawDocumentationLibrary::LoadFromSkeletonFile(StringParam doxyPath,
-    const DocumentationLibrary &library)
+  bool RawDocumentationLibrary::LoadFromSkeletonStream(StringParam doxyPath,
+    StringParam skeletonFile, DocumentationLibrary &skeleton)
   {
     MacroDatabase *macroDb = MacroDatabase::GetInstance();
 
     macroDb->mDoxyPath = doxyPath;
 
-    mEnums = library.mEnums;
-    mFlags = library.mFlags;
+    SkeletonStream stream;
+    if (!stream.Start(skeletonFile))
+      return stream.Finish(skeleton);
+
+    // the index loads while the first classes are being read
+    DoxygenIndex::Get()->Load(doxyPath);
+
+    // every class is loaded from doxygen as soon as the skeleton hands it out
+    while (ClassDoc* classDoc = stream.NextClass())
+    {
+      skeleton.mClasses.PushBack(classDoc);
+
+      uint firstMacroCall = macroDb->mMacroCalls.Size();
+
+      if (RawClassDoc* newClass = LoadSkeletonClass(doxyPath, *classDoc))
+        StreamLoadedClass(doxyPath, newClass, firstMacroCall);
+    }
+
+    bool loaded = stream.Finish(skeleton);
+
+    skeleton.FinalizeDocumentation();
+    mSkeleton = &skeleton;
+
+    // the skeleton's enums only arrive after its classes. They win over any enum of the same
+    // name a class file added in the meantime, exactly as if they had been registered first
+    Array<EnumDoc*> doxygenEnums = mEnums;
+    mEnums = skeleton.mEnums;
+    mFlags = skeleton.mFlags;
+    mEnumAndFlagMap.Clear();
 
     forRange(EnumDoc* enumDoc, mEnums.All())
     {
@@ -1665,35 +1947,77 @@ namespace Zero
     {
       mEnumAndFlagMap[flagDoc->mName] = flagDoc;
     }
-    // first add all the classes by name to the library
-    forRange(ClassDoc* classDoc, library.mClasses.All())
+    forRange(EnumDoc* enumDoc, doxygenEnums.All())
     {
-      String& name = classDoc->mName;
-      // if we have already documented this, skip it
-      if (mClassMap.ContainsKey(name)
-        || mIgnoreList.NameIsOnIgnoreList(name)
-        || mBlacklist.isOnBlacklist(name)
-        || mBlacklist.isOnBlacklist(classDoc->mBaseClass))
+      if (mEnumAndFlagMap.ContainsKey(enumDoc->mName))
+      {
+        delete enumDoc;
         continue;
+      }
+
+      mEnums.PushBack(enumDoc);
+      mEnumAndFlagMap[enumDoc->mName] = enumDoc;
+    }
+
+    FinishSkeletonLoad(doxyPath);
+    return loaded;
+  }
 
-      RawClassDoc *newClassDoc = AddNewClass(name);
+  void RawDocumentationLibrary::StreamLoadedClass(StringParam doxyPath, RawClassDoc* classDoc,
+    uint firstMacroCall)
+  {
+    if (mTrimStream == nullptr)
+      return;
 
-      newClassDoc->LoadFromSkeleton(*classDoc);
+    // the calls were only made by this class and point at it, so they go once expanded
+    MacroDatabase* macroDb = MacroDatabase::GetInstance();
+    macroDb->ProcessMacroCalls(firstMacroCall);
+    macroDb->mMacroCalls.Resize(firstMacroCall);
 
-      if (newClassDoc->mImportDocumentation)
-        newClassDoc->LoadFromDoxygen(doxyPath);
+    // the queue only holds this class, if it initializes meta
+    LoadEventsForQueuedClasses(doxyPath);
 
-      // if we are a tool, load our xml description for commands
-      newClassDoc->LoadToolXmlInClassDescIfItExists();
-    }
+    mTrimStream->Add(*this, classDoc);
+  }
+
+  RawClassDoc* RawDocumentationLibrary::LoadSkeletonClass(StringParam doxyPath, const ClassDoc &classDoc)
+  {
+    const String& name = classDoc.mName;
+    // if we have already documented this, skip it
+    if (mClassMap.ContainsKey(name)
+      || (mTrimStream && mTrimStream->WasTrimmed(name))
+      || mIgnoreList.NameIsOnIgnoreList(name)
+      || mBlacklist.isOnBlacklist(name)
+      || mBlacklist.isOnBlacklist(classDoc.mBaseClass))
+      return nullptr;
+
+    RawClassDoc *newClassDoc = AddNewClass(name);
+
+    newClassDoc->LoadFromSkeleton(classDoc);
 
-    if (mClasses.Size() != 0)
+    if (newClassDoc->mImportDocumentation)
+      newClassDoc->LoadFromDoxygen(doxyPath);
+
+    // if we are a tool, load our xml description for commands
+    newClassDoc->LoadToolXmlInClassDescIfItExists();
+
+    return newClassDoc;
+  }
+
+  bool RawDocumentationLibrary::FinishSkeletonLoad(StringParam doxyPath)
+  {
+    LoadEventsForQueuedClasses(doxyPath);
+
+    if (mClasses.Size() != 0 || (mTrimStream && mTrimStream->HasClasses()))
     {
       printf("\n...Done Loading Classes from Doxygen Class XML Files\n\n");
       printf("\nExpanding and parsing any macros found in Doxygen XML Files...\n\n");
       MacroDatabase::GetInstance()->ProcessMacroCalls();
       printf("\n...Done processing macros found in Doxygen XML Files\n\n");
 
+      // every scan is done so the flattened listings are no longer needed
+      FlattenedSourceCache::Get()->Clear();
+
       return true;
     }
     return false;
@@ -1735,41 +2059,102 @@ namespace Zero
     mEvents.Sort();
     CreateDirectoryAndParents(absPath.SubString(absPath.Begin(), absPath.FindLastOf('\\').Begin()));
 
-    Status status;
-
     TextSaver saver;
 
-    saver.Open(status, absPath.c_str());
-
-    if (status.Failed())
-    {
-      Error("Failed to open file to save raw events list at location : %s\n", absPath.c_str());
-      WriteLog("Failed to open file to save raw events list at location : %s\n", absPath.c_str());
-      return;
-    }
+    saver.OpenBuffer();
 
     saver.StartPolymorphic("Doc");
     saver.SerializeField("EventDocList", mEvents);
     saver.EndPolymorphic();
-    saver.Close();
+
+    if (!DocOutputSink::Get()->WriteSaver(absPath, saver))
+      WriteLog("Failed to save raw events list at location : %s\n", absPath.c_str());
   }
 
   RawClassDoc *RawDocumentationLibrary::GetClassByName(StringParam name,Array<String> &namespaces)
   {
-    if (mClassMap.ContainsKey(name))
-      return mClassMap[name];
+    // only reads the map since this gets called from the parallel event scans
+    RawClassDoc* classDoc = mClassMap.FindValue(name, nullptr);
+
+    if (classDoc)
+      return classDoc;
 
     forRange(String& nameSpace, namespaces.All())
     {
       String newKey = BuildString(nameSpace, name);
 
-      if (mClassMap.ContainsKey(newKey))
-        return mClassMap[newKey];
+      classDoc = mClassMap.FindValue(newKey, nullptr);
+
+      if (classDoc)
+        return classDoc;
 
     }
     return nullptr;
   }
 
+  void RawDocumentationLibrary::LoadEventsForQueuedClasses(StringParam doxyPath)
+  {
+    // group the classes by the source listing they are implemented in, in queue order
+    Array<String> sourcePaths;
+    Array<Array<RawClassDoc*> > sourceClasses;
+    HashMap<String, uint> sourceIndices;
+
+    forRange(RawClassDoc* classDoc, mEventScanQueue.All())
+    {
+      String path = classDoc->GetBodySourcePath(doxyPath);
+
+      if (path.Empty())
+        continue;
+
+      uint index = sourceIndices.FindValue(path, (uint)-1);
+
+      if (index == (uint)-1)
+      {
+        index = sourcePaths.Size();
+        sourceIndices[path] = index;
+        sourcePaths.PushBack(path);
+        sourceClasses.PushBack();
+      }
+
+      sourceClasses[index].PushBack(classDoc);
+    }
+
+    mEventScanQueue.Clear();
+
+    Array<Array<EventReference> > references;
+    references.Resize(sourcePaths.Size());
+
+    DocTaskPool::Get()->ParallelFor(sourcePaths.Size(), [&](uint i)
+    {
+      // the cache logs if the file fails to load
+      FlattenedSource* source = FlattenedSourceCache::Get()->GetSource(sourcePaths[i]);
+
+      if (source == nullptr)
+        return;
+
+      FindEventReferencesInSource(source, mEvents, &references[i]);
+
+      // exceptions only ever get added to the class doing the scan so those can stay in here
+      forRange(RawClassDoc* classDoc, sourceClasses[i].All())
+      {
+        classDoc->ParseFnCodelinesInDoc(source);
+      }
+    });
+
+    // every file can reference the same events, so the event docs are only touched here.
+    // Senders and listeners are only appended, each event is sorted once after everything
+    for (uint i = 0; i < sourcePaths.Size(); ++i)
+    {
+      forRange(RawClassDoc* classDoc, sourceClasses[i].All())
+      {
+        classDoc->AddEventReferences(references[i]);
+        classDoc->SortAndPruneEventArray();
+      }
+    }
+
+    SortAndPruneEventReferences();
+  }
+
   ////////////////////////////////////////////////////////////////////////
   // RawVariableDoc
   ////////////////////////////////////////////////////////////////////////
@@ -1795,8 +2180,7 @@ namespace Zero
     }
 
     // get the description and clean up spaces
-    String description = DoxyToString(element, gElementTags[eBRIEFDESCRIPTION]).Trim();
-    description = CleanRedundantSpacesInDesc(description);
+    String description = DoxyToDescription(element, gElementTags[eBRIEFDESCRIPTION]);
 
     if (!description.Empty())
       mDescription = description;
@@ -1809,7 +2193,7 @@ namespace Zero
 
       String retTypeString = retTypeStr.ToString();
 
-      AppendTokensFromString(DocLangDfa::Get(), retTypeString, mTokens);
+      TokenCache::Get()->Append(retTypeString, mTokens);
     }
   }
 
@@ -1847,16 +2231,9 @@ namespace Zero
 
   bool RawShortcutLibrary::SaveToFile(StringParam absPath)
   {
-    Status status;
-
     TextSaver saver;
 
-    saver.Open(status, absPath.c_str());
-    if (status.Failed())
-    {
-      Error(status.Message.c_str());
-      return false;
-    }
+    saver.OpenBuffer();
 
     saver.StartPolymorphic("Shortcuts");
 
@@ -1885,9 +2262,7 @@ namespace Zero
 
     saver.EndPolymorphic();
 
-    saver.Close();
-
-    return true;
+    return DocOutputSink::Get()->WriteSaver(absPath, saver);
   }
   
   void RawShortcutLibrary::InsertClassShortcuts(StringParam className, ClassShortcuts* shortcuts)
@@ -1923,7 +2298,7 @@ namespace Zero
     String defString = definitionNode->ToElement()->GetText();
 
     // lets send this down the tokenizer like an adult instead of what we were doing
-    AppendTokensFromString(DocLangDfa::Get(), defString, &mDefinition);
+    TokenCache::Get()->Append(defString, &mDefinition);
 
     // get rid of the first token that just says 'typedef'
     mDefinition.PopFront();
@@ -2119,7 +2494,7 @@ namespace Zero
       newMethod->mStatic = meth->mStatic;
 
       newMethod->mReturnTokens = new TypeTokens();
-      AppendTokensFromString(DocLangDfa::Get(), meth->mReturnType, newMethod->mReturnTokens);
+      TokenCache::Get()->Append(meth->mReturnType, newMethod->mReturnTokens);
 
       uint paramIndex = 0;
       forRange(ParameterDoc* param, meth->mParameterList.All())
@@ -2141,7 +2516,7 @@ namespace Zero
           newParam->mDescription = param->mDescription;
         }
 
-        AppendTokensFromString(DocLangDfa::Get(), param->mType, newParam->mTokens);
+        TokenCache::Get()->Append(param->mType, newParam->mTokens);
 
         newMethod->mParsedParameters.PushBack(newParam);
 
@@ -2226,25 +2601,15 @@ namespace Zero
 
   bool RawClassDoc::SaveToFile(StringParam absPath)
   {
-    Status status;
-
     TextSaver saver;
 
-    saver.Open(status, absPath.c_str());
-    if (status.Failed())
-    {
-      Error(status.Message.c_str());
-      return false;
-    }
-    
+    saver.OpenBuffer();
 
     saver.StartPolymorphic("Doc");
 
     saver.SerializeField("RawClassDoc", *this);
 
-    saver.Close();
-
-    return true;
+    return DocOutputSink::Get()->WriteSaver(absPath, saver);
   }
 
   // we could change this to take a bool whether to override or not
@@ -2509,14 +2874,15 @@ namespace Zero
       }
     }
 
-    LoadEvents(GetDoxygenName(mName), doxyPath);
+    // the library scans every queued class once all of them are loaded
+    mParentLibrary->mEventScanQueue.PushBack(this);
     
     return true;
   }
 
   // param number technically starts at 1 since 0 means no param for this fn
   bool FillEventInformation(StringParam fnTokenName, uint paramNum, bool listeningFn, 
-    EventDocList &libEventList, RawClassDoc *classDoc, TypeTokens &tokens)
+    EventDocList &libEventList, TypeTokens &tokens, Array<EventReference>* output)
   {
     if (tokens.Contains(DocToken(fnTokenName)))
     {
@@ -2535,21 +2901,13 @@ namespace Zero
         // i - 2 because i is currently at 1 past the comma index
         String& eventName = tokens[i - 2].mText;
 
-        EventDoc *eventDoc = nullptr;
+        EventDoc *eventDoc = libEventList.mEventMap.FindValue(eventName, nullptr);
 
-        if (libEventList.mEventMap.ContainsKey(eventName))
+        if (eventDoc != nullptr)
         {
-          eventDoc = libEventList.mEventMap[eventName];
-          if (listeningFn)
-          {
-            eventDoc->mListeners.PushBack(classDoc->mName);
-            classDoc->mEventsListened.PushBack(eventDoc);
-          }
-          else
-          {
-            eventDoc->mSenders.PushBack(classDoc->mName);
-            classDoc->mEventsSent.PushBack(eventDoc);
-          }
+          EventReference& reference = output->PushBack();
+          reference.mEvent = eventDoc;
+          reference.mListening = listeningFn;
           return true;
         }
       }
@@ -2713,55 +3071,74 @@ namespace Zero
     }
   }
 
-  void RawClassDoc::LoadEventsFromCppDoc(TiXmlDocument *doc)
+  void FindEventReferencesInSource(FlattenedSource *source, EventDocList &libEventList,
+    Array<EventReference>* output)
   {
-    ParseCodelinesInDoc(doc, [](RawClassDoc *classDoc, StringParam codeString) 
+    forRange(TypeTokens& tokens, source->mTokens.All())
     {
-      EventDocList &libEventList = classDoc->mParentLibrary->mEvents;
-
-      TypeTokens tokens;
-
-      AppendTokensFromString(DocLangDfa::Get(), codeString, &tokens);
-
       // the next block is all of the send and receive event fns we want to parse
       // if boolean argument is false, it is a send function, otherwise, receive
 
-      if (FillEventInformation("DispatchEvent", 1, false, libEventList, classDoc, tokens))
+      if (FillEventInformation("DispatchEvent", 1, false, libEventList, tokens, output))
       {
       }
       // only found whern we search outside of bound types
-      else if (FillEventInformation("CreateCollisionEvent", 3, false, libEventList, classDoc, tokens))
+      else if (FillEventInformation("CreateCollisionEvent", 3, false, libEventList, tokens, output))
       {
       }
-      else if (FillEventInformation("Dispatch", 1, false, libEventList, classDoc, tokens))
+      else if (FillEventInformation("Dispatch", 1, false, libEventList, tokens, output))
       {
       }
       // SendButtonEvent(event, Events::LockStepGamepadUp, false);
-      else if (FillEventInformation("SendButtonEvent", 2, false, libEventList, classDoc, tokens))
+      else if (FillEventInformation("SendButtonEvent", 2, false, libEventList, tokens, output))
       {
       }
       // mLockStep->QueueSyncedEvent(Events::LockStepKeyUp, &syncedEvent); (sends)
-      else if (FillEventInformation("QueueSyncedEvent", 1, false, libEventList, classDoc, tokens))
+      else if (FillEventInformation("QueueSyncedEvent", 1, false, libEventList, tokens, output))
       {
       }
-      else if (FillEventInformation("Connect", 2, true, libEventList, classDoc, tokens))
+      else if (FillEventInformation("Connect", 2, true, libEventList, tokens, output))
       {
       }
-      else if (FillEventInformation("ConnectThisTo", 2, true, libEventList, classDoc, tokens))
+      else if (FillEventInformation("ConnectThisTo", 2, true, libEventList, tokens, output))
       {
       }
-    });
+    }
   }
 
-  void RawClassDoc::LoadEventsFromHppDoc(TiXmlDocument *doc)
+  void RawClassDoc::LoadEventsFromCppDoc(FlattenedSource *source)
   {
-    ParseCodelinesInDoc(doc, [](RawClassDoc *classDoc, StringParam codeString) {
-      TypeTokens tokens;
+    Array<EventReference> references;
+
+    FindEventReferencesInSource(source, mParentLibrary->mEvents, &references);
+
+    AddEventReferences(references);
+  }
+
+  void RawClassDoc::AddEventReferences(const Array<EventReference>& references)
+  {
+    forRange(const EventReference& reference, references.All())
+    {
+      EventDoc* eventDoc = reference.mEvent;
 
-      if (!codeString.Empty())
+      if (reference.mListening)
       {
-        AppendTokensFromString(DocLangDfa::Get(), codeString, &tokens);
+        eventDoc->mListeners.PushBack(mName);
+        mEventsListened.PushBack(eventDoc);
+      }
+      else
+      {
+        eventDoc->mSenders.PushBack(mName);
+        mEventsSent.PushBack(eventDoc);
+      }
+    }
+  }
 
+  void RawClassDoc::LoadEventsFromHppDoc(FlattenedSource *source)
+  {
+    ParseCodelinesInDoc(source, [](RawClassDoc *classDoc, TypeTokens& tokens) {
+      if (!tokens.Empty())
+      {
         for (uint i = 0; i < tokens.Size(); ++i)
         {
           // if we found the events namespace node, the node two up from here is event
@@ -2781,28 +3158,11 @@ namespace Zero
     });
   }
 
-  void RawClassDoc::ParseCodelinesInDoc(TiXmlDocument *doc, void(*fn)(RawClassDoc *, StringParam))
+  void RawClassDoc::ParseCodelinesInDoc(FlattenedSource *source, void(*fn)(RawClassDoc *, TypeTokens&))
   {
-    // grab the class
-    TiXmlElement* cppDef = doc->FirstChildElement(gElementTags[eDOXYGEN])
-      ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
-
-    TiXmlElement *programList = GetFirstNodeOfChildType(cppDef, "programlisting")->ToElement();
-
-    TiXmlNode *firstCodeline = GetFirstNodeOfChildType(programList, gElementTags[eCODELINE]);
-    TiXmlNode *endCodeline = GetEndNodeOfChildType(programList, gElementTags[eCODELINE]);
-
-    for (TiXmlNode *codeline = firstCodeline;
-      codeline != endCodeline;
-      codeline = codeline->NextSibling())
+    forRange(TypeTokens& tokens, source->mTokens.All())
     {
-      StringBuilder builder;
-
-      GetTextFromAllChildrenNodesRecursively(codeline, &builder);
-
-      String codeString = builder.ToString();
-
-      fn(this, codeString);
+      fn(this, tokens);
     }
   }
 
@@ -2839,22 +3199,8 @@ namespace Zero
     return "";
   }
 
-  void RawClassDoc::ParseFnCodelinesInDoc(TiXmlDocument *doc)
+  void RawClassDoc::ParseFnCodelinesInDoc(FlattenedSource *source)
   {
-    // might want to maintain a static list of files we have already processed so we do
-    // not end up doubling up documentation for classes that are implemented in the same
-    //file.
-    EventDocList &libEventList = mParentLibrary->mEvents;
-
-    // grab the class
-    TiXmlElement* cppDef = doc->FirstChildElement(gElementTags[eDOXYGEN])
-      ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
-
-    TiXmlElement *programList = GetFirstNodeOfChildType(cppDef, "programlisting")->ToElement();
-
-    TiXmlNode *firstCodeline = GetFirstNodeOfChildType(programList, gElementTags[eCODELINE]);
-    TiXmlNode *endCodeline = GetEndNodeOfChildType(programList, gElementTags[eCODELINE]);
-
     String currFn = "";
     RawClassDoc *currClass = this;
 
@@ -2863,22 +3209,9 @@ namespace Zero
     namespaces.PushBack("Zilch");
 
     // the majority of this loop is just getting the current function
-    for (TiXmlNode *codeline = firstCodeline;
-      codeline != endCodeline;
-      codeline = codeline->NextSibling())
+    for (uint line = 0; line < source->GetLineCount(); ++line)
     {
-      StringBuilder builder;
-
-      GetTextFromAllChildrenNodesRecursively(codeline, &builder);
-
-      if (builder.GetSize() <= 0)
-        continue;
-
-      String codeString = builder.ToString();
-
-      TypeTokens tokens;
-
-      AppendTokensFromString(DocLangDfa::Get(), codeString, &tokens);
+      TypeTokens& tokens = source->mTokens[line];
 
       if (tokens.Empty())
         continue;
@@ -2931,31 +3264,40 @@ namespace Zero
 
 
 
+  // expects a sorted list, keeps the first of every run of equal strings
   void RemoveDuplicates(Array<String> &stringList)
   {
-    for (uint i = 1; i < stringList.Size(); ++i)
+    uint keptCount = 0;
+
+    for (uint i = 0; i < stringList.Size(); ++i)
     {
-      // get rid of duplicates
-      if (stringList[i] == stringList[i - 1])
-      {
-        stringList.EraseAt(i);
-        --i;
-      }
+      if (keptCount != 0 && stringList[i] == stringList[keptCount - 1])
+        continue;
+
+      if (keptCount != i)
+        stringList[keptCount] = stringList[i];
+
+      ++keptCount;
     }
 
+    stringList.Resize(keptCount);
   }
 
-  void RawClassDoc::SortAndPruneEventArray(void)
+  void RawDocumentationLibrary::SortAndPruneEventReferences(void)
   {
-    EventDocList &libEventList = mParentLibrary->mEvents;
-
-    for (uint i = 0; i < libEventList.mEvents.Size(); ++i)
+    for (uint i = 0; i < mEvents.mEvents.Size(); ++i)
     {
-      Sort(libEventList.mEvents[i]->mSenders.All());
-      Sort(libEventList.mEvents[i]->mListeners.All());
-      RemoveDuplicates(libEventList.mEvents[i]->mSenders);
-      RemoveDuplicates(libEventList.mEvents[i]->mListeners);
+      EventDoc* eventDoc = mEvents.mEvents[i];
+
+      Sort(eventDoc->mSenders.All());
+      Sort(eventDoc->mListeners.All());
+      RemoveDuplicates(eventDoc->mSenders);
+      RemoveDuplicates(eventDoc->mListeners);
     }
+  }
+
+  void RawClassDoc::SortAndPruneEventArray(void)
+  {
     if (mEvents.Empty())
       return;
 
@@ -3018,33 +3360,21 @@ namespace Zero
     return true;
   }
 
-  bool RawClassDoc::LoadEvents(String doxName, String doxyPath)
+  String RawClassDoc::GetBodySourcePath(StringParam doxyPath)
   {
-    String filename = GetDoxyfileNameFromSourceFileName(mBodyFile);
+    if (mBodyFile.Empty())
+      return String();
 
-    filename = GetFileWithExactName(doxyPath, filename);
+    // the original file says the same as its programlisting without any xml to parse
+    String filename = SourceFileIndex::Get()->FindFile(mBodyFile, mBodyPath);
 
     if (filename.Empty())
-      return false;
-
-    TiXmlDocument cppDoc;
-
-    if (!cppDoc.LoadFile(filename.c_str()))
-    {
-      WriteLog("Failed to load file: %s\n", filename.c_str());
-      // still return true since we did load the class doc
-      return false;
-    }
+      filename = DoxygenIndex::Get()->FindSourceFile(mBodyFile);
 
-    LoadEventsFromCppDoc(&cppDoc);
-
-    ParseFnCodelinesInDoc(&cppDoc);
-
-    // could also load from hpp but it turns out you get everything you need from cpp
-
-    SortAndPruneEventArray();
+    if (filename.Empty())
+      filename = GetFileWithExactName(doxyPath, GetDoxyfileNameFromSourceFileName(mBodyFile));
 
-    return true;
+    return filename;
   }
 
   bool RawClassDoc::LoadFromXmlDoc(TiXmlDocument* doc, StringParam doxyPath,
@@ -3060,10 +3390,8 @@ namespace Zero
       // check if the class Initializes Meta
       if (mMethodMap.ContainsKey("InitializeMeta"))
       {
-        // add path and name to seperatelist of events to find
-        String doxName = GetDoxygenName(mName);
-
-        LoadEvents(doxName, doxyPath);
+        // add to the list of classes the library scans for events once loading is done
+        mParentLibrary->mEventScanQueue.PushBack(this);
       }
 
       return true;
@@ -3089,7 +3417,7 @@ namespace Zero
     String classNamespace = GetTextFromAllChildrenNodesRecursively(compoundName->FirstChild());
 
     TypeTokens namespaceTokens;
-    AppendTokensFromString(DocLangDfa::Get(), classNamespace, &namespaceTokens);
+    TokenCache::Get()->Append(classNamespace, &namespaceTokens);
 
     mNamespace.GetNamesFromTokens(namespaceTokens);
 
@@ -3203,6 +3531,8 @@ namespace Zero
 
                 if (attString)
                 {
+                  SourceFileIndex::Get()->AddFile(attString);
+
                   mHeaderFile = attString;
 
                   // since this path is going to be from doxygen it will have correct slashes
@@ -3216,6 +3546,9 @@ namespace Zero
 
                 if (attString)
                 {
+                  SourceFileIndex::Get()->AddFile(attString);
+
+                  mBodyPath = attString;
                   mBodyFile = attString;
 
                   StringRange pos = mBodyFile.FindLastOf(cDirectorySeparatorChar);
@@ -3323,40 +3656,49 @@ namespace Zero
   bool RawClassDoc::loadDoxyfile(StringParam nameToSearchFor, StringParam doxyPath,
     TiXmlDocument& doc, bool isRecursiveCall)
   {
-    // try to open the class file
-    String fileName = FindFile(doxyPath, BuildString("class_zero_1_1"
-      , GetDoxygenName(nameToSearchFor), ".xml"));
+    DoxygenIndex* index = DoxygenIndex::Get();
 
-    bool loadOkay = doc.LoadFile(fileName.c_str());
+    // doxygen already told us which file every class and struct is in
+    String fileName = index->FindClass(nameToSearchFor);
 
-    if (loadOkay)
+    if (!fileName.Empty() && doc.LoadFile(fileName.c_str()))
       return loadDoxyFileReturnHelper(doxyPath, fileName);
 
-    // try to open a zilch version of the class file name
-    fileName = FindFile(doxyPath, BuildString("class_zilch_1_1"
+    // the index lists everything these guesses could find, so only guess without one
+    if (!index->IsLoaded())
+    {
+      // try to open the class file
+      fileName = FindFile(doxyPath, BuildString("class_zero_1_1"
         , GetDoxygenName(nameToSearchFor), ".xml"));
 
-    loadOkay = doc.LoadFile(fileName.c_str());
-
-    if (loadOkay)
-      return loadDoxyFileReturnHelper(doxyPath, fileName);
+      if (doc.LoadFile(fileName.c_str()))
+        return loadDoxyFileReturnHelper(doxyPath, fileName);
 
-    // if loading the class file  failed, search for a struct file
-    fileName = FindFile(doxyPath, BuildString("struct_zero_1_1"
-      , GetDoxygenName(nameToSearchFor).c_str(), ".xml"));
+      // try to open a zilch version of the class file name
+      fileName = FindFile(doxyPath, BuildString("class_zilch_1_1"
+        , GetDoxygenName(nameToSearchFor), ".xml"));
 
-    loadOkay = doc.LoadFile(fileName.c_str());
+      if (doc.LoadFile(fileName.c_str()))
+        return loadDoxyFileReturnHelper(doxyPath, fileName);
 
-    if (loadOkay)
-      return loadDoxyFileReturnHelper(doxyPath, fileName);
+      // if loading the class file  failed, search for a struct file
+      fileName = FindFile(doxyPath, BuildString("struct_zero_1_1"
+        , GetDoxygenName(nameToSearchFor).c_str(), ".xml"));
 
-     fileName = FindFile(doxyPath, BuildString("struct_zero_1_1_physics_1_1"
-       , GetDoxygenName(nameToSearchFor).c_str(), ".xml"));
+      if (doc.LoadFile(fileName.c_str()))
+        return loadDoxyFileReturnHelper(doxyPath, fileName);
 
-     loadOkay = doc.LoadFile(fileName.c_str());
+      fileName = FindFile(doxyPath, BuildString("struct_zero_1_1_physics_1_1"
+        , GetDoxygenName(nameToSearchFor).c_str(), ".xml"));
 
-     if (loadOkay)
-       return loadDoxyFileReturnHelper(doxyPath, fileName);
+      if (doc.LoadFile(fileName.c_str()))
+        return loadDoxyFileReturnHelper(doxyPath, fileName);
+    }
+    else if (!isRecursiveCall)
+    {
+      WriteLog("%s is not in the doxygen index, falling back to guessing its file\n",
+        nameToSearchFor.c_str());
+    }
 
 
      // check known name differences between zilch and c++ types for file names
@@ -3650,15 +3992,34 @@ namespace Zero
     }
   }
 
+  // takes the brief description of a parameter, or its inbody one if it has no brief. A
+  // description that is already there is only cleaned if the doxygen has neither
+  static void LoadParameterDescription(TiXmlElement* paramElement, String& description)
+  {
+    TiXmlNode* brief = GetFirstNodeOfChildType(paramElement, gElementTags[eBRIEFDESCRIPTION]);
+
+    if (!brief)
+      brief = GetFirstNodeOfChildType(paramElement, "inbodydescription");
+
+    if (brief)
+    {
+      DescriptionBuilder builder;
+      getTextFromParaNodes(brief, &builder);
+      description = builder.ToString();
+    }
+    else
+    {
+      description = CleanRedundantSpacesInDesc(description);
+    }
+  }
+
   RawMethodDoc::RawMethodDoc(TiXmlElement* element, TiXmlNode* currMethod)
   {
     mReturnTokens = new TypeTokens;
 
     mName = GetElementValue(element, gElementTags[eNAME]);
 
-    mDescription = DoxyToString(element, gElementTags[eBRIEFDESCRIPTION]).Trim();
-
-    mDescription = CleanRedundantSpacesInDesc(mDescription);
+    mDescription = DoxyToDescription(element, gElementTags[eBRIEFDESCRIPTION]);
 
     mStatic = false;
 
@@ -3666,7 +4027,7 @@ namespace Zero
 
     BuildFullTypeString(element, &retTypeStr);
 
-    AppendTokensFromString(DocLangDfa::Get(), retTypeStr.ToString(), mReturnTokens);
+    TokenCache::Get()->Append(retTypeStr.ToString(), mReturnTokens);
 
     TiXmlNode* firstElement = GetFirstNodeOfChildType(element, gElementTags[ePARAM]);
 
@@ -3693,30 +4054,10 @@ namespace Zero
       StringBuilder paramName;
       BuildFullTypeString(paramElement, &paramName);
 
-      AppendTokensFromString(DocLangDfa::Get(), paramName.ToString(), parameterDoc->mTokens);
-
-      // get brief description
-      TiXmlNode* brief = GetFirstNodeOfChildType(paramElement, gElementTags[eBRIEFDESCRIPTION]);
+      TokenCache::Get()->Append(paramName.ToString(), parameterDoc->mTokens);
 
-      if (brief)
-      {
-        StringBuilder builder;
-        getTextFromParaNodes(brief, &builder);
-        parameterDoc->mDescription = builder.ToString().Trim();
-      }
-      else
-      {
-        // check for inbody
-        brief = GetFirstNodeOfChildType(paramElement, "inbodydescription");
+      LoadParameterDescription(paramElement, parameterDoc->mDescription);
 
-        if (brief)
-        {
-          StringBuilder builder;
-          getTextFromParaNodes(brief, &builder);
-          parameterDoc->mDescription = builder.ToString().Trim();
-        }
-      }
-      parameterDoc->mDescription = CleanRedundantSpacesInDesc(parameterDoc->mDescription);
       mParsedParameters.PushBack(parameterDoc);
     }
   }
@@ -3724,9 +4065,7 @@ namespace Zero
 
   void RawMethodDoc::LoadFromDoxygen(TiXmlElement* element, TiXmlNode* methodDef)
   {
-    mDescription = DoxyToString(element, gElementTags[eBRIEFDESCRIPTION]).Trim();
-
-    mDescription = CleanRedundantSpacesInDesc(mDescription);
+    mDescription = DoxyToDescription(element, gElementTags[eBRIEFDESCRIPTION]);
 
     TiXmlNode* firstElement = GetFirstNodeOfChildType(element, gElementTags[ePARAM]);
 
@@ -3746,28 +4085,7 @@ namespace Zero
 
       parameterDoc->mName = parName;
 
-      // get brief description
-      TiXmlNode* brief = GetFirstNodeOfChildType(paramElement, gElementTags[eBRIEFDESCRIPTION]);
-
-      if (brief)
-      {
-        StringBuilder builder;
-        getTextFromParaNodes(brief, &builder);
-        parameterDoc->mDescription = builder.ToString().Trim();
-      }
-      else
-      {
-        // check for inbody
-        brief = GetFirstNodeOfChildType(paramElement, "inbodydescription");
-
-        if (brief)
-        {
-          StringBuilder builder;
-          getTextFromParaNodes(brief, &builder);
-          parameterDoc->mDescription = builder.ToString().Trim();
-        }
-      }
-      parameterDoc->mDescription = CleanRedundantSpacesInDesc(parameterDoc->mDescription);
+      LoadParameterDescription(paramElement, parameterDoc->mDescription);
     }
   }
 
@@ -3973,23 +4291,35 @@ namespace Zero
 
     Array<String> namespaceFilepaths;
 
-    GetFilesWithPartialName(doxypath, "namespace_", mIgnoreList, &namespaceFilepaths);
+    DoxygenIndex* index = DoxygenIndex::Get();
+    index->Load(doxypath);
 
-    // for each filepath
-    for (uint i = 0; i < namespaceFilepaths.Size(); ++i)
+    if (index->IsLoaded())
     {
-      // open the doxy file
-      TiXmlDocument doc;
-      if (!doc.LoadFile(namespaceFilepaths[i].c_str()))
+      Array<String> indexedFiles;
+      index->GetFilesOfKind("namespace", &indexedFiles);
+
+      forRange(String& filepath, indexedFiles.All())
       {
-        // print error on failure to load
-        WriteLog("ERROR: unable to load file at: %s\n", namespaceFilepaths[i].c_str());
-        continue;
+        if (!mIgnoreList.DirectoryIsOnIgnoreList(filepath))
+          namespaceFilepaths.PushBack(filepath);
       }
+    }
+    else
+    {
+      GetFilesWithPartialName(doxypath, "namespace_", mIgnoreList, &namespaceFilepaths);
+    }
+
+    // for each filepath, read and parsed ahead on other threads
+    DoxygenPipeline pipeline;
+    pipeline.Run(namespaceFilepaths, [&](uint i, StringParam filepath, TiXmlDocument* doc)
+    {
+      if (!doc)
+        return;
 
       // get doxygen node
       // get compounddef node
-      TiXmlElement* namespaceDef = doc.FirstChildElement(gElementTags[eDOXYGEN])
+      TiXmlElement* namespaceDef = doc->FirstChildElement(gElementTags[eDOXYGEN])
         ->FirstChildElement(gElementTags[eCOMPOUNDDEF]);
 
       // we get the compound name so we can get the namespace for this typedef
@@ -4000,7 +4330,7 @@ namespace Zero
 
       TypeTokens namespaceTokens;
 
-      AppendTokensFromString(DocLangDfa::Get(), namespaceName, &namespaceTokens);
+      TokenCache::Get()->Append(namespaceName, &namespaceTokens);
 
       TiXmlNode* firstSectDef = GetFirstNodeOfChildType(namespaceDef, gElementTags[eSECTIONDEF]);
       TiXmlNode* endSectDef = GetEndNodeOfChildType(namespaceDef, gElementTags[eSECTIONDEF]);
@@ -4024,7 +4354,7 @@ namespace Zero
 
       // if this is still null, this namespace doc just has no mTypedefs
       if (typedefSection == nullptr)
-        continue;
+        return;
 
       TiXmlNode* firstTypedef = GetFirstNodeOfChildType(typedefSection, gElementTags[eMEMBERDEF]);
       TiXmlNode* endTypedef = GetEndNodeOfChildType(typedefSection, gElementTags[eMEMBERDEF]);
@@ -4055,7 +4385,7 @@ namespace Zero
         mTypedefs[key] = newDoc;
       }
 
-    } // end namespace file loop
+    }); // end namespace file loop
 
     Zero::Sort(mTypedefArray.All(), TypedefDocCompareFn);
 
@@ -4095,17 +4425,9 @@ namespace Zero
 
   bool RawTypedefLibrary::SaveToFile(StringParam absPath)
   {
-    Status status;
-
     TextSaver saver;
 
-    saver.Open(status, absPath.c_str());
-
-    if (status.Failed())
-    {
-      Error(status.Message.c_str());
-      return false;
-    }
+    saver.OpenBuffer();
 
     saver.StartPolymorphic("Doc");
 
@@ -4113,7 +4435,7 @@ namespace Zero
 
     saver.EndPolymorphic();
 
-    return true;
+    return DocOutputSink::Get()->WriteSaver(absPath, saver);
   }
 
   bool RawTypedefLibrary::LoadFromFile(StringParam filepath)
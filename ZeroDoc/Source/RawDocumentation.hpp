@@ -18,10 +18,15 @@
 #include "DocTypeTokens.hpp"
 #include "TypeBlacklist.hpp"
 
+#include <mutex>
+
 
 #define WriteLog(...) DocLogger::Get()->Write(__VA_ARGS__)
 namespace Zero
 {
+  class DescriptionBuilder;
+  class ClassTrimStream;
+
   // change this to macro magic later
   enum gElementTagsEnum
   {
@@ -78,6 +83,7 @@ namespace Zero
   class RawNamespaceDoc;
   class IgnoreList;
   class RawDocumentationLibrary;
+  class FlattenedSource;
 
   ///// HELPERS ///// 
   bool LoadCommandList(CommandDocList& commandList, StringParam absPath);
@@ -94,6 +100,7 @@ namespace Zero
 
   /// Gets all of the text from the passed in node and all its children, text is added to output
   void GetTextFromAllChildrenNodesRecursively(TiXmlNode* node, StringBuilder* output);
+  void GetTextFromAllChildrenNodesRecursively(TiXmlNode* node, DescriptionBuilder* output);
 
   /// Get text from passed in node and all of its children and returns it as a string
   String GetTextFromAllChildrenNodesRecursively(TiXmlNode* node);
@@ -101,8 +108,8 @@ namespace Zero
   /// Gets argument at pos if it is a string, otherwise returns empty
   String GetArgumentIfString(TypeTokens &fnCall, uint argPos);
 
-  /// Adds all codelines in a document to the stringbuilder passed for output
-  String GetCodeFromDocumentFile(TiXmlDocument *doc);
+  /// Builds a string of every codeline in source, skipping preprocessor lines and line comments
+  String GetCodeFromDocumentFile(FlattenedSource *source);
 
   /// make doxyfile string from source file name
   String GetDoxyfileNameFromSourceFileName(StringParam fileName);
@@ -127,6 +134,7 @@ namespace Zero
 
   /// gets text from paragraph nodes
   void getTextFromParaNodes(TiXmlNode* node, StringBuilder* output);
+  void getTextFromParaNodes(TiXmlNode* node, DescriptionBuilder* output);
 
   /// replaces token at location with the typdef
   uint ReplaceTypedefAtLocation(TypeTokens& tokenArray
@@ -149,6 +157,9 @@ namespace Zero
   /// recusivly search directory for file with exact name passed in
   String GetFileWithExactName(StringParam basePath, StringParam exactName);
 
+  /// reads every byte of the file at path into bytes, returns false if it could not be read
+  bool ReadWholeFile(StringParam path, Array<char>& bytes);
+
   /// gets rid of any duplicate spaces that doxygen left in descriptions
   String CleanRedundantSpacesInDesc(StringParam description);
 
@@ -160,6 +171,9 @@ namespace Zero
 
   String TrimNamespacesOffOfName(StringParam name);
 
+  /// milliseconds since the first time it was called, what request and response timing uses
+  double GetDocTimeMs(void);
+
 
   /// compares two document classes by alphabetical comparison of names
   template<typename T>
@@ -176,9 +190,15 @@ namespace Zero
   public:
 
     ZilchDeclareType(TypeCopyMode::ReferenceType);
-    /// returns true if directory/file passed in is on the ignore list
+
+    /// returns true if directory/file passed in or any directory it is inside of is on the
+    /// ignore list. Only sees the directories that were there when Compile was last called
     bool DirectoryIsOnIgnoreList(StringParam dir) const;
 
+    /// builds the path trie directory lookups walk from mDirectories. Loading does this, anyone
+    /// changing mDirectories by hand has to call it before any lookup
+    void Compile(void);
+
     bool NameIsOnIgnoreList(StringParam name) const;
 
     bool empty(void);
@@ -193,6 +213,22 @@ namespace Zero
     HashSet<String> mIgnoredNames;
 
     String mDoxyPath;
+
+  private:
+    /// one path component of an ignored directory, children are a linked list of siblings
+    struct PathTrieNode
+    {
+      String mComponent;
+      uint mFirstChild;
+      uint mNextSibling;
+      bool mIgnored;
+    };
+
+    /// returns the child of node matching the component, or (uint)-1
+    uint FindPathTrieChild(uint node, const char* component, uint length) const;
+
+    // node 0 is the root, empty until the list is compiled
+    Array<PathTrieNode> mPathTrie;
   };
 
   class DocLangDfa
@@ -225,6 +261,9 @@ namespace Zero
     bool mStarted;
 
     bool mVerbose;
+
+    // per-class passes can log from several threads at once
+    std::mutex mWriteLock;
   };
 
   class AttributeLoader
@@ -380,6 +419,18 @@ namespace Zero
   // Enum has no additional information so we are just going to have an xml helper and call it good
   void LoadEnumFromDoxy(EnumDoc& enumDoc, TiXmlElement* element, TiXmlNode* enumDef);
 
+  /// an event that was found being sent or listened to in a source listing
+  struct EventReference
+  {
+    EventDoc* mEvent;
+    bool mListening;
+  };
+
+  /// finds every event in libEventList that source sends or listens to, in the order they appear.
+  /// Only reads libEventList so different sources can be scanned at the same time.
+  void FindEventReferencesInSource(FlattenedSource *source, EventDocList &libEventList,
+    Array<EventReference>* output);
+
   class RawClassDoc : public Object
   {
   public:
@@ -413,20 +464,24 @@ namespace Zero
     bool LoadFromDoxygen(StringParam string);
 
     /// looks for bindevent macro calls in cpp docs
-    void LoadEventsFromCppDoc(TiXmlDocument *doc);
+    void LoadEventsFromCppDoc(FlattenedSource *source);
 
-    /// looks for notifyException macro calls in hpp docs
-    void LoadEventsFromHppDoc(TiXmlDocument *doc);
+    /// records this class as a sender/listener of every referenced event. Only appends, the
+    /// library sorts and prunes the event docs once with SortAndPruneEventReferences.
+    void AddEventReferences(const Array<EventReference>& references);
 
-    /// loads events for class with doxName in the doxyPath
-    bool LoadEvents(String doxName, String doxyPath);
+    /// returns the doxygen source listing of the file this class is implemented in, empty if none
+    String GetBodySourcePath(StringParam doxyPath);
 
-    /// calls passed in function on every docline until scope ends
-    void ParseCodelinesInDoc(TiXmlDocument *doc, void(*fn)(RawClassDoc *,StringParam));
+    /// looks for notifyException macro calls in hpp docs
+    void LoadEventsFromHppDoc(FlattenedSource *source);
 
-    void ParseFnCodelinesInDoc(TiXmlDocument *doc);
+    /// calls passed in function with the tokens of every codeline in source
+    void ParseCodelinesInDoc(FlattenedSource *source, void(*fn)(RawClassDoc *, TypeTokens&));
 
-    /// sorts the event array and removes duplicates
+    void ParseFnCodelinesInDoc(FlattenedSource *source);
+
+    /// sorts this class's event array and removes duplicates
     void SortAndPruneEventArray(void);
 
     /// get the path for this classDoc from the root of the doxygen directory
@@ -499,6 +554,9 @@ namespace Zero
     // path to file where function was implemented
     String mBodyFile;
 
+    // the full path doxygen gave for mBodyFile, only known while loading from doxygen
+    String mBodyPath;
+
     String mHeaderFile;
 
     RawDocumentationLibrary *mParentLibrary;
@@ -533,6 +591,8 @@ namespace Zero
 
     ZilchDeclareType(TypeCopyMode::ReferenceType);
 
+    RawDocumentationLibrary() : mSkeleton(nullptr), mTrimStream(nullptr) {}
+
     ~RawDocumentationLibrary();
 
     /// build the class hashmap
@@ -550,9 +610,29 @@ namespace Zero
     /// loop over all classes, save their doc strings into files at directory
     void GenerateCustomDocumentationFiles(StringParam directory);
 
+    /// saves one class into its file under directory, returns false if nothing was saved
+    bool GenerateClassDocumentationFile(StringParam directory, RawClassDoc* classDoc);
+
+    /// saves the list of class files saved so far along with the enums and flags
+    bool SaveLibraryDataFile(StringParam directory);
+
     /// creates a new class with name 'className', stores in internally, then returns it
     RawClassDoc* AddNewClass(StringParam className);
 
+    /// takes the class out of the library and deletes it along with the macro calls it made
+    void RemoveClass(RawClassDoc* classDoc);
+
+    /// loads one class the way the full load does, from the skeleton if the library was loaded
+    /// from one, otherwise from the class xml at xmlPath. Events and macro calls are only queued
+    RawClassDoc* LoadSingleClass(StringParam className, StringParam doxyPath, StringParam xmlPath);
+
+    /// builds classes that were added after Build and puts every class back in name order
+    void BuildAddedClasses(Array<RawClassDoc*>& classes);
+
+    /// replaces the trimmed docs of the named classes in an already finalized trimLib,
+    /// names that are no longer in this library are just removed from it
+    void RefillTrimmedClasses(DocumentationLibrary &trimLib, const HashSet<String>& classNames);
+
     /// grabs comments for overloaded functions
     void FillOverloadDescriptions(void);
 
@@ -568,11 +648,21 @@ namespace Zero
     /// loads all the documentation from the entire doxygen directory minus ignored files
     bool LoadFromDoxygenDirectory(StringParam doxyPath);
 
+    /// scans the source listing of every class in mEventScanQueue for events and exceptions.
+    /// Classes implemented in the same file share one scan and different files run in parallel.
+    void LoadEventsForQueuedClasses(StringParam doxyPath);
+
+    /// sorts the senders and listeners of every event and removes duplicates
+    void SortAndPruneEventReferences(void);
+
     void LoadAllEnumDocumentationFromDoxygen(StringParam doxyPath);
 
-    /// loads list of classes, tags, and events from skeleton documentation library
-    /// returns false if list of classes was empty (i.e. there was nothing to load)
-    bool LoadFromSkeletonFile(StringParam doxyPath, const DocumentationLibrary &library);
+    /// loads list of classes, tags, and events from the skeleton documentation in skeletonFile.
+    /// Every class is loaded from doxygen while the rest of the file is still being read.
+    /// skeleton is filled and finalized along the way and has to outlive this library.
+    /// Returns false if the file could not be read
+    bool LoadFromSkeletonStream(StringParam doxyPath, StringParam skeletonFile,
+      DocumentationLibrary &skeleton);
 
     /// loads the ignore list from the file at absPath
     void LoadIgnoreList(StringParam absPath);
@@ -608,6 +698,30 @@ namespace Zero
     EventDocList mEvents;
 
     TypeBlacklist mBlacklist;
+
+    /// classes waiting on LoadEventsForQueuedClasses, in the order they were loaded
+    Array<RawClassDoc*> mEventScanQueue;
+
+    /// skeleton the classes were loaded from, null if they came from the doxygen directory.
+    /// Kept so single classes can be loaded again later, so it has to outlive the library
+    const DocumentationLibrary* mSkeleton;
+
+    /// if set, every class is handed to it as soon as it was loaded, so it can be trimmed and
+    /// freed while the rest of the library is still loading. Events and macros of a class are
+    /// then processed right after it was loaded instead of once every class was
+    ClassTrimStream* mTrimStream;
+
+  private:
+    /// expands the macro calls from firstMacroCall on and scans the queued events of a class
+    /// that just finished loading, then hands it to mTrimStream. Does nothing without one
+    void StreamLoadedClass(StringParam doxyPath, RawClassDoc* classDoc, uint firstMacroCall);
+
+    /// adds and loads one skeleton class unless it is ignored, blacklisted or already loaded,
+    /// returns the new class or null if it was skipped
+    RawClassDoc* LoadSkeletonClass(StringParam doxyPath, const ClassDoc &classDoc);
+
+    /// scans events and expands macros once every skeleton class was loaded
+    bool FinishSkeletonLoad(StringParam doxyPath);
   };
 
 
@@ -0,0 +1,178 @@
+#include "Precompiled.hpp"
+
+#include "SectionedFile.hpp"
+#include "DocOutputSink.hpp"
+
+namespace Zero
+{
+  /// the start of every sectioned file, followed by one SectionRange per section
+  struct SectionedFileHeader
+  {
+    uint mMagic;
+    uint mVersion;
+    uint mFileSize;
+  };
+
+  static uint GetHeaderSize(const SectionedFileFormat& format)
+  {
+    return sizeof(SectionedFileHeader) + format.mSectionCount * sizeof(SectionRange);
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // SectionedFileWriter
+  ////////////////////////////////////////////////////////////////////////
+  SectionedFileWriter::SectionedFileWriter(const SectionedFileFormat& format)
+    : mFormat(format)
+  {
+    mOutput.Resize(GetHeaderSize(format), 0);
+  }
+
+  void SectionedFileWriter::AddSectionBytes(uint section, const void* data, uint count, uint recordSize)
+  {
+    SectionRange* sections = (SectionRange*)(mOutput.Data() + sizeof(SectionedFileHeader));
+
+    uint start = mOutput.Size();
+    uint size = count * recordSize;
+
+    sections[section].mStart = start;
+    sections[section].mCount = count;
+
+    if (size == 0)
+      return;
+
+    mOutput.Resize(start + size);
+    memcpy(&mOutput[start], data, size);
+  }
+
+  bool SectionedFileWriter::Save(StringParam absPath)
+  {
+    SectionedFileHeader* header = (SectionedFileHeader*)mOutput.Data();
+    header->mMagic = mFormat.mMagic;
+    header->mVersion = mFormat.mVersion;
+    header->mFileSize = mOutput.Size();
+
+    return DocOutputSink::Get()->Write(absPath, mOutput.Data(), mOutput.Size());
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // SectionedFileReader
+  ////////////////////////////////////////////////////////////////////////
+  SectionedFileReader::SectionedFileReader()
+    : mFile(INVALID_HANDLE_VALUE)
+    , mMapping(nullptr)
+    , mData(nullptr)
+    , mSize(0)
+    , mSections(nullptr)
+    , mStringSection(0)
+  {
+  }
+
+  SectionedFileReader::~SectionedFileReader()
+  {
+    Close();
+  }
+
+  bool SectionedFileReader::Open(StringParam absPath, const SectionedFileFormat& format)
+  {
+    Close();
+
+    mFile = CreateFileA(absPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (mFile == INVALID_HANDLE_VALUE)
+    {
+      Error("Unable to open %s file: %s\n", format.mName, absPath.c_str());
+      return false;
+    }
+
+    uint headerSize = GetHeaderSize(format);
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart < (LONGLONG)headerSize
+      || fileSize.QuadPart > (LONGLONG)0xFFFFFFFF)
+    {
+      Error("The %s file has an invalid size: %s\n", format.mName, absPath.c_str());
+      Close();
+      return false;
+    }
+
+    mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping)
+      mData = (const byte*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (!mData)
+    {
+      Error("Unable to map %s file: %s\n", format.mName, absPath.c_str());
+      Close();
+      return false;
+    }
+
+    mSize = (uint)fileSize.QuadPart;
+    mSections = (const SectionRange*)(mData + sizeof(SectionedFileHeader));
+    mStringSection = format.mStringSection;
+
+    const SectionedFileHeader* header = (const SectionedFileHeader*)mData;
+    bool valid = header->mMagic == format.mMagic
+      && header->mVersion == format.mVersion
+      && header->mFileSize == mSize;
+
+    // every section has to fit in the file, record sections have to be aligned so their
+    // records can be read in place
+    for (uint i = 0; valid && i < format.mSectionCount; ++i)
+    {
+      const SectionRange& section = mSections[i];
+      unsigned long long end = section.mStart + (unsigned long long)section.mCount * format.mRecordSizes[i];
+
+      valid = (format.mRecordSizes[i] == 1 || section.mStart % sizeof(uint) == 0)
+        && section.mStart >= headerSize && end <= mSize;
+    }
+
+    // strings are read as c strings, the table must start with the empty string and be terminated
+    const SectionRange& strings = mSections[mStringSection];
+    valid = valid && strings.mCount > 0
+      && mData[strings.mStart] == '\0'
+      && mData[strings.mStart + strings.mCount - 1] == '\0';
+
+    if (!valid)
+    {
+      Error("The %s file is corrupt or from a different version: %s\n", format.mName, absPath.c_str());
+      Close();
+      return false;
+    }
+
+    return true;
+  }
+
+  void SectionedFileReader::Close(void)
+  {
+    if (mData)
+      UnmapViewOfFile(mData);
+
+    if (mMapping)
+      CloseHandle(mMapping);
+
+    if (mFile != INVALID_HANDLE_VALUE)
+      CloseHandle(mFile);
+
+    mFile = INVALID_HANDLE_VALUE;
+    mMapping = nullptr;
+    mData = nullptr;
+    mSize = 0;
+    mSections = nullptr;
+  }
+
+  const SectionRange& SectionedFileReader::GetSection(uint section) const
+  {
+    return mSections[section];
+  }
+
+  const char* SectionedFileReader::GetString(uint offset) const
+  {
+    const SectionRange& strings = mSections[mStringSection];
+
+    if (offset >= strings.mCount)
+      return "";
+
+    return (const char*)mData + strings.mStart + offset;
+  }
+}
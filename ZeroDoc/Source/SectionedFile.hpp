@@ -0,0 +1,88 @@
+#pragma once
+
+namespace Zero
+{
+  /// for sections mStart is the byte offset into the file and mCount the number of records
+  struct SectionRange
+  {
+    uint mStart;
+    uint mCount;
+  };
+
+  /// Describes a file made of a header followed by flat sections of fixed size records: the
+  /// magic number, the version, the file size, then the range of every section. One of the
+  /// sections is a table of null terminated strings the records point into by byte offset.
+  struct SectionedFileFormat
+  {
+    /// names the file in errors, like "search index"
+    cstr mName;
+    uint mMagic;
+    uint mVersion;
+    uint mSectionCount;
+    /// size of one record of every section, byte sections count bytes with a size of 1
+    const uint* mRecordSizes;
+    uint mStringSection;
+  };
+
+  /// Builds a sectioned file in memory. Sections have to be added in order, and record
+  /// sections before byte sections so every record stays 4 byte aligned.
+  class SectionedFileWriter
+  {
+  public:
+    SectionedFileWriter(const SectionedFileFormat& format);
+
+    /// appends records as section
+    template <typename RecordType>
+    void AddSection(uint section, const Array<RecordType>& records)
+    {
+      AddSectionBytes(section, records.Data(), records.Size(), sizeof(RecordType));
+    }
+
+    /// fills in the header and writes the file through the output sink
+    bool Save(StringParam absPath);
+
+  private:
+    void AddSectionBytes(uint section, const void* data, uint count, uint recordSize);
+
+    const SectionedFileFormat& mFormat;
+
+    // the header is reserved up front and filled in by Save
+    Array<byte> mOutput;
+  };
+
+  /// Maps a sectioned file and hands out its records in place
+  class SectionedFileReader
+  {
+  public:
+    SectionedFileReader();
+    ~SectionedFileReader();
+
+    /// maps the file and validates the header against format, errors name the file by it
+    bool Open(StringParam absPath, const SectionedFileFormat& format);
+
+    void Close(void);
+
+    bool IsOpen(void) const { return mData != nullptr; }
+
+    /// the range of section, only valid while open
+    const SectionRange& GetSection(uint section) const;
+
+    template <typename RecordType>
+    const RecordType* GetRecords(uint section) const
+    {
+      return (const RecordType*)(mData + GetSection(section).mStart);
+    }
+
+    /// the string at offset into the string table, empty if offset is out of range
+    const char* GetString(uint offset) const;
+
+  private:
+    HANDLE mFile;
+    HANDLE mMapping;
+
+    const byte* mData;
+    uint mSize;
+    const SectionRange* mSections;
+    uint mStringSection;
+  };
+}
@@ -0,0 +1,257 @@
+#include "Precompiled.hpp"
+
+#include "SkeletonStream.hpp"
+#include "RawDocumentation.hpp"
+#include "Serialization/Simple.hpp"
+#include "Platform/FileSystem.hpp"
+
+#include <Engine/Documentation.hpp>
+
+namespace Zero
+{
+  // returns one past the node starting at text, a type name followed by a braced body, or null
+  // if the text ends first. Braces inside strings do not count
+  static const char* FindNodeEnd(const char* text, const char* end)
+  {
+    uint depth = 0;
+    bool inString = false;
+
+    for (const char* c = text; c < end; ++c)
+    {
+      if (inString)
+      {
+        if (*c == '\\')
+          ++c;
+        else if (*c == '"')
+          inString = false;
+        continue;
+      }
+
+      if (*c == '"')
+      {
+        inString = true;
+      }
+      else if (*c == '{')
+      {
+        ++depth;
+      }
+      else if (*c == '}')
+      {
+        if (depth == 0)
+          return nullptr;
+
+        if (--depth == 0)
+          return c + 1;
+      }
+    }
+
+    return nullptr;
+  }
+
+  static const char* SkipSpaces(const char* text, const char* end)
+  {
+    while (text < end && (IsSpace(*text) || *text == ','))
+      ++text;
+    return text;
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // SkeletonStream
+  ////////////////////////////////////////////////////////////////////////
+  SkeletonStream::SkeletonStream()
+    : mClassesFinished(false)
+    , mFailed(false)
+  {
+  }
+
+  SkeletonStream::~SkeletonStream()
+  {
+    if (mThread.joinable())
+      mThread.join();
+
+    // anything nobody asked for is still ours
+    while (!mClasses.empty())
+    {
+      delete mClasses.front();
+      mClasses.pop_front();
+    }
+    forRange(EnumDoc* enumDoc, mEnums.All())
+    {
+      delete enumDoc;
+    }
+    forRange(EnumDoc* flagDoc, mFlags.All())
+    {
+      delete flagDoc;
+    }
+  }
+
+  bool SkeletonStream::Start(StringParam path)
+  {
+    mPath = path;
+    mClassesFinished = false;
+    mFailed = false;
+    mError = String();
+
+    if (!FileExists(path.c_str()))
+    {
+      Fail(BuildString("Unable to find documentation skeleton file: ", path));
+      return false;
+    }
+
+    mThread = std::thread(&SkeletonStream::ReadFile, this);
+    return true;
+  }
+
+  ClassDoc* SkeletonStream::NextClass(void)
+  {
+    std::unique_lock<std::mutex> lock(mLock);
+    mClassReady.wait(lock, [this]() { return !mClasses.empty() || mClassesFinished; });
+
+    if (mClasses.empty())
+      return nullptr;
+
+    ClassDoc* classDoc = mClasses.front();
+    mClasses.pop_front();
+    return classDoc;
+  }
+
+  bool SkeletonStream::Finish(DocumentationLibrary& skeleton)
+  {
+    if (mThread.joinable())
+      mThread.join();
+
+    forRange(EnumDoc* enumDoc, mEnums.All())
+    {
+      skeleton.mEnums.PushBack(enumDoc);
+    }
+    forRange(EnumDoc* flagDoc, mFlags.All())
+    {
+      skeleton.mFlags.PushBack(flagDoc);
+    }
+    mEnums.Clear();
+    mFlags.Clear();
+
+    // the reading thread only records what went wrong, it is reported once from here
+    if (mFailed)
+    {
+      Error("%s\n", mError.c_str());
+      return false;
+    }
+
+    printf("...successfully loaded doc skeleton from file...\n");
+    return true;
+  }
+
+  void SkeletonStream::Fail(StringParam message)
+  {
+    std::lock_guard<std::mutex> lock(mLock);
+    mFailed = true;
+    mError = message;
+    mClassesFinished = true;
+    mClassReady.notify_all();
+  }
+
+  void SkeletonStream::ReadFile(void)
+  {
+    Array<char> bytes;
+
+    if (!ReadWholeFile(mPath, bytes) || bytes.Empty())
+    {
+      Fail(BuildString("Unable to read documentation skeleton file: ", mPath));
+      return;
+    }
+
+    bytes.PushBack('\0');
+    const char* begin = bytes.Data();
+    const char* end = begin + bytes.Size() - 1;
+
+    // the file is laid out the way SaveTrimDocToDataFile wrote it, the classes array first
+    const char* classesStart = strstr(begin, "var Classes");
+    const char* arrayStart = classesStart ? strchr(classesStart, '{') : nullptr;
+
+    if (arrayStart == nullptr)
+    {
+      Fail(BuildString("Documentation skeleton file has no classes: ", mPath));
+      return;
+    }
+
+    // every node is parsed as a file of its own, with the version line the file started with
+    String header;
+    if (*begin == '[')
+    {
+      const char* headerEnd = strchr(begin, '\n');
+      header = headerEnd ? String(begin, headerEnd + 1 - begin) : String();
+    }
+
+    const char* c = SkipSpaces(arrayStart + 1, end);
+    uint classIndex = 0;
+
+    while (c < end && *c != '}')
+    {
+      const char* nodeEnd = FindNodeEnd(c, end);
+
+      if (nodeEnd == nullptr)
+      {
+        Fail(String::Format("Documentation skeleton file ends inside class %u: %s", classIndex,
+          mPath.c_str()));
+        return;
+      }
+
+      Status status;
+      DataTreeLoader loader;
+      PolymorphicNode classNode;
+
+      if (!loader.OpenBuffer(status, BuildString(header, String(c, nodeEnd - c)))
+        || !loader.GetPolymorphic(classNode))
+      {
+        Fail(String::Format("Unable to read class %u of documentation skeleton file: %s",
+          classIndex, mPath.c_str()));
+        return;
+      }
+
+      ClassDoc* classDoc = new ClassDoc();
+      classDoc->Serialize(loader);
+      loader.EndPolymorphic();
+      loader.Close();
+
+      {
+        std::lock_guard<std::mutex> lock(mLock);
+        mClasses.push_back(classDoc);
+        mClassReady.notify_one();
+      }
+
+      ++classIndex;
+      c = SkipSpaces(nodeEnd, end);
+    }
+
+    if (c >= end)
+    {
+      Fail(BuildString("Documentation skeleton file ends inside its classes: ", mPath));
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+      mClassesFinished = true;
+      mClassReady.notify_all();
+    }
+
+    // what is left is the library node without its classes, small enough to parse in one go
+    Status status;
+    DataTreeLoader loader;
+    PolymorphicNode docLibraryNode;
+
+    if (!loader.OpenBuffer(status, BuildString(String(begin, classesStart - begin), String(c + 1, end - (c + 1))))
+      || !loader.GetPolymorphic(docLibraryNode))
+    {
+      Fail(BuildString("Unable to read the enums of documentation skeleton file: ", mPath));
+      return;
+    }
+
+    loader.SerializeField("Enums", mEnums);
+    loader.SerializeField("Flags", mFlags);
+
+    loader.EndPolymorphic();
+    loader.Close();
+  }
+}
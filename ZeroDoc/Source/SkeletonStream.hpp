@@ -0,0 +1,60 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace Zero
+{
+  class ClassDoc;
+  class EnumDoc;
+  class DocumentationLibrary;
+
+  /// Reads a documentation skeleton file on its own thread and hands out every class as soon
+  /// as it is parsed, so whoever consumes them overlaps with the rest of the file. The text is
+  /// split into one node per class and each node is parsed on its own, the tree of the whole
+  /// file is never built. Enums and flags come after the classes in the file and are only
+  /// available at the end.
+  class SkeletonStream
+  {
+  public:
+    SkeletonStream();
+    ~SkeletonStream();
+
+    /// starts reading path on the reading thread, false if the file does not exist. Finish
+    /// still has to be called to report why
+    bool Start(StringParam path);
+
+    /// blocks until the next class is read, null once every class was handed out. The caller
+    /// owns the returned class.
+    ClassDoc* NextClass(void);
+
+    /// waits for the rest of the file and moves its enums and flags into skeleton. Reports
+    /// what went wrong and returns false if the file could not be read completely.
+    bool Finish(DocumentationLibrary& skeleton);
+
+  private:
+    /// runs on mThread, every class it reads goes through mLock
+    void ReadFile(void);
+
+    /// stops reading with message as the error Finish reports
+    void Fail(StringParam message);
+
+    String mPath;
+    std::thread mThread;
+
+    std::mutex mLock;
+    // signaled whenever a class was read or reading stopped
+    std::condition_variable mClassReady;
+
+    std::deque<ClassDoc*> mClasses;
+    bool mClassesFinished;
+
+    // only touched by the reading thread until it was joined
+    bool mFailed;
+    String mError;
+    Array<EnumDoc*> mEnums;
+    Array<EnumDoc*> mFlags;
+  };
+}
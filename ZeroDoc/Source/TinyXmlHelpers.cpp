@@ -60,11 +60,60 @@ TiXmlElement* FindElementWithAttribute(TiXmlElement* element, cstr attribute, cs
   return NULL;
 }
 
-void RecursiveExtract(StringBuilder& builder, TiXmlNode* node)
+// the buffer every DescriptionBuilder on this thread writes into, it keeps its capacity
+static Array<char>& GetDescriptionBuffer(void)
+{
+  static thread_local Array<char> sBuffer;
+  return sBuffer;
+}
+
+DescriptionBuilder::DescriptionBuilder()
+  : mBuffer(GetDescriptionBuffer())
+{
+  mBuffer.Clear();
+}
+
+void DescriptionBuilder::Append(cstr text)
+{
+  for (; *text != '\0'; ++text)
+    Append(*text);
+}
+
+void DescriptionBuilder::Append(char c)
+{
+  // only ascii bytes can be white space, the rest are parts of utf8 characters
+  if (c > 0 && IsSpace(c))
+  {
+    // leading white space is trimmed
+    if (mBuffer.Empty())
+      return;
+
+    // and only the first of several spaces in a row is kept
+    if (c == ' ' && mBuffer.Back() == ' ')
+      return;
+  }
+
+  mBuffer.PushBack(c);
+}
+
+String DescriptionBuilder::ToString()
+{
+  uint size = mBuffer.Size();
+  while (size > 0 && mBuffer[size - 1] > 0 && IsSpace(mBuffer[size - 1]))
+    --size;
+
+  if (size == 0)
+    return String();
+
+  return String(mBuffer.Data(), size);
+}
+
+template <typename BuilderType>
+static void ExtractText(BuilderType& builder, TiXmlNode* node)
 {
   bool thisIsAReference = false;
   // if we are a type reference, we need to start with a space since tixml eats it
-  if (String(node->Value()) == gElementTags[eREF])
+  if (strcmp(node->Value(), gElementTags[eREF]) == 0)
     thisIsAReference = true;
 
   TiXmlText *text = node->ToText();
@@ -76,10 +125,10 @@ void RecursiveExtract(StringBuilder& builder, TiXmlNode* node)
     if (thisIsAReference 
       || (textString != nullptr && tolower(textString[0]) >= 'a' && tolower(textString[0]) <= 'z'))
     {
-      builder << " ";
+      builder.Append(' ');
     }
 
-    builder << text->Value();
+    builder.Append(text->Value());
   }
 
   if(TiXmlElement* element = node->ToElement())
@@ -87,15 +136,23 @@ void RecursiveExtract(StringBuilder& builder, TiXmlNode* node)
     TiXmlNode* child = element->FirstChild();
     while(child)
     {
-      TiXmlElement* childElement = child->ToElement();
-      
-      RecursiveExtract(builder, child);
+      ExtractText(builder, child);
 
       child = child->NextSibling();
     }
   }
 }
 
+void RecursiveExtract(StringBuilder& builder, TiXmlNode* node)
+{
+  ExtractText(builder, node);
+}
+
+void RecursiveExtract(DescriptionBuilder& builder, TiXmlNode* node)
+{
+  ExtractText(builder, node);
+}
+
 String DoxyToString(TiXmlElement* parent, cstr name)
 {
   StringBuilder builder;
@@ -110,6 +167,20 @@ String DoxyToString(TiXmlElement* parent, cstr name)
   return builder.ToString();
 }
 
+String DoxyToDescription(TiXmlElement* parent, cstr name)
+{
+  DescriptionBuilder builder;
+
+  TiXmlElement* mainElement = parent->FirstChildElement(name);
+
+  if(mainElement)
+  {
+    RecursiveExtract(builder, mainElement);
+  }
+
+  return builder.ToString();
+}
+
 String GetElementValue(TiXmlElement* parent, cstr name, cstr second)
 {
   TiXmlElement* element = parent->FirstChildElement(name);
@@ -287,7 +358,7 @@ String FindFile(StringParam basePath, StringParam fileName, IgnoreList &ignoreLi
   
   if (ignoreList.DirectoryIsOnIgnoreList(fullPath))
   {
-    WriteLog("Ignoring File: %s\n", fullPath);
+    WriteLog("Ignoring File: %s\n", fullPath.c_str());
     return String();
   }
 
@@ -302,8 +373,8 @@ String FindFile(StringParam basePath, StringParam fileName, IgnoreList &ignoreLi
 
     if (ignoreList.DirectoryIsOnIgnoreList(subPath))
     {
-      WriteLog("Ignoring File: %s\n", subPath);
-      return String();
+      WriteLog("Ignoring File: %s\n", subPath.c_str());
+      continue;
     }
 
     if (IsDirectory(subPath))
@@ -21,12 +21,36 @@ namespace Zero
   /// finds next element that has the passed attribute of value 'value'
   TiXmlElement* FindElementWithAttribute(TiXmlElement* element, cstr attribute, cstr value);
 
+  /// Builds a description in a buffer owned by the calling thread and cleans it as text is
+  /// appended: leading white space is skipped, runs of spaces collapse to one and trailing
+  /// white space is cut when the string is made. The result is what Trim followed by
+  /// CleanRedundantSpacesInDesc gives, without the copies. Only one can be in use per thread.
+  class DescriptionBuilder
+  {
+  public:
+    DescriptionBuilder();
+
+    void Append(cstr text);
+    void Append(char c);
+
+    /// the cleaned description, the only allocation it makes
+    String ToString();
+
+  private:
+    Array<char>& mBuffer;
+  };
+
   /// extracts text recurs from all children
   void RecursiveExtract(StringBuilder& builder, TiXmlNode* node);
+  void RecursiveExtract(DescriptionBuilder& builder, TiXmlNode* node);
 
   /// calls recursiveExtract on first element to try to get name information
   String DoxyToString(TiXmlElement* parent, cstr name);
 
+  /// same text as DoxyToString(parent, name).Trim() passed through CleanRedundantSpacesInDesc,
+  /// extracted and cleaned in one walk of the nodes
+  String DoxyToDescription(TiXmlElement* parent, cstr name);
+
   /// get text from child of name 'name' or if second is passed, of 'name's child named 'second'
   String GetElementValue(TiXmlElement* parent, cstr name, cstr second = nullptr);
 
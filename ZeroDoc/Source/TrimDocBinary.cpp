@@ -0,0 +1,655 @@
+#include "Precompiled.hpp"
+
+#include "TrimDocBinary.hpp"
+#include "Engine/Documentation.hpp"
+#include "SectionedFile.hpp"
+
+namespace Zero
+{
+  // 'ZDBT' as it reads in a hex editor
+  static const uint cBinaryDocMagic = 0x5442445A;
+  static const uint cBinaryDocVersion = 1;
+
+  /// sections of the file in the order they are written, strings go last so every record
+  /// section stays 4 byte aligned
+  namespace BinaryDocSection
+  {
+    enum Enum
+    {
+      StringRefs,
+      Classes,
+      ClassIndex,
+      Events,
+      Properties,
+      Methods,
+      Parameters,
+      Exceptions,
+      Enums,
+      Flags,
+      Strings,
+      Count
+    };
+  }
+
+  namespace BinaryDocFlags
+  {
+    enum Enum
+    {
+      ReadOnly = 1 << 0,
+      Static = 1 << 1
+    };
+  }
+
+  /// a run of records, every string in a record is a byte offset into the string table
+  struct BinaryDocRange
+  {
+    uint mStart;
+    uint mCount;
+  };
+
+  struct BinaryDocClassRecord
+  {
+    uint mName;
+    uint mBaseClass;
+    uint mDescription;
+    uint mLibrary;
+    // into StringRefs
+    BinaryDocRange mTags;
+    BinaryDocRange mEvents;
+    BinaryDocRange mProperties;
+    BinaryDocRange mMethods;
+  };
+
+  struct BinaryDocIndexEntry
+  {
+    uint mName;
+    uint mRecord;
+  };
+
+  struct BinaryDocEventRecord
+  {
+    uint mName;
+    uint mType;
+    // into StringRefs
+    BinaryDocRange mSenders;
+    BinaryDocRange mListeners;
+  };
+
+  struct BinaryDocPropertyRecord
+  {
+    uint mName;
+    uint mType;
+    uint mDescription;
+    uint mFlags;
+  };
+
+  struct BinaryDocMethodRecord
+  {
+    uint mName;
+    uint mReturnType;
+    uint mDescription;
+    uint mParameters;
+    uint mFlags;
+    BinaryDocRange mParameterList;
+    BinaryDocRange mExceptions;
+  };
+
+  struct BinaryDocParameterRecord
+  {
+    uint mName;
+    uint mType;
+    uint mDescription;
+  };
+
+  struct BinaryDocExceptionRecord
+  {
+    uint mTitle;
+    uint mMessage;
+  };
+
+  struct BinaryDocEnumRecord
+  {
+    uint mName;
+    uint mDescription;
+    // value name and description pairs in StringRefs, mCount is the number of pairs
+    BinaryDocRange mValues;
+  };
+
+  // size of one record in each section, used to validate the header
+  static const uint cBinaryDocRecordSizes[BinaryDocSection::Count] =
+  {
+    sizeof(uint),
+    sizeof(BinaryDocClassRecord),
+    sizeof(BinaryDocIndexEntry),
+    sizeof(BinaryDocEventRecord),
+    sizeof(BinaryDocPropertyRecord),
+    sizeof(BinaryDocMethodRecord),
+    sizeof(BinaryDocParameterRecord),
+    sizeof(BinaryDocExceptionRecord),
+    sizeof(BinaryDocEnumRecord),
+    sizeof(BinaryDocEnumRecord),
+    sizeof(char)
+  };
+
+  static const SectionedFileFormat cBinaryDocFormat =
+  {
+    "binary documentation",
+    cBinaryDocMagic,
+    cBinaryDocVersion,
+    BinaryDocSection::Count,
+    cBinaryDocRecordSizes,
+    BinaryDocSection::Strings
+  };
+
+  ////////////////////////////////////////////////////////////////////////
+  // Writing
+  ////////////////////////////////////////////////////////////////////////
+  static bool ClassNameLess(ClassDoc* lhs, ClassDoc* rhs)
+  {
+    return strcmp(lhs->mName.c_str(), rhs->mName.c_str()) < 0;
+  }
+
+  /// flattens the trimmed library into record arrays and a deduplicated string table
+  class BinaryTrimDocBuilder
+  {
+  public:
+    BinaryTrimDocBuilder()
+    {
+      // offset 0 is always the empty string
+      mStrings.PushBack('\0');
+    }
+
+    uint AddString(StringParam text)
+    {
+      if (text.Empty())
+        return 0;
+
+      uint offset = mStringOffsets.FindValue(text, 0);
+      if (offset != 0)
+        return offset;
+
+      offset = mStrings.Size();
+      mStrings.Resize(offset + text.SizeInBytes() + 1);
+      memcpy(&mStrings[offset], text.c_str(), text.SizeInBytes() + 1);
+
+      mStringOffsets[text] = offset;
+      return offset;
+    }
+
+    BinaryDocRange AddStringRefs(Array<String>& strings)
+    {
+      BinaryDocRange range;
+      range.mStart = mStringRefs.Size();
+      range.mCount = strings.Size();
+
+      forRange(String& text, strings.All())
+      {
+        mStringRefs.PushBack(AddString(text));
+      }
+      return range;
+    }
+
+    void AddClass(ClassDoc* classDoc)
+    {
+      BinaryDocIndexEntry& entry = mClassIndex.PushBack();
+      entry.mName = AddString(classDoc->mName);
+      entry.mRecord = mClasses.Size();
+
+      BinaryDocClassRecord record;
+      record.mName = entry.mName;
+      record.mBaseClass = AddString(classDoc->mBaseClass);
+      record.mDescription = AddString(classDoc->mDescription);
+      record.mLibrary = AddString(classDoc->mLibrary);
+      record.mTags = AddStringRefs(classDoc->mTags);
+
+      record.mEvents.mStart = mEvents.Size();
+      record.mEvents.mCount = classDoc->mEventsSent.Size();
+      forRange(EventDoc* eventDoc, classDoc->mEventsSent.All())
+      {
+        BinaryDocEventRecord eventRecord;
+        eventRecord.mName = AddString(eventDoc->mName);
+        eventRecord.mType = AddString(eventDoc->mType);
+        eventRecord.mSenders = AddStringRefs(eventDoc->mSenders);
+        eventRecord.mListeners = AddStringRefs(eventDoc->mListeners);
+        mEvents.PushBack(eventRecord);
+      }
+
+      record.mProperties.mStart = mProperties.Size();
+      record.mProperties.mCount = classDoc->mProperties.Size();
+      forRange(PropertyDoc* propDoc, classDoc->mProperties.All())
+      {
+        BinaryDocPropertyRecord propRecord;
+        propRecord.mName = AddString(propDoc->mName);
+        propRecord.mType = AddString(propDoc->mType);
+        propRecord.mDescription = AddString(propDoc->mDescription);
+        propRecord.mFlags = (propDoc->mReadOnly ? BinaryDocFlags::ReadOnly : 0)
+          | (propDoc->mStatic ? BinaryDocFlags::Static : 0);
+        mProperties.PushBack(propRecord);
+      }
+
+      record.mMethods.mStart = mMethods.Size();
+      record.mMethods.mCount = classDoc->mMethods.Size();
+      forRange(MethodDoc* methodDoc, classDoc->mMethods.All())
+      {
+        AddMethod(methodDoc);
+      }
+
+      mClasses.PushBack(record);
+    }
+
+    void AddMethod(MethodDoc* methodDoc)
+    {
+      BinaryDocMethodRecord record;
+      record.mName = AddString(methodDoc->mName);
+      record.mReturnType = AddString(methodDoc->mReturnType);
+      record.mDescription = AddString(methodDoc->mDescription);
+      record.mParameters = AddString(methodDoc->mParameters);
+      record.mFlags = methodDoc->mStatic ? BinaryDocFlags::Static : 0;
+
+      record.mParameterList.mStart = mParameters.Size();
+      record.mParameterList.mCount = methodDoc->mParameterList.Size();
+      forRange(ParameterDoc* paramDoc, methodDoc->mParameterList.All())
+      {
+        BinaryDocParameterRecord paramRecord;
+        paramRecord.mName = AddString(paramDoc->mName);
+        paramRecord.mType = AddString(paramDoc->mType);
+        paramRecord.mDescription = AddString(paramDoc->mDescription);
+        mParameters.PushBack(paramRecord);
+      }
+
+      record.mExceptions.mStart = mExceptions.Size();
+      record.mExceptions.mCount = methodDoc->mPossibleExceptionThrows.Size();
+      forRange(ExceptionDoc* exceptionDoc, methodDoc->mPossibleExceptionThrows.All())
+      {
+        BinaryDocExceptionRecord exceptionRecord;
+        exceptionRecord.mTitle = AddString(exceptionDoc->mTitle);
+        exceptionRecord.mMessage = AddString(exceptionDoc->mMessage);
+        mExceptions.PushBack(exceptionRecord);
+      }
+
+      mMethods.PushBack(record);
+    }
+
+    void AddEnum(EnumDoc* enumDoc, Array<BinaryDocEnumRecord>& records)
+    {
+      BinaryDocEnumRecord record;
+      record.mName = AddString(enumDoc->mName);
+      record.mDescription = AddString(enumDoc->mDescription);
+
+      record.mValues.mStart = mStringRefs.Size();
+      record.mValues.mCount = 0;
+      forRange(auto& valuePair, enumDoc->mEnumValues.All())
+      {
+        mStringRefs.PushBack(AddString(valuePair.first));
+        mStringRefs.PushBack(AddString(valuePair.second));
+        ++record.mValues.mCount;
+      }
+
+      records.PushBack(record);
+    }
+
+    HashMap<String, uint> mStringOffsets;
+
+    Array<char> mStrings;
+    Array<uint> mStringRefs;
+    Array<BinaryDocClassRecord> mClasses;
+    Array<BinaryDocIndexEntry> mClassIndex;
+    Array<BinaryDocEventRecord> mEvents;
+    Array<BinaryDocPropertyRecord> mProperties;
+    Array<BinaryDocMethodRecord> mMethods;
+    Array<BinaryDocParameterRecord> mParameters;
+    Array<BinaryDocExceptionRecord> mExceptions;
+    Array<BinaryDocEnumRecord> mEnums;
+    Array<BinaryDocEnumRecord> mFlags;
+  };
+
+  bool SaveTrimDocToBinaryFile(DocumentationLibrary &lib, StringParam absPath)
+  {
+    BinaryTrimDocBuilder builder;
+
+    // records go in name order so the index can be binary searched
+    Array<ClassDoc*> sortedClasses = lib.mClasses;
+    Sort(sortedClasses.All(), ClassNameLess);
+
+    forRange(ClassDoc* classDoc, sortedClasses.All())
+    {
+      builder.AddClass(classDoc);
+    }
+
+    forRange(EnumDoc* enumDoc, lib.mEnums.All())
+    {
+      builder.AddEnum(enumDoc, builder.mEnums);
+    }
+
+    forRange(EnumDoc* flagsDoc, lib.mFlags.All())
+    {
+      builder.AddEnum(flagsDoc, builder.mFlags);
+    }
+
+    SectionedFileWriter writer(cBinaryDocFormat);
+    writer.AddSection(BinaryDocSection::StringRefs, builder.mStringRefs);
+    writer.AddSection(BinaryDocSection::Classes, builder.mClasses);
+    writer.AddSection(BinaryDocSection::ClassIndex, builder.mClassIndex);
+    writer.AddSection(BinaryDocSection::Events, builder.mEvents);
+    writer.AddSection(BinaryDocSection::Properties, builder.mProperties);
+    writer.AddSection(BinaryDocSection::Methods, builder.mMethods);
+    writer.AddSection(BinaryDocSection::Parameters, builder.mParameters);
+    writer.AddSection(BinaryDocSection::Exceptions, builder.mExceptions);
+    writer.AddSection(BinaryDocSection::Enums, builder.mEnums);
+    writer.AddSection(BinaryDocSection::Flags, builder.mFlags);
+    writer.AddSection(BinaryDocSection::Strings, builder.mStrings);
+
+    return writer.Save(absPath);
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // BinaryTrimDocReader
+  ////////////////////////////////////////////////////////////////////////
+  BinaryTrimDocReader::BinaryTrimDocReader()
+    : mLibrary(nullptr)
+  {
+  }
+
+  BinaryTrimDocReader::~BinaryTrimDocReader()
+  {
+    Close();
+  }
+
+  bool BinaryTrimDocReader::Open(StringParam absPath)
+  {
+    Close();
+
+    if (!mFile.Open(absPath, cBinaryDocFormat))
+      return false;
+
+    mLibrary = new DocumentationLibrary();
+    mClassCache.Resize(GetClassCount(), nullptr);
+    mEnumCache.Resize(mFile.GetSection(BinaryDocSection::Enums).mCount, nullptr);
+    mFlagsCache.Resize(mFile.GetSection(BinaryDocSection::Flags).mCount, nullptr);
+
+    return true;
+  }
+
+  void BinaryTrimDocReader::Close(void)
+  {
+    mFile.Close();
+
+    // the library owns every doc that was materialized
+    delete mLibrary;
+    mLibrary = nullptr;
+
+    mClassCache.Clear();
+    mEnumCache.Clear();
+    mFlagsCache.Clear();
+  }
+
+  uint BinaryTrimDocReader::GetClassCount(void) const
+  {
+    if (!IsOpen())
+      return 0;
+
+    return mFile.GetSection(BinaryDocSection::ClassIndex).mCount;
+  }
+
+  const char* BinaryTrimDocReader::GetClassNameAtIndex(uint index) const
+  {
+    if (index >= GetClassCount())
+      return "";
+
+    return mFile.GetString(mFile.GetRecords<BinaryDocIndexEntry>(BinaryDocSection::ClassIndex)[index].mName);
+  }
+
+  /// true if range fits inside section, a corrupt range is treated as empty
+  static bool RangeFits(const BinaryDocRange& range, const SectionRange& section)
+  {
+    return (unsigned long long)range.mStart + range.mCount <= section.mCount;
+  }
+
+  ClassDoc* BinaryTrimDocReader::GetClass(uint index)
+  {
+    if (index >= GetClassCount())
+      return nullptr;
+
+    if (mClassCache[index])
+      return mClassCache[index];
+
+    const SectionRange* sections = &mFile.GetSection(0);
+    const uint* stringRefs = mFile.GetRecords<uint>(BinaryDocSection::StringRefs);
+
+    const BinaryDocIndexEntry& entry = mFile.GetRecords<BinaryDocIndexEntry>(BinaryDocSection::ClassIndex)[index];
+    if (entry.mRecord >= sections[BinaryDocSection::Classes].mCount)
+      return nullptr;
+
+    const BinaryDocClassRecord& record = mFile.GetRecords<BinaryDocClassRecord>(BinaryDocSection::Classes)[entry.mRecord];
+
+    ClassDoc* classDoc = new ClassDoc();
+    classDoc->mName = mFile.GetString(record.mName);
+    classDoc->mBaseClass = mFile.GetString(record.mBaseClass);
+    classDoc->mDescription = mFile.GetString(record.mDescription);
+    classDoc->mLibrary = mFile.GetString(record.mLibrary);
+
+    if (RangeFits(record.mTags, sections[BinaryDocSection::StringRefs]))
+    {
+      for (uint i = 0; i < record.mTags.mCount; ++i)
+        classDoc->mTags.PushBack(mFile.GetString(stringRefs[record.mTags.mStart + i]));
+    }
+
+    if (RangeFits(record.mEvents, sections[BinaryDocSection::Events]))
+    {
+      const BinaryDocEventRecord* events = mFile.GetRecords<BinaryDocEventRecord>(BinaryDocSection::Events);
+
+      for (uint i = 0; i < record.mEvents.mCount; ++i)
+      {
+        const BinaryDocEventRecord& eventRecord = events[record.mEvents.mStart + i];
+
+        EventDoc* eventDoc = new EventDoc();
+        eventDoc->mName = mFile.GetString(eventRecord.mName);
+        eventDoc->mType = mFile.GetString(eventRecord.mType);
+
+        if (RangeFits(eventRecord.mSenders, sections[BinaryDocSection::StringRefs]))
+        {
+          for (uint j = 0; j < eventRecord.mSenders.mCount; ++j)
+            eventDoc->mSenders.PushBack(mFile.GetString(stringRefs[eventRecord.mSenders.mStart + j]));
+        }
+
+        if (RangeFits(eventRecord.mListeners, sections[BinaryDocSection::StringRefs]))
+        {
+          for (uint j = 0; j < eventRecord.mListeners.mCount; ++j)
+            eventDoc->mListeners.PushBack(mFile.GetString(stringRefs[eventRecord.mListeners.mStart + j]));
+        }
+
+        classDoc->mEventsSent.PushBack(eventDoc);
+        classDoc->mEventsMap[eventDoc->mName] = eventDoc;
+      }
+    }
+
+    if (RangeFits(record.mProperties, sections[BinaryDocSection::Properties]))
+    {
+      const BinaryDocPropertyRecord* properties = mFile.GetRecords<BinaryDocPropertyRecord>(BinaryDocSection::Properties);
+
+      for (uint i = 0; i < record.mProperties.mCount; ++i)
+      {
+        const BinaryDocPropertyRecord& propRecord = properties[record.mProperties.mStart + i];
+
+        PropertyDoc* propDoc = new PropertyDoc();
+        propDoc->mName = mFile.GetString(propRecord.mName);
+        propDoc->mType = mFile.GetString(propRecord.mType);
+        propDoc->mDescription = mFile.GetString(propRecord.mDescription);
+        propDoc->mReadOnly = (propRecord.mFlags & BinaryDocFlags::ReadOnly) != 0;
+        propDoc->mStatic = (propRecord.mFlags & BinaryDocFlags::Static) != 0;
+
+        classDoc->mProperties.PushBack(propDoc);
+        classDoc->mPropertiesMap[propDoc->mName] = propDoc;
+      }
+    }
+
+    if (RangeFits(record.mMethods, sections[BinaryDocSection::Methods]))
+    {
+      const BinaryDocMethodRecord* methods = mFile.GetRecords<BinaryDocMethodRecord>(BinaryDocSection::Methods);
+      const BinaryDocParameterRecord* parameters = mFile.GetRecords<BinaryDocParameterRecord>(BinaryDocSection::Parameters);
+      const BinaryDocExceptionRecord* exceptions = mFile.GetRecords<BinaryDocExceptionRecord>(BinaryDocSection::Exceptions);
+
+      for (uint i = 0; i < record.mMethods.mCount; ++i)
+      {
+        const BinaryDocMethodRecord& methodRecord = methods[record.mMethods.mStart + i];
+
+        MethodDoc* methodDoc = new MethodDoc();
+        methodDoc->mName = mFile.GetString(methodRecord.mName);
+        methodDoc->mReturnType = mFile.GetString(methodRecord.mReturnType);
+        methodDoc->mDescription = mFile.GetString(methodRecord.mDescription);
+        methodDoc->mParameters = mFile.GetString(methodRecord.mParameters);
+        methodDoc->mStatic = (methodRecord.mFlags & BinaryDocFlags::Static) != 0;
+
+        if (RangeFits(methodRecord.mParameterList, sections[BinaryDocSection::Parameters]))
+        {
+          for (uint j = 0; j < methodRecord.mParameterList.mCount; ++j)
+          {
+            const BinaryDocParameterRecord& paramRecord = parameters[methodRecord.mParameterList.mStart + j];
+
+            ParameterDoc* paramDoc = new ParameterDoc();
+            paramDoc->mName = mFile.GetString(paramRecord.mName);
+            paramDoc->mType = mFile.GetString(paramRecord.mType);
+            paramDoc->mDescription = mFile.GetString(paramRecord.mDescription);
+            methodDoc->mParameterList.PushBack(paramDoc);
+          }
+        }
+
+        if (RangeFits(methodRecord.mExceptions, sections[BinaryDocSection::Exceptions]))
+        {
+          for (uint j = 0; j < methodRecord.mExceptions.mCount; ++j)
+          {
+            const BinaryDocExceptionRecord& exceptionRecord = exceptions[methodRecord.mExceptions.mStart + j];
+
+            ExceptionDoc* exceptionDoc = new ExceptionDoc();
+            exceptionDoc->mTitle = mFile.GetString(exceptionRecord.mTitle);
+            exceptionDoc->mMessage = mFile.GetString(exceptionRecord.mMessage);
+            methodDoc->mPossibleExceptionThrows.PushBack(exceptionDoc);
+          }
+        }
+
+        classDoc->mMethods.PushBack(methodDoc);
+      }
+    }
+
+    mLibrary->mClasses.PushBack(classDoc);
+    mClassCache[index] = classDoc;
+    return classDoc;
+  }
+
+  ClassDoc* BinaryTrimDocReader::FindClass(StringParam className)
+  {
+    if (!IsOpen())
+      return nullptr;
+
+    const BinaryDocIndexEntry* index = mFile.GetRecords<BinaryDocIndexEntry>(BinaryDocSection::ClassIndex);
+
+    // only the index and the string table are touched until the class is found
+    uint begin = 0;
+    uint end = GetClassCount();
+    while (begin < end)
+    {
+      uint middle = begin + (end - begin) / 2;
+      int comparison = strcmp(mFile.GetString(index[middle].mName), className.c_str());
+
+      if (comparison == 0)
+        return GetClass(middle);
+
+      if (comparison < 0)
+        begin = middle + 1;
+      else
+        end = middle;
+    }
+
+    return nullptr;
+  }
+
+  uint BinaryTrimDocReader::FindEnumRecord(uint section, StringParam name) const
+  {
+    if (!IsOpen())
+      return (uint)-1;
+
+    const BinaryDocEnumRecord* records = mFile.GetRecords<BinaryDocEnumRecord>(section);
+    uint count = mFile.GetSection(section).mCount;
+
+    // there are few enough enums that a scan over the names is fine
+    for (uint i = 0; i < count; ++i)
+    {
+      if (name == mFile.GetString(records[i].mName))
+        return i;
+    }
+
+    return (uint)-1;
+  }
+
+  EnumDoc* BinaryTrimDocReader::MaterializeEnum(uint section, uint index,
+    Array<EnumDoc*>& cache, Array<EnumDoc*>& libraryList)
+  {
+    if (cache[index])
+      return cache[index];
+
+    const BinaryDocEnumRecord& record = mFile.GetRecords<BinaryDocEnumRecord>(section)[index];
+    const uint* stringRefs = mFile.GetRecords<uint>(BinaryDocSection::StringRefs);
+
+    EnumDoc* enumDoc = new EnumDoc();
+    enumDoc->mName = mFile.GetString(record.mName);
+    enumDoc->mDescription = mFile.GetString(record.mDescription);
+
+    // values are stored as name/description pairs
+    BinaryDocRange refs = { record.mValues.mStart, record.mValues.mCount * 2 };
+    if (RangeFits(refs, mFile.GetSection(BinaryDocSection::StringRefs)))
+    {
+      for (uint i = 0; i < refs.mCount; i += 2)
+      {
+        enumDoc->mEnumValues.InsertOrAssign(mFile.GetString(stringRefs[refs.mStart + i]),
+          mFile.GetString(stringRefs[refs.mStart + i + 1]));
+      }
+    }
+
+    libraryList.PushBack(enumDoc);
+    cache[index] = enumDoc;
+    return enumDoc;
+  }
+
+  EnumDoc* BinaryTrimDocReader::FindEnum(StringParam name)
+  {
+    uint index = FindEnumRecord(BinaryDocSection::Enums, name);
+    if (index == (uint)-1)
+      return nullptr;
+
+    return MaterializeEnum(BinaryDocSection::Enums, index, mEnumCache, mLibrary->mEnums);
+  }
+
+  EnumDoc* BinaryTrimDocReader::FindFlags(StringParam name)
+  {
+    uint index = FindEnumRecord(BinaryDocSection::Flags, name);
+    if (index == (uint)-1)
+      return nullptr;
+
+    return MaterializeEnum(BinaryDocSection::Flags, index, mFlagsCache, mLibrary->mFlags);
+  }
+
+  DocumentationLibrary& BinaryTrimDocReader::LoadAll(void)
+  {
+    for (uint i = 0; i < mClassCache.Size(); ++i)
+      GetClass(i);
+
+    for (uint i = 0; i < mEnumCache.Size(); ++i)
+      MaterializeEnum(BinaryDocSection::Enums, i, mEnumCache, mLibrary->mEnums);
+
+    for (uint i = 0; i < mFlagsCache.Size(); ++i)
+      MaterializeEnum(BinaryDocSection::Flags, i, mFlagsCache, mLibrary->mFlags);
+
+    // the library lists docs in the order they were first accessed, put them in file order.
+    // A class with a corrupt index entry never materializes and is left out.
+    mLibrary->mClasses.Clear();
+    forRange(ClassDoc* classDoc, mClassCache.All())
+    {
+      if (classDoc)
+        mLibrary->mClasses.PushBack(classDoc);
+    }
+    mLibrary->mEnums = mEnumCache;
+    mLibrary->mFlags = mFlagsCache;
+
+    return *mLibrary;
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "SectionedFile.hpp"
+
+namespace Zero
+{
+  class DocumentationLibrary;
+  class ClassDoc;
+  class EnumDoc;
+
+  /// Saves the trimmed library in the binary layout BinaryTrimDocReader maps: a header of
+  /// section offsets, flat records for every doc type, an index of class records sorted by
+  /// name and one string table every record points into.
+  bool SaveTrimDocToBinaryFile(DocumentationLibrary &lib, StringParam absPath);
+
+  /// Maps a binary trimmed documentation file and only builds the docs that are asked for.
+  /// Every doc it returns is owned by the reader and stays valid until Close.
+  class BinaryTrimDocReader
+  {
+  public:
+    BinaryTrimDocReader();
+    ~BinaryTrimDocReader();
+
+    /// maps the file and validates the header, nothing is materialized yet
+    bool Open(StringParam absPath);
+
+    /// unmaps the file and deletes every doc that was materialized
+    void Close(void);
+
+    bool IsOpen(void) const { return mFile.IsOpen(); }
+
+    /// number of classes in the file, indices are in class name order
+    uint GetClassCount(void) const;
+
+    /// name of the class at index, read straight out of the mapped file
+    const char* GetClassNameAtIndex(uint index) const;
+
+    /// materializes the class at index (with its methods, properties and events) on first access
+    ClassDoc* GetClass(uint index);
+
+    /// binary searches the class index, returns null if there is no class named className
+    ClassDoc* FindClass(StringParam className);
+
+    /// returns the enum or flags named name, materialized on first access, null if missing
+    EnumDoc* FindEnum(StringParam name);
+    EnumDoc* FindFlags(StringParam name);
+
+    /// materializes everything left and returns a library equivalent to what the text loader
+    /// builds from the same documentation, with classes in name order. Has to be open.
+    DocumentationLibrary& LoadAll(void);
+
+  private:
+    EnumDoc* MaterializeEnum(uint section, uint index, Array<EnumDoc*>& cache, Array<EnumDoc*>& libraryList);
+
+    /// finds the record index of the enum named name in section, -1 if it is not there
+    uint FindEnumRecord(uint section, StringParam name) const;
+
+    SectionedFileReader mFile;
+
+    // everything materialized so far is owned by this library
+    DocumentationLibrary* mLibrary;
+
+    // materialized docs by record index, null until they are first accessed
+    Array<ClassDoc*> mClassCache;
+    Array<EnumDoc*> mEnumCache;
+    Array<EnumDoc*> mFlagsCache;
+  };
+}
@@ -3,6 +3,7 @@
 #include "TypeBlackList.hpp"
 #include "Serialization/Simple.hpp"
 #include "Platform/FileSystem.hpp"
+#include "DocOutputSink.hpp"
 
 namespace Zero
 {
@@ -10,7 +11,7 @@ namespace Zero
   {
   }
 
-  TypeBlacklist::TypeBlacklist(StringParam filename) : Object()
+  TypeBlacklist::TypeBlacklist(StringParam filename) : Object(), mFoldedFromCount((uint)-1)
   {
     LoadFromFile(filename);
   }
@@ -18,11 +19,13 @@ namespace Zero
   void TypeBlacklist::operator=(TypeBlacklist& blacklist)
   {
     this->mTypeNames = blacklist.mTypeNames;
+    mFoldedFromCount = (uint)-1;
   }
 
   void TypeBlacklist::Serialize(Serializer& stream)
   {
     SerializeName(mTypeNames);
+    mFoldedFromCount = (uint)-1;
   }
 
 
@@ -44,6 +47,7 @@ namespace Zero
     loader.GetPolymorphic(dummyNode);
 
     loader.SerializeField("HashSet", mTypeNames);
+    mFoldedFromCount = (uint)-1;
 
     loader.Close();
 
@@ -52,17 +56,9 @@ namespace Zero
 
   bool TypeBlacklist::SaveToFile(StringParam fileName)
   {
-    Status status;
-
     TextSaver saver;
 
-    saver.Open(status, fileName.c_str());
-    if (status.Failed())
-    {
-      Error(status.Message.c_str());
-      return false;
-    }
-
+    saver.OpenBuffer();
 
     saver.StartPolymorphic("TypeBlacklist");
 
@@ -70,15 +66,73 @@ namespace Zero
 
     saver.EndPolymorphic();
 
-    saver.Close();
+    return DocOutputSink::Get()->WriteSaver(fileName, saver);
+  }
 
-    return true;
+
+  // compares as if both strings were lower case
+  static int CompareFolded(const char* lhs, uint lhsLength, const char* rhs, uint rhsLength)
+  {
+    uint length = Math::Min(lhsLength, rhsLength);
+
+    for (uint i = 0; i < length; ++i)
+    {
+      int lhsChar = tolower((unsigned char)lhs[i]);
+      int rhsChar = tolower((unsigned char)rhs[i]);
+
+      if (lhsChar != rhsChar)
+        return lhsChar < rhsChar ? -1 : 1;
+    }
+
+    if (lhsLength == rhsLength)
+      return 0;
+
+    return lhsLength < rhsLength ? -1 : 1;
   }
 
+  void TypeBlacklist::FoldTypeNames(void)
+  {
+    mFoldedNames.Clear();
+
+    forRange(const String& name, mTypeNames.All())
+    {
+      mFoldedNames.PushBack(name.ToLower());
+    }
+
+    Sort(mFoldedNames.All());
+
+    mFoldedFromCount = mTypeNames.Size();
+  }
 
   bool TypeBlacklist::isOnBlacklist(StringParam typeName)
   {
-    return mTypeNames.Contains(typeName.ToLower());
+    if (mFoldedFromCount != mTypeNames.Size())
+      FoldTypeNames();
+
+    const char* name = typeName.c_str();
+    uint nameLength = typeName.SizeInBytes();
+
+    // binary search the folded names
+    uint low = 0;
+    uint high = mFoldedNames.Size();
+
+    while (low < high)
+    {
+      uint middle = low + (high - low) / 2;
+      const String& folded = mFoldedNames[middle];
+
+      int comparison = CompareFolded(folded.c_str(), folded.SizeInBytes(), name, nameLength);
+
+      if (comparison == 0)
+        return true;
+
+      if (comparison < 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+    return false;
   }
 
 }
\ No newline at end of file
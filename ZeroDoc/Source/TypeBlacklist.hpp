@@ -7,7 +7,7 @@ namespace Zero
   public:
     ZilchDeclareType(TypeCopyMode::ReferenceType);
 
-    TypeBlacklist() : Object(){}
+    TypeBlacklist() : Object(), mFoldedFromCount((uint)-1) {}
 
     void operator=(TypeBlacklist& blacklist);
 
@@ -19,8 +19,17 @@ namespace Zero
 
     bool SaveToFile(StringParam fileName);
 
+    /// case insensitive, does not allocate once the folded name list is built
     bool isOnBlacklist(StringParam typeName);
   //private:
     HashSet<String> mTypeNames;
+
+  private:
+    /// rebuilds mFoldedNames from mTypeNames
+    void FoldTypeNames(void);
+
+    // lower cased and sorted copy of mTypeNames so lookups can binary search without ToLower
+    Array<String> mFoldedNames;
+    uint mFoldedFromCount;
   };
 }
\ No newline at end of file
@@ -1,542 +1,654 @@
 #include "Precompiled.hpp"
-//
-//#include "WikiOperations.hpp"
-//
-//#define CURL_STATICLIB
-//
-//#include <curl/curl.h>
-//#include "Common/String/CharacterTraits.hpp"
-//#include "Support/StringMap.hpp"
-//#include "Engine/EngineContainers.hpp"
-//#include "Platform/FilePath.hpp"
-//#include "Serialization/Text.hpp"
-//#include "../TinyXml/tinyxml.h"
-//#include "Configuration.hpp"
-//#include "Pages.hpp"
-//#include "Platform/FileSystem.hpp"
-//#include "Serialization/Simple.hpp"
-//#include "Logging.hpp"
-//
-//#pragma comment(lib, "ws2_32.lib") 
-//#pragma comment(lib, "Wldap32.lib") 
-//
-//namespace Zero
-//{
-//
-////------------------------------------------------------------------- Write Data
-//struct WriteData
-//{
-//  virtual void Start() {};
-//  virtual void End() {};
-//
-//  virtual void Parse(const char* data, uint sizeOfChar, uint numOfElements)
-//  {
-//    if(mVerbose)
-//      printf("%s",data);
-//  }
-//
-//  bool mVerbose;
-//};
-//
-////---------------------------------------------------------------- Buffered Data
-//struct BufferedData : public WriteData
-//{
-//  void Start() override{};
-//  void End() override{};
-//
-//  void Parse(const char* data, uint sizeOfChar, uint numOfElements) override
-//  {
-//    WriteData::Parse(data,sizeOfChar,numOfElements);
-//
-//    String str = String(data,numOfElements * sizeOfChar);
-//    mBuilder.Append(str);
-//  }
-//
-//  Zero::StringBuilder mBuilder;
-//};
-//
-////----------------------------------------------------------------- Token Parser
-//struct TokenParser : public WriteData
-//{
-//  void Start() override
-//  {
-//    mValid = false;
-//  };
-//
-//  void End() override {};
-//
-//  void Parse(const char* data, uint sizeOfChar, uint numOfElements) override
-//  {
-//    WriteData::Parse(data,sizeOfChar,numOfElements);
-//
-//    Zero::String str = Zero::String::Format("%s",data);
-//    if(str.Size() < 8)
-//      return;
-//
-//    if(str.SubStringFromByteIndices(0,7) == Zero::String("<token>"))
-//    {
-//      mToken = str.SubStringFromByteIndices(16,30);
-//      mValid = true;
-//    }
-//  }
-//
-//  Zero::String mToken;
-//  bool mValid;
-//};
-//
-//static size_t write_data(void *ptr, size_t sizeOfChar, size_t numOfElements, void *stream)
-//{
-//  //int written = fwrite(ptr, size, nmemb, (FILE *)stream);
-//  //return written;
-//  const char* data = (const char*)ptr;
-//  if(stream != NULL)
-//  {
-//    WriteData* writeData = static_cast<WriteData*>(stream);
-//    writeData->Parse(data,sizeOfChar,numOfElements);
-//  }
-//
-//  return sizeOfChar*numOfElements;
-//}
-//
-//void LogOn(String& token, bool verbose)
-//{
-//  CURL *curl;
-//  CURLcode res;
-//
-//  curl_global_init(CURL_GLOBAL_DEFAULT);
-//  curl = curl_easy_init();
-//
-//  TokenParser tokenParser;
-//  tokenParser.mVerbose = verbose;
-//
-//  String loginUrl = "http://zeroengine0.digipen.edu/api.asp?"
-//                    "cmd=logon&email=LevelDesigner2D&password=letmein";
-//  if(verbose)
-//    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
-//
-//  curl_easy_setopt(curl, CURLOPT_URL,loginUrl.c_str());
-//  curl_easy_setopt(curl, CURLOPT_WRITEDATA,&tokenParser);
-//
-//  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-//  res = curl_easy_perform(curl);
-//
-//  if(res != CURLE_OK)
-//    printf("Failed to log in.\n");
-//
-//  if(tokenParser.mValid)
-//    token = tokenParser.mToken;
-//  else
-//    printf("Failed to parse a valid token after logging in.\n");
-//
-//  /* always cleanup */ 
-//  curl_easy_cleanup(curl);
-//}
-//
-//void LogOff(StringParam token, bool verbose)
-//{
-//  CURL *curl;
-//  CURLcode res;
-//
-//  curl_global_init(CURL_GLOBAL_DEFAULT);
-//
-//  curl = curl_easy_init();
-//
-//  String logoffUrl = Zero::BuildString("http://zeroengine0.digipen.edu/api.asp?"
-//                                       "cmd=logoff&token=", token.c_str());
-//
-//  WriteData parser;
-//  parser.mVerbose = verbose;
-//
-//  if(verbose)
-//    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
-//
-//  curl_easy_setopt(curl, CURLOPT_URL,logoffUrl.c_str());
-//  curl_easy_setopt(curl, CURLOPT_WRITEDATA,&parser);
-//
-//  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-//  res = curl_easy_perform(curl);
-//
-//  if(res != CURLE_OK)
-//    printf("Failed to log off.\n");
-//
-//  /* always cleanup */ 
-//  curl_easy_cleanup(curl);
-//}
-//
-//void GetWikiArticleIds(StringParam token, StringMap& wikiIndices, bool verbose)
-//{
-//  CURL *curl;
-//  CURLcode res;
-//
-//  curl_global_init(CURL_GLOBAL_DEFAULT);
-//
-//  curl = curl_easy_init();
-//
-//  String url = String::Format("http://zeroengine0.digipen.edu/api.asp?"
-//                              "cmd=listArticles&ixWiki=1&token=%s", 
-//                              token.c_str());
-//
-//  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-//  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-//  if(verbose)
-//    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
-//
-//  BufferedData parser;
-//  parser.mVerbose = false;
-//  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &parser);
-//
-//  res = curl_easy_perform(curl);
-//
-//  String str = parser.mBuilder.ToString();
-//
-//  TiXmlDocument doc;
-//  doc.Parse(str.c_str());
-//
-//  TiXmlElement* response = doc.FirstChildElement("response");
-//  TiXmlElement* articles = response->FirstChildElement("articles");
-//
-//  TiXmlNode* article;
-//  for(article = articles->FirstChild(); article != 0; article = article->NextSibling())
-//  {
-//    TiXmlNode* wikiIdTag = article->FirstChildElement("ixWikiPage");
-//    TiXmlText* wikiIdData = (TiXmlText*)wikiIdTag->FirstChild();
-//
-//    TiXmlNode* headlineTag = wikiIdTag->NextSiblingElement("sHeadline");
-//    TiXmlText* headlineData = (TiXmlText*)headlineTag->FirstChild();
-//
-//    String id = wikiIdData->Value();
-//    String pageName = headlineData->Value();
-//
-//    wikiIndices[pageName] = id;
-//  }
-//
-//  /* always cleanup */ 
-//  curl_easy_cleanup(curl);
-//}
-//
-//bool CreateWikiPage(StringParam token, StringParam pageName, 
-//                    StringParam parentPageIndex, StringMap& wikiIndices, bool verbose)
-//{
-//  CURL *curl;
-//  CURLcode res;
-//
-//  curl_global_init(CURL_GLOBAL_DEFAULT);
-//
-//  curl = curl_easy_init();
-//
-//  String url = String::Format("http://zeroengine0.digipen.edu/api.asp?"
-//                              "cmd=newArticle&ixWiki=1&sHeadline=%s&token=%s", 
-//                              pageName.c_str(), token.c_str());
-//
-//  curl_easy_setopt(curl, CURLOPT_URL,url.c_str());
-//  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-//  if(verbose)
-//    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
-//
-//  BufferedData parser;
-//  parser.mVerbose = false;
-//  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &parser);
-//
-//  res = curl_easy_perform(curl);
-//
-//  String str = parser.mBuilder.ToString();
-//
-//  TiXmlDocument doc;
-//  doc.Parse(str.c_str());
-//
-//  TiXmlElement* response = doc.FirstChildElement("response");
-//  if(response == NULL)
-//  {
-//    printf("Failed to find response tag for page %s\n",pageName.c_str());
-//    return false;
-//  }
-//
-//  TiXmlElement* wikipage = response->FirstChildElement("wikipage");
-//  if(wikipage == NULL)
-//  {
-//    printf("Failed to find wikipage tag for page %s\n",pageName.c_str());
-//    return false;
-//  }
-//  TiXmlElement* wikiPageIndex = wikipage->FirstChildElement("ixWikiPage");
-//  if(wikiPageIndex == NULL)
-//  {
-//    printf("Failed to find ixWikiPage tag for page %s\n",pageName.c_str());
-//    return false;
-//  }
-//
-//  TiXmlText* wikiIdData = (TiXmlText*)wikiPageIndex->FirstChild();
-//  if(wikiIdData == NULL)
-//  {
-//    printf("Failed to find wiki page id for new page %s\n",pageName.c_str());
-//    return false;
-//  }
-//
-//  String id = wikiIdData->Value();
-//  wikiIndices[pageName] = id;
-//
-//  /* always cleanup */ 
-//  curl_easy_cleanup(curl);
-//
-//  return true;
-//}
-//
-//void UploadClassDoc(StringParam index, ClassDoc& classDoc, Replacements& replacements, 
-//                    StringParam token, bool verbose)
-//{
-//  CURL *curl;
-//  CURLcode res;
-//
-//  curl_global_init(CURL_GLOBAL_DEFAULT);
-//
-//  curl = curl_easy_init();
-//
-//  String url = String::Format("http://zeroengine0.digipen.edu/api.asp?"
-//                              "cmd=editArticle&ixWikiPage=%s&token=%s", 
-//                              index.c_str(), token.c_str());
-//
-//  curl_easy_setopt(curl, CURLOPT_URL,url.c_str());
-//
-//  curl_httppost* post = NULL;
-//  curl_httppost* last = NULL;
-//
-//  String doc = BuildDoc(classDoc, replacements);
-//
-//  curl_formadd(&post, &last, CURLFORM_COPYNAME, "sHeadline", 
-//               CURLFORM_COPYCONTENTS, classDoc.Name.c_str(), CURLFORM_END);
-//
-//  curl_formadd(&post, &last, CURLFORM_COPYNAME, "sBody", 
-//               CURLFORM_PTRCONTENTS, doc.c_str(),
-//               CURLFORM_CONTENTSLENGTH, doc.Size(),
-//               CURLFORM_CONTENTTYPE, "text/html", CURLFORM_END);
-//
-//  /* Set the form info */
-//  curl_easy_setopt(curl, CURLOPT_HTTPPOST, post);
-//
-//  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-//
-//  WriteData parser;
-//  parser.mVerbose = verbose;
-//  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &parser);
-//
-//  if(verbose)
-//    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
-//
-//  res = curl_easy_perform(curl);
-//
-//  if(res != CURLE_OK)
-//    printf("Failed to upload class doc %s.\n",classDoc.Name.c_str());
-//
-//  /* always cleanup */ 
-//  curl_easy_cleanup(curl);
-//}
-//
-//void UploadPageContent(StringParam pageIndex, StringParam pageTitle, 
-//                       StringParam pageContent, StringParam token, bool verbose)
-//{
-//  CURL *curl;
-//  CURLcode res;
-//
-//  curl_global_init(CURL_GLOBAL_DEFAULT);
-//
-//  curl = curl_easy_init();
-//
-//  String url = String::Format("http://zeroengine0.digipen.edu/api.asp?"
-//                              "cmd=editArticle&ixWikiPage=%s&token=%s", 
-//                              pageIndex.c_str(), token.c_str());
-//
-//  curl_easy_setopt(curl, CURLOPT_URL,url.c_str());
-//
-//  curl_httppost* post = NULL;
-//  curl_httppost* last = NULL;
-//
-//  //String doc = BuildDoc(classDoc, replacements);
-//
-//
-//  curl_formadd(&post, &last, CURLFORM_COPYNAME, "sHeadline", 
-//               CURLFORM_COPYCONTENTS, pageTitle.c_str(), CURLFORM_END);
-//
-//  curl_formadd(&post, &last, CURLFORM_COPYNAME, "sBody", 
-//               CURLFORM_PTRCONTENTS, pageContent.c_str(),
-//               CURLFORM_CONTENTSLENGTH, pageContent.Size(),
-//               CURLFORM_CONTENTTYPE, "text/html", CURLFORM_END);
-//
-//  /* Set the form info */
-//  curl_easy_setopt(curl, CURLOPT_HTTPPOST, post);
-//
-//  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-//
-//  WriteData parser;
-//  parser.mVerbose = verbose;
-//  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &parser);
-//
-//  if(verbose)
-//    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
-//
-//  res = curl_easy_perform(curl);
-//
-//  if(res != CURLE_OK)
-//    printf("Failed to upload class doc %s.\n", pageTitle.c_str());
-//
-//  /* always cleanup */ 
-//  curl_easy_cleanup(curl);
-//}
-//
-//
-//
-//void UpdateEventList(StringMap& params, Replacements& replacements, 
-//  StringBuilder* outputString)
-//{
-//  Configurations config = LoadConfigurations(params);
-//
-//  Array<EventEntry> eventsToUpdate;
-//  TextLoader stream;
-//  String eventsToUpdatePath = config.EventsFile;
-//  if(!FileExists(eventsToUpdatePath.c_str()))
-//  {
-//    printf("%s does not exist.", eventsToUpdatePath.c_str());
-//    return;
-//  }
-//  Status status;
-//  stream.Open(status, eventsToUpdatePath.c_str());
-//  SerializeName(eventsToUpdate);
-//  stream.Close();
-//
-//  //Create the HTML for page that hosts the list of events.
-//  String eventHeader("");
-//  StringBuilder eventListHtml;
-//  outputString->Append("<p>");
-//  forRange(Array<EventEntry>::value_type& e, eventsToUpdate.All())
-//  {
-//    if(eventHeader != e.mEventType)
-//    {
-//      if(eventHeader != "") outputString->Append("</ul>");
-//      eventHeader = e.mEventType;
-//      outputString->Append("<h3>");
-//      Replace(*outputString, replacements, e.mEventType);
-//      outputString->Append("</h3>");
-//      outputString->Append("<ul>");
-//    }
-//    outputString->Append("<li>");
-//    Replace(*outputString, replacements, e.mEventName);
-//    outputString->Append("</li>");
-//
-//  }
-//  eventListHtml.Append("</p>");
-//
-//
-//}
-//
-//void PushToWiki(StringMap& params)
-//{
-//  Configurations config = LoadConfigurations(params);
-//
-//  //There's a set list of classes we want to push to the wiki, load this list from a data file
-//  Array<WikiUpdatePage> pagesToUpdate;
-//  TextLoader stream;
-//  String pagesToUpdatePath = BuildString(config.SourcePath.c_str(), 
-//    "DevTools\\PagesToUpdate.txt");
-//  if(!FileExists(pagesToUpdatePath))
-//  {
-//    printf("%s does not exist.",pagesToUpdatePath.c_str());
-//    return;
-//  }
-//
-//  Status status;
-//  stream.Open(status, pagesToUpdatePath.c_str());
-//  SerializeName(pagesToUpdate);
-//  stream.Close();
-//
-//  //Now load the documentation file (the documentation for all the classes)
-//  if(!FileExists(config.DocumentationFile.c_str()))
-//  {
-//    printf("%s does not exist.",config.DocumentationFile.c_str());
-//    return;
-//  }
-//
-//  DocumentationLibrary doc;
-//  LoadFromDataFile(doc, config.DocumentationFile);
-//  doc.Build();
-//
-//  //Warn for classes that have documentation but are not parked to push to the wiki
-//  WarnNeedsWikiPage(pagesToUpdate, doc.Classes, config.mDoxygenPath, 
-//    config.DocumentationRoot, config.Verbose, config.Log);
-//
-//  //Log onto the wiki and get our token to use for further operations
-//  String token;
-//  LogOn(token,config.Verbose);
-//
-//  //Extract the wiki article names and their indices from the wiki
-//  StringMap wikiIndices;
-//  GetWikiArticleIds(token, wikiIndices, config.Verbose);
-//
-//  //Create a map of the wiki names and ids for only what we want to push to the wiki.
-//  typedef StringMap WikiMap;
-//  WikiMap wikiIndex;
-//  for(uint i = 0; i < pagesToUpdate.Size(); ++i)
-//  {
-//    String pageName = pagesToUpdate[i].mPageToUpdate;
-//    String parentPageName = pagesToUpdate[i].mParentPage;
-//    String index = wikiIndices.FindValue(pageName,"");
-//    if(!index.Empty())
-//      wikiIndex[pageName] = index;
-//    else
-//    {
-//      String parentIndex = wikiIndices.FindValue(parentPageName,"");
-//      if(!parentIndex.Empty())
-//      {
-//        bool success = CreateWikiPage(token,pageName,parentIndex,wikiIndex,config.Verbose);
-//        if(!success)
-//          printf("Failed to find wiki article for \"%s\" with parent \"%s\"\n",
-//          pageName.c_str(), parentPageName.c_str());
-//        else
-//          printf("Creating wiki page for article \"%s\"\n",pageName.c_str());
-//      }
-//      else
-//        printf("Failed to find wiki parent article \"%s\" for child page \"%s\"\n",
-//        parentPageName.c_str(), pageName.c_str());
-//    }
-//  }
-//
-//  //set up a replacement for class names to replace in the wiki, this will set
-//  //up links on the page to other classes when they are referenced
-//  Array<Replacement> classReplacements;
-//  WikiMap::range r = wikiIndex.All();
-//  forRange(WikiMap::value_type& v, r)
-//  {
-//    String name = BuildString(v.first, "");
-//    String link = String::Format("<a class=\"uvb\" href=\"default.asp?W%s\">%s</a>", 
-//      v.second.c_str(), v.first.c_str());
-//    classReplacements.PushBack(Replacement(name, link));
-//  }
-//  Sort(classReplacements.All());
-//
-//  //Update all of the events on the event page, link relevant pages to them.
-//  StringBuilder eventList;
-//  UpdateEventList(params, classReplacements, &eventList);
-//  const String eventListPageTitle("Event List");
-//  const String eventListPage = wikiIndices[eventListPageTitle.c_str()];
-//  UploadPageContent(eventListPage, eventListPageTitle, eventList.ToString(), 
-//    token, config.Verbose);
-//
-//  //Upload the class' page to the wiki, making sure to perform the link replacements
-//  forRange(ClassDoc& classDoc, doc.Classes.All())
-//  {
-//    String index = wikiIndex.FindValue(classDoc.Name, "");
-//    if(!index.Empty())
-//    {
-//      //should uncomment when testing (so we don't accidentally destroy the whole wiki)
-//      //if(classDoc.Name == "PhysicsEffect")
-//      UploadClassDoc(index, classDoc, classReplacements, token, config.Verbose);
-//    }
-//    else
-//    {
-//      //fprintf(f,"need page %s\r\n", classDoc.Name.c_str() );
-//      //printf("need page %s\n", classDoc.Name.c_str());
-//    }
-//  }
-//
-//  LogOff(token,config.Verbose);
-//}
-//
-//}//namespace Zero
-//
+
+#include "WikiOperations.hpp"
+
+#define CURL_STATICLIB
+
+#include <string>
+#include <curl/curl.h>
+#include "Support/StringMap.hpp"
+#include "Engine/EngineContainers.hpp"
+#include "../TinyXml/tinyxml.h"
+#include "Platform/FileSystem.hpp"
+#include "DocConfiguration.hpp"
+#include "RawDocumentation.hpp"
+
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "Wldap32.lib")
+
+namespace Zero
+{
+
+DeclareEnum5(WikiCommand, LogOn, LogOff, ListArticles, NewArticle, EditArticle);
+
+// retries never wait longer than this no matter how often a request failed
+const uint cMaxRetryDelayMs = 10000;
+
+static cstr GetWikiCommandName(WikiCommand::Enum command)
+{
+  switch (command)
+  {
+  case WikiCommand::LogOn: return "logon";
+  case WikiCommand::LogOff: return "logoff";
+  case WikiCommand::ListArticles: return "listArticles";
+  case WikiCommand::NewArticle: return "newArticle";
+  case WikiCommand::EditArticle: return "editArticle";
+  }
+  return "unknown";
+}
+
+//------------------------------------------------------------------- Settings
+WikiPublishSettings::WikiPublishSettings()
+  : mMaxInFlight(8)
+  , mMaxRetries(3)
+  , mRetryDelayMs(250)
+  , mVerbose(false)
+{
+}
+
+//---------------------------------------------------------------------- Stats
+WikiPublishStats::WikiPublishStats()
+  : mRequests(0)
+  , mSucceeded(0)
+  , mFailed(0)
+  , mRetries(0)
+  , mConnections(0)
+  , mBytesSent(0.0)
+  , mBytesReceived(0.0)
+  , mBusyTime(0.0)
+{
+}
+
+void WikiPublishStats::Print(void) const
+{
+  double seconds = Math::Max(mBusyTime / 1000.0, 0.001);
+
+  printf("wiki publish: %u requests, %u succeeded, %u failed, %u retries\n",
+    mRequests, mSucceeded, mFailed, mRetries);
+  printf("  connections opened:  %u (%u requests reused one)\n",
+    mConnections, mRequests > mConnections ? mRequests - mConnections : 0);
+  printf("  throughput:          %10.1f requests/s, %.2f MB/s sent\n",
+    mSucceeded / seconds, mBytesSent / (1024.0 * 1024.0) / seconds);
+  printf("  time:                %10.3f ms\n", mBusyTime);
+
+  if (mLatencies.Empty())
+    return;
+
+  Array<double> latencies = mLatencies;
+  std::sort(latencies.Data(), latencies.Data() + latencies.Size());
+
+  uint size = latencies.Size();
+  printf("  p50 round trip:      %10.3f ms\n", latencies[size / 2]);
+  printf("  p99 round trip:      %10.3f ms\n", latencies[Math::Min(size - 1, (size * 99) / 100)]);
+}
+
+//-------------------------------------------------------------------- Request
+struct WikiPublisher::Request
+{
+  Request(WikiCommand::Enum command)
+    : mCommand(command)
+    , mForm(nullptr)
+    , mAttempts(0)
+    , mReadyTime(0.0)
+  {
+  }
+
+  ~Request()
+  {
+    if (mForm)
+      curl_formfree(mForm);
+  }
+
+  /// what the request is for, safe to print. The url carries the password or the token
+  String Describe(void) const
+  {
+    if (mTitle.Empty())
+      return GetWikiCommandName(mCommand);
+
+    return BuildString(GetWikiCommandName(mCommand), " '", mTitle, "'");
+  }
+
+  WikiCommand::Enum mCommand;
+  String mUrl;
+  /// the headline the request is about, for creating and editing articles
+  String mTitle;
+  /// the page body, the form only points at it
+  String mBody;
+  curl_httppost* mForm;
+
+  uint mAttempts;
+  /// a request waiting out a backoff is not sent before this
+  double mReadyTime;
+
+  std::string mResponse;
+};
+
+static size_t WriteResponse(void* data, size_t size, size_t count, void* userData)
+{
+  std::string* response = (std::string*)userData;
+  response->append((const char*)data, size * count);
+  return size * count;
+}
+
+//------------------------------------------------------------------ Publisher
+WikiPublisher::WikiPublisher(const WikiPublishSettings& settings)
+  : mSettings(settings)
+  , mArticleIds(nullptr)
+  , mInFlight(0)
+  , mBusyStart(-1.0)
+{
+  mSettings.mMaxInFlight = Math::Max(mSettings.mMaxInFlight, 1u);
+
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+  mMulti = curl_multi_init();
+
+  // pages are large enough that curl would wait for a 100 Continue before sending every one
+  mFormHeaders = curl_slist_append(nullptr, "Expect:");
+
+  // one open connection per request on the wire, so none of them has to be dropped
+  curl_multi_setopt(mMulti, CURLMOPT_MAXCONNECTS, (long)mSettings.mMaxInFlight);
+}
+
+WikiPublisher::~WikiPublisher()
+{
+  // anything still going is abandoned
+  forRange(CURL* handle, mAllHandles.All())
+  {
+    // idle handles no longer point at a request
+    Request* request = nullptr;
+    curl_easy_getinfo(handle, CURLINFO_PRIVATE, (char**)&request);
+    delete request;
+
+    curl_multi_remove_handle(mMulti, handle);
+    curl_easy_cleanup(handle);
+  }
+
+  for (uint i = 0; i < mWaiting.Size(); ++i)
+    delete mWaiting[i];
+
+  curl_slist_free_all(mFormHeaders);
+  curl_multi_cleanup(mMulti);
+  curl_global_cleanup();
+}
+
+String WikiPublisher::Escape(StringParam text)
+{
+  char* escaped = curl_easy_escape(nullptr, text.c_str(), (int)text.SizeInBytes());
+  String result = escaped;
+  curl_free(escaped);
+  return result;
+}
+
+String WikiPublisher::BuildUrl(cstr command, StringParam arguments)
+{
+  if (mToken.Empty())
+    return BuildString(mSettings.mApiUrl, "?cmd=", command, arguments);
+
+  return BuildString(mSettings.mApiUrl, "?cmd=", command, arguments, "&token=", mToken);
+}
+
+bool WikiPublisher::LogOn(void)
+{
+  mToken = String();
+
+  Request* request = new Request(WikiCommand::LogOn);
+  request->mUrl = BuildUrl("logon", BuildString("&email=", Escape(mSettings.mEmail),
+    "&password=", Escape(mSettings.mPassword)));
+  Queue(request);
+
+  Finish();
+
+  if (mToken.Empty())
+  {
+    printf("Failed to log on to %s.\n", mSettings.mApiUrl.c_str());
+    return false;
+  }
+  return true;
+}
+
+void WikiPublisher::LogOff(void)
+{
+  if (mToken.Empty())
+    return;
+
+  Request* request = new Request(WikiCommand::LogOff);
+  request->mUrl = BuildUrl("logoff", String());
+  Queue(request);
+
+  Finish();
+  mToken = String();
+}
+
+bool WikiPublisher::GetWikiArticleIds(StringMap& wikiIndices)
+{
+  mArticleIds = &wikiIndices;
+
+  Request* request = new Request(WikiCommand::ListArticles);
+  request->mUrl = BuildUrl("listArticles", "&ixWiki=1");
+  Queue(request);
+
+  bool succeeded = Finish();
+  mArticleIds = nullptr;
+  return succeeded;
+}
+
+void WikiPublisher::QueueCreatePage(StringParam pageName)
+{
+  Request* request = new Request(WikiCommand::NewArticle);
+  request->mTitle = pageName;
+  request->mUrl = BuildUrl("newArticle", BuildString("&ixWiki=1&sHeadline=", Escape(pageName)));
+  Queue(request);
+}
+
+void WikiPublisher::QueueUploadPage(StringParam pageIndex, StringParam pageTitle,
+  StringParam pageContent)
+{
+  Request* request = new Request(WikiCommand::EditArticle);
+  request->mTitle = pageTitle;
+  request->mBody = pageContent;
+  request->mUrl = BuildUrl("editArticle", BuildString("&ixWikiPage=", pageIndex));
+
+  // the form is built once and sent again as is if the request is retried
+  curl_httppost* last = nullptr;
+  curl_formadd(&request->mForm, &last, CURLFORM_COPYNAME, "sHeadline",
+    CURLFORM_COPYCONTENTS, request->mTitle.c_str(), CURLFORM_END);
+
+  curl_formadd(&request->mForm, &last, CURLFORM_COPYNAME, "sBody",
+    CURLFORM_PTRCONTENTS, request->mBody.c_str(),
+    CURLFORM_CONTENTSLENGTH, (long)request->mBody.SizeInBytes(),
+    CURLFORM_CONTENTTYPE, "text/html", CURLFORM_END);
+
+  Queue(request);
+}
+
+void WikiPublisher::Queue(Request* request)
+{
+  if (mBusyStart < 0.0)
+    mBusyStart = GetDocTimeMs();
+
+  mWaiting.PushBack(request);
+
+  // get it on the wire right away if there is room, the caller keeps queuing meanwhile
+  Pump(false);
+}
+
+bool WikiPublisher::Finish(void)
+{
+  uint failedBefore = mStats.mFailed;
+
+  while (!mWaiting.Empty() || mInFlight > 0)
+    Pump(true);
+
+  if (mBusyStart >= 0.0)
+  {
+    mStats.mBusyTime += GetDocTimeMs() - mBusyStart;
+    mBusyStart = -1.0;
+  }
+
+  return mStats.mFailed == failedBefore;
+}
+
+void WikiPublisher::Pump(bool wait)
+{
+  StartReadyRequests();
+
+  if (wait)
+    WaitForActivity();
+
+  int running = 0;
+  while (curl_multi_perform(mMulti, &running) == CURLM_CALL_MULTI_PERFORM)
+    continue;
+
+  int messagesLeft = 0;
+  while (CURLMsg* message = curl_multi_info_read(mMulti, &messagesLeft))
+  {
+    if (message->msg != CURLMSG_DONE)
+      continue;
+
+    // the message goes away once the handle is removed
+    CURL* handle = message->easy_handle;
+    CURLcode result = message->data.result;
+    CompleteRequest(handle, result);
+  }
+
+  // finished requests freed up room
+  StartReadyRequests();
+}
+
+void WikiPublisher::StartReadyRequests(void)
+{
+  double now = GetDocTimeMs();
+
+  for (uint i = 0; i < mWaiting.Size() && mInFlight < mSettings.mMaxInFlight;)
+  {
+    Request* request = mWaiting[i];
+
+    if (request->mReadyTime > now)
+    {
+      ++i;
+      continue;
+    }
+
+    mWaiting.EraseAt(i);
+
+    CURL* handle = nullptr;
+    if (!mIdleHandles.Empty())
+    {
+      handle = mIdleHandles.Back();
+      mIdleHandles.PopBack();
+      // drops the options of the last request but keeps its connection
+      curl_easy_reset(handle);
+    }
+    else
+    {
+      handle = curl_easy_init();
+      mAllHandles.PushBack(handle);
+    }
+
+    request->mResponse.clear();
+    ++request->mAttempts;
+
+    curl_easy_setopt(handle, CURLOPT_URL, request->mUrl.c_str());
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, request);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteResponse);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &request->mResponse);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, 10L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, 60L);
+
+    if (request->mForm)
+    {
+      curl_easy_setopt(handle, CURLOPT_HTTPPOST, request->mForm);
+      curl_easy_setopt(handle, CURLOPT_HTTPHEADER, mFormHeaders);
+    }
+
+    // curl prints the request line, and the logon url carries the password
+    if (mSettings.mVerbose && request->mCommand != WikiCommand::LogOn)
+      curl_easy_setopt(handle, CURLOPT_VERBOSE, 1L);
+
+    curl_multi_add_handle(mMulti, handle);
+    ++mInFlight;
+    ++mStats.mRequests;
+  }
+}
+
+void WikiPublisher::WaitForActivity(void)
+{
+  double now = GetDocTimeMs();
+
+  // curl says when it needs to be called again, a request waiting out its backoff might be sooner
+  long waitMs = -1;
+  curl_multi_timeout(mMulti, &waitMs);
+  if (waitMs < 0 || waitMs > 100)
+    waitMs = 100;
+
+  if (mInFlight < mSettings.mMaxInFlight)
+  {
+    forRange(Request* request, mWaiting.All())
+    {
+      long untilReady = (long)Math::Max(request->mReadyTime - now, 0.0);
+      waitMs = Math::Min(waitMs, untilReady);
+    }
+  }
+
+  if (waitMs == 0)
+    return;
+
+  fd_set readSet;
+  fd_set writeSet;
+  fd_set exceptSet;
+  FD_ZERO(&readSet);
+  FD_ZERO(&writeSet);
+  FD_ZERO(&exceptSet);
+
+  int maxSocket = -1;
+  curl_multi_fdset(mMulti, &readSet, &writeSet, &exceptSet, &maxSocket);
+
+  // nothing to wait on yet (still resolving or waiting out a backoff), select would fail
+  if (maxSocket == -1)
+  {
+    Sleep((DWORD)waitMs);
+    return;
+  }
+
+  timeval timeout = { waitMs / 1000, (waitMs % 1000) * 1000 };
+  select(maxSocket + 1, &readSet, &writeSet, &exceptSet, &timeout);
+}
+
+void WikiPublisher::CompleteRequest(CURL* handle, int result)
+{
+  Request* request = nullptr;
+  curl_easy_getinfo(handle, CURLINFO_PRIVATE, (char**)&request);
+
+  long responseCode = 0;
+  long newConnections = 0;
+  double sent = 0.0;
+  double received = 0.0;
+  double totalTime = 0.0;
+  curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+  curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &newConnections);
+  curl_easy_getinfo(handle, CURLINFO_SIZE_UPLOAD, &sent);
+  curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD, &received);
+  curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &totalTime);
+
+  curl_multi_remove_handle(mMulti, handle);
+  curl_easy_setopt(handle, CURLOPT_PRIVATE, nullptr);
+  mIdleHandles.PushBack(handle);
+  --mInFlight;
+
+  mStats.mConnections += (uint)newConnections;
+  mStats.mBytesSent += sent;
+  mStats.mBytesReceived += received;
+
+  // the request never made it or the server could not handle it right now, try again later
+  bool transient = result != CURLE_OK || responseCode >= 500 || responseCode == 429;
+
+  // creating an article is not idempotent, a request that timed out or lost its answer may have
+  // made the article already. Only send it again if the wiki can not have acted on it
+  if (request->mCommand == WikiCommand::NewArticle)
+  {
+    transient = result == CURLE_COULDNT_CONNECT || result == CURLE_COULDNT_RESOLVE_HOST ||
+      (result == CURLE_OK && (responseCode == 429 || responseCode == 503));
+  }
+
+  if (transient && request->mAttempts <= mSettings.mMaxRetries)
+  {
+    uint doublings = Math::Min(request->mAttempts - 1, 16u);
+    uint delay = Math::Min(mSettings.mRetryDelayMs << doublings, cMaxRetryDelayMs);
+    request->mReadyTime = GetDocTimeMs() + delay;
+
+    if (mSettings.mVerbose)
+    {
+      printf("Retrying %s in %u ms (%s, http %d).\n", request->Describe().c_str(), delay,
+        curl_easy_strerror((CURLcode)result), (int)responseCode);
+    }
+
+    ++mStats.mRetries;
+    mWaiting.PushBack(request);
+    return;
+  }
+
+  bool succeeded = !transient && responseCode == 200 && HandleResponse(request);
+
+  if (succeeded)
+  {
+    ++mStats.mSucceeded;
+    mStats.mLatencies.PushBack(totalTime * 1000.0);
+  }
+  else
+  {
+    ++mStats.mFailed;
+
+    if (result != CURLE_OK)
+    {
+      printf("Failed to send %s: %s.\n", request->Describe().c_str(),
+        curl_easy_strerror((CURLcode)result));
+    }
+    else
+    {
+      printf("The wiki refused %s (http %d) after %u attempts.\n", request->Describe().c_str(),
+        (int)responseCode, request->mAttempts);
+    }
+  }
+
+  delete request;
+}
+
+bool WikiPublisher::HandleResponse(Request* request)
+{
+  TiXmlDocument doc;
+  doc.Parse(request->mResponse.c_str());
+
+  TiXmlElement* response = doc.FirstChildElement("response");
+  if (response == nullptr)
+    return false;
+
+  if (TiXmlElement* error = response->FirstChildElement("error"))
+  {
+    printf("Wiki error for %s: %s\n", request->Describe().c_str(),
+      error->GetText() ? error->GetText() : "");
+    return false;
+  }
+
+  switch (request->mCommand)
+  {
+  case WikiCommand::LogOn:
+  {
+    TiXmlElement* token = response->FirstChildElement("token");
+    if (token == nullptr || token->GetText() == nullptr)
+      return false;
+
+    mToken = token->GetText();
+    return true;
+  }
+
+  case WikiCommand::ListArticles:
+  {
+    TiXmlElement* articles = response->FirstChildElement("articles");
+    if (articles == nullptr)
+      return false;
+
+    for (TiXmlElement* article = articles->FirstChildElement(); article != nullptr;
+      article = article->NextSiblingElement())
+    {
+      TiXmlElement* wikiId = article->FirstChildElement("ixWikiPage");
+      TiXmlElement* headline = article->FirstChildElement("sHeadline");
+
+      if (wikiId == nullptr || headline == nullptr || !wikiId->GetText() || !headline->GetText())
+        continue;
+
+      if (mArticleIds)
+        (*mArticleIds)[headline->GetText()] = wikiId->GetText();
+    }
+    return true;
+  }
+
+  case WikiCommand::NewArticle:
+  {
+    TiXmlElement* wikipage = response->FirstChildElement("wikipage");
+    TiXmlElement* wikiId = wikipage ? wikipage->FirstChildElement("ixWikiPage") : nullptr;
+
+    if (wikiId == nullptr || wikiId->GetText() == nullptr)
+    {
+      printf("Failed to find wiki page id for new page %s\n", request->mTitle.c_str());
+      return false;
+    }
+
+    mCreatedPages[request->mTitle] = wikiId->GetText();
+    return true;
+  }
+
+  default:
+    return true;
+  }
+}
+
+//------------------------------------------------------------------- Publishing
+bool PublishLibraryToWiki(DocumentationLibrary& library, const WikiPublishSettings& settings,
+  WikiPublishStats& stats)
+{
+  WikiPublisher publisher(settings);
+
+  //Log onto the wiki and get our token to use for further operations
+  if (!publisher.LogOn())
+  {
+    stats = publisher.mStats;
+    return false;
+  }
+
+  //Extract the wiki article names and their indices from the wiki
+  StringMap wikiIndices;
+  bool succeeded = publisher.GetWikiArticleIds(wikiIndices);
+
+  //Every class needs a page, the ones the wiki does not have yet are created all at once
+  forRange(ClassDoc* classDoc, library.mClasses.All())
+  {
+    if (!wikiIndices.ContainsKey(classDoc->mName))
+      publisher.QueueCreatePage(classDoc->mName);
+  }
+  succeeded &= publisher.Finish();
+
+  forRange(StringMap::value_type& page, publisher.mCreatedPages.All())
+  {
+    wikiIndices[page.first] = page.second;
+  }
+
+  //set up a replacement for class names to replace in the wiki, this will set
+  //up links on the page to other classes when they are referenced
+  Array<Replacement> classReplacements;
+  forRange(ClassDoc* classDoc, library.mClasses.All())
+  {
+    String index = wikiIndices.FindValue(classDoc->mName, "");
+    if (index.Empty())
+      continue;
+
+    String link = String::Format("<a class=\"uvb\" href=\"default.asp?W%s\">%s</a>",
+      index.c_str(), classDoc->mName.c_str());
+    classReplacements.PushBack(Replacement(classDoc->mName, link));
+  }
+  Sort(classReplacements.All());
+
+  //Upload the class' page to the wiki, pages already go out while later ones are built
+  forRange(ClassDoc* classDoc, library.mClasses.All())
+  {
+    String index = wikiIndices.FindValue(classDoc->mName, "");
+    if (index.Empty())
+      continue;
+
+    publisher.QueueUploadPage(index, classDoc->mName, BuildDoc(*classDoc, classReplacements));
+  }
+  succeeded &= publisher.Finish();
+
+  publisher.LogOff();
+
+  stats = publisher.mStats;
+  return succeeded;
+}
+
+bool PushToWiki(DocGeneratorConfig& config)
+{
+  DocumentationLibrary library;
+  if (!FileExists(config.mTrimmedOutput.c_str()) || !LoadDocumentationSkeleton(library, config.mTrimmedOutput))
+  {
+    printf("publishing to the wiki needs trimmedOutput to point at a trimmed documentation file\n");
+    return false;
+  }
+  library.FinalizeDocumentation();
+
+  WikiPublishSettings settings;
+  settings.mApiUrl = config.mWikiUrl;
+  settings.mEmail = config.mWikiEmail;
+  settings.mPassword = config.mWikiPassword;
+  settings.mMaxInFlight = (uint)Math::Max(config.mWikiConnections, 1);
+  settings.mMaxRetries = (uint)Math::Max(config.mWikiRetries, 0);
+  settings.mVerbose = config.mVerbose;
+
+  WikiPublishStats stats;
+  bool succeeded = PublishLibraryToWiki(library, settings, stats);
+  stats.Print();
+
+  return succeeded;
+}
+
+}//namespace Zero
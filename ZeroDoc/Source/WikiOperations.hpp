@@ -4,19 +4,122 @@
 #include "Engine\Documentation.hpp"
 #include "Parsing.hpp"
 
+// the same typedefs curl.h makes, so users of the publisher do not need curl
+typedef void CURL;
+typedef void CURLM;
+struct curl_slist;
+
 namespace Zero
 {
+struct DocGeneratorConfig;
+
+/// how a WikiPublisher reaches the wiki and how hard it pushes
+struct WikiPublishSettings
+{
+  WikiPublishSettings();
+
+  /// the api page every command goes to, "http://host/api.asp"
+  String mApiUrl;
+  String mEmail;
+  String mPassword;
+  /// requests on the wire at once, every one of them keeps its connection open for the next
+  uint mMaxInFlight;
+  /// how many times a request that failed on the way or with a server error is sent again
+  uint mMaxRetries;
+  /// wait before the first retry of a request, doubled for every retry after it
+  uint mRetryDelayMs;
+  bool mVerbose;
+};
+
+/// what a WikiPublisher has done so far
+struct WikiPublishStats
+{
+  WikiPublishStats();
+
+  void Print(void) const;
+
+  uint mRequests;
+  uint mSucceeded;
+  uint mFailed;
+  uint mRetries;
+  /// connections that had to be opened, every other request reused one
+  uint mConnections;
+  double mBytesSent;
+  double mBytesReceived;
+  /// round trip of every successful request in milliseconds
+  Array<double> mLatencies;
+  /// time spent with requests queued or in flight in milliseconds
+  double mBusyTime;
+};
+
+/// Sends wiki api requests through one curl multi handle. Queued requests go out as soon as
+/// fewer than mMaxInFlight are on the wire, on whatever kept alive connection is free, and
+/// requests that fail on the way or get a server error are queued again with a backoff.
+class WikiPublisher
+{
+public:
+  WikiPublisher(const WikiPublishSettings& settings);
+  ~WikiPublisher();
+
+  /// logs on and waits for the token every other command needs, false if none came back
+  bool LogOn(void);
+  void LogOff(void);
+
+  /// fills wikiIndices with the id of every article by its headline
+  bool GetWikiArticleIds(StringMap& wikiIndices);
+
+  /// queues creating an article, its id is put in mCreatedPages once the wiki answered
+  void QueueCreatePage(StringParam pageName);
+  /// queues replacing the headline and body of the article with id pageIndex
+  void QueueUploadPage(StringParam pageIndex, StringParam pageTitle, StringParam pageContent);
+
+  /// drives every queued request until it succeeded or gave up, false if any gave up
+  bool Finish(void);
+
+  /// headline to id of every article QueueCreatePage made
+  StringMap mCreatedPages;
+  WikiPublishStats mStats;
+
+private:
+  struct Request;
+
+  String BuildUrl(cstr command, StringParam arguments);
+  String Escape(StringParam text);
+
+  void Queue(Request* request);
+  void StartReadyRequests(void);
+  void CompleteRequest(CURL* handle, int result);
+  /// handles the answer of a request that reached the wiki, false if the wiki refused it
+  bool HandleResponse(Request* request);
+  /// does one round of transfers, if wait is set it first sleeps until something can happen
+  void Pump(bool wait);
+  void WaitForActivity(void);
+
+  WikiPublishSettings mSettings;
+  String mToken;
+  /// filled while a list of articles is being fetched
+  StringMap* mArticleIds;
+
+  CURLM* mMulti;
+  /// extra headers every page upload is sent with
+  curl_slist* mFormHeaders;
+  /// easy handles done with their last request, they keep their connection to the wiki
+  Array<CURL*> mIdleHandles;
+  Array<CURL*> mAllHandles;
+  /// queued requests and requests waiting out a backoff, in the order they were queued
+  Array<Request*> mWaiting;
+  uint mInFlight;
+
+  /// when the publisher last went from idle to busy, negative while idle
+  double mBusyStart;
+};
+
+/// publishes a page for every class of library: articles the wiki is missing are created, then
+/// every page is uploaded with class names linked to their articles. False if anything failed
+bool PublishLibraryToWiki(DocumentationLibrary& library, const WikiPublishSettings& settings,
+  WikiPublishStats& stats);
 
-void PushToWiki(StringMap& params);
-
-void LogOn(String& token, bool verbose);
-void LogOff(StringParam token, bool verbose);
-void GetWikiArticleIds(StringParam token, StringMap& wikiIndices, bool verbose);
-bool CreateWikiPage(StringParam token, StringParam pageName, StringParam parentPageIndex, 
-                    StringMap& wikiIndices, bool verbose);
-void UploadClassDoc(StringParam index, ClassDoc& classDoc, Replacements& replacements, 
-                    StringParam token, bool verbose);
-void UploadPageContent(StringParam pageIndex, StringParam pageTitle, 
-                       StringParam pageContent, StringParam token, bool verbose);
+/// loads the trimmed documentation named in config and publishes it to wikiUrl
+bool PushToWiki(DocGeneratorConfig& config);
 
 }//namespace Zero
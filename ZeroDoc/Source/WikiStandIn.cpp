@@ -0,0 +1,338 @@
+#include "Precompiled.hpp"
+
+#include "WikiStandIn.hpp"
+#include "DocConfiguration.hpp"
+#include "RawDocumentation.hpp"
+
+namespace Zero
+{
+  // the token handed out by logon, every other command has to send it back
+  static const char* cStandInToken = "standintoken";
+
+  static int HexValue(char c)
+  {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  }
+
+  // undoes the escaping of one query string key or value
+  static String DecodeQueryText(const char* begin, const char* end)
+  {
+    std::string decoded;
+
+    for (const char* c = begin; c < end; ++c)
+    {
+      if (*c == '+')
+      {
+        decoded += ' ';
+      }
+      else if (*c == '%' && end - c > 2 && HexValue(c[1]) >= 0 && HexValue(c[2]) >= 0)
+      {
+        decoded += (char)(HexValue(c[1]) * 16 + HexValue(c[2]));
+        c += 2;
+      }
+      else
+      {
+        decoded += *c;
+      }
+    }
+
+    return String(decoded.c_str(), decoded.size());
+  }
+
+  // splits "a=1&b=2" into its decoded keys and values
+  static void ParseQuery(StringParam query, HashMap<String, String>& arguments)
+  {
+    const char* c = query.c_str();
+    const char* end = c + query.SizeInBytes();
+
+    while (c < end)
+    {
+      const char* argumentEnd = c;
+      while (argumentEnd < end && *argumentEnd != '&')
+        ++argumentEnd;
+
+      const char* equals = c;
+      while (equals < argumentEnd && *equals != '=')
+        ++equals;
+
+      String key = DecodeQueryText(c, equals);
+      String value = equals < argumentEnd ? DecodeQueryText(equals + 1, argumentEnd) : String();
+      arguments[key] = value;
+
+      c = argumentEnd + 1;
+    }
+  }
+
+  // the contents of the multipart form field called name, empty if the form has no such field
+  static std::string GetFormField(const std::string& body, const std::string& contentType, cstr name)
+  {
+    size_t boundaryStart = contentType.find("boundary=");
+    if (boundaryStart == std::string::npos)
+      return std::string();
+
+    std::string boundary = contentType.substr(boundaryStart + strlen("boundary="));
+    size_t boundaryEnd = boundary.find(';');
+    if (boundaryEnd != std::string::npos)
+      boundary.erase(boundaryEnd);
+    if (boundary.size() >= 2 && boundary[0] == '"')
+      boundary = boundary.substr(1, boundary.size() - 2);
+
+    std::string marker = std::string("name=\"") + name + "\"";
+    size_t start = body.find(marker);
+    if (start == std::string::npos)
+      return std::string();
+
+    start = body.find("\r\n\r\n", start);
+    if (start == std::string::npos)
+      return std::string();
+    start += 4;
+
+    size_t end = body.find("\r\n--" + boundary, start);
+    if (end == std::string::npos)
+      return std::string();
+
+    return body.substr(start, end - start);
+  }
+
+  // true if the header line starts with name, ignoring case
+  static bool IsHeader(const std::string& line, cstr name)
+  {
+    size_t length = strlen(name);
+    return line.size() > length && _strnicmp(line.c_str(), name, length) == 0 && line[length] == ':';
+  }
+
+  // the value of a header line with surrounding spaces removed
+  static std::string GetHeaderValue(const std::string& line)
+  {
+    size_t start = line.find(':') + 1;
+    while (start < line.size() && line[start] == ' ')
+      ++start;
+    return line.substr(start);
+  }
+
+  static String ErrorResponse(uint code, cstr message)
+  {
+    return String::Format("<response><error code=\"%u\">%s</error></response>", code, message);
+  }
+
+  static String PageResponse(uint id)
+  {
+    return String::Format("<response><wikipage><ixWikiPage>%u</ixWikiPage></wikipage></response>", id);
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+  // WikiStandInServer
+  ////////////////////////////////////////////////////////////////////////
+  WikiStandInServer::WikiStandInServer()
+    : LoopbackServer("stand-in wiki")
+    , mFailEvery(0)
+    , mResponseDelayMs(0)
+    , mRequestCount(0)
+    , mFailedCount(0)
+  {
+  }
+
+  LoopbackConnection* WikiStandInServer::CreateConnection(void)
+  {
+    return new Connection();
+  }
+
+  bool WikiStandInServer::WantsToReceive(LoopbackConnection& connection)
+  {
+    return ((Connection&)connection).mResponse.empty();
+  }
+
+  bool WikiStandInServer::HandleReceived(LoopbackConnection& baseConnection)
+  {
+    Connection& connection = (Connection&)baseConnection;
+
+    size_t headerEnd = connection.mPending.find("\r\n\r\n");
+    if (headerEnd == std::string::npos)
+      return true;
+
+    // request line then one header per line
+    std::string target;
+    std::string contentType;
+    size_t contentLength = 0;
+    bool keepAlive = true;
+
+    size_t lineStart = 0;
+    while (lineStart < headerEnd)
+    {
+      size_t lineEnd = connection.mPending.find("\r\n", lineStart);
+      std::string line = connection.mPending.substr(lineStart, lineEnd - lineStart);
+
+      if (lineStart == 0)
+      {
+        size_t targetStart = line.find(' ');
+        size_t targetEnd = line.find(' ', targetStart + 1);
+        if (targetStart != std::string::npos && targetEnd != std::string::npos)
+          target = line.substr(targetStart + 1, targetEnd - targetStart - 1);
+      }
+      else if (IsHeader(line, "Content-Length"))
+      {
+        contentLength = (size_t)atoi(GetHeaderValue(line).c_str());
+      }
+      else if (IsHeader(line, "Content-Type"))
+      {
+        contentType = GetHeaderValue(line);
+      }
+      else if (IsHeader(line, "Connection"))
+      {
+        keepAlive = _stricmp(GetHeaderValue(line).c_str(), "close") != 0;
+      }
+
+      lineStart = lineEnd + 2;
+    }
+
+    size_t requestSize = headerEnd + 4 + contentLength;
+    if (connection.mPending.size() < requestSize)
+      return true;
+
+    std::string body = connection.mPending.substr(headerEnd + 4, contentLength);
+    connection.mPending.erase(0, requestSize);
+
+    ++mRequestCount;
+
+    std::string status = "200 OK";
+    String responseBody;
+
+    if (mFailEvery != 0 && mRequestCount % mFailEvery == 0)
+    {
+      ++mFailedCount;
+      status = "503 Service Unavailable";
+    }
+    else
+    {
+      size_t queryStart = target.find('?');
+      String query = queryStart != std::string::npos ? String(target.c_str() + queryStart + 1) : String();
+      responseBody = HandleRequest(query, contentType, body);
+    }
+
+    connection.mResponse = BuildString("HTTP/1.1 ", status.c_str(), "\r\n").c_str();
+    connection.mResponse += "Content-Type: text/xml; charset=utf-8\r\n";
+    connection.mResponse += String::Format("Content-Length: %u\r\n", (uint)responseBody.SizeInBytes()).c_str();
+    if (!keepAlive)
+      connection.mResponse += "Connection: close\r\n";
+    connection.mResponse += "\r\n";
+    connection.mResponse.append(responseBody.c_str(), responseBody.SizeInBytes());
+
+    connection.mSendTime = GetDocTimeMs() + mResponseDelayMs;
+    connection.mCloseAfterResponse = !keepAlive;
+
+    return true;
+  }
+
+  bool WikiStandInServer::Update(LoopbackConnection& baseConnection, double now, double& waitMs)
+  {
+    Connection& connection = (Connection&)baseConnection;
+
+    if (connection.mResponse.empty())
+      return true;
+
+    // wake up as soon as the answer is due
+    if (connection.mSendTime > now)
+    {
+      waitMs = Math::Min(waitMs, connection.mSendTime - now);
+      return true;
+    }
+
+    if (!SendAll(connection.mSocket, connection.mResponse.c_str(), (uint)connection.mResponse.size()))
+      return false;
+
+    connection.mResponse.clear();
+    return !connection.mCloseAfterResponse;
+  }
+
+  String WikiStandInServer::HandleRequest(StringParam query, const std::string& contentType,
+    const std::string& body)
+  {
+    HashMap<String, String> arguments;
+    ParseQuery(query, arguments);
+
+    String command = arguments.FindValue("cmd", "");
+
+    if (command == "logon")
+    {
+      if (arguments.FindValue("email", "").Empty() || arguments.FindValue("password", "").Empty())
+        return ErrorResponse(1, "Incorrect password or username");
+
+      return BuildString("<response><token><![CDATA[", cStandInToken, "]]></token></response>");
+    }
+
+    if (arguments.FindValue("token", "") != cStandInToken)
+      return ErrorResponse(3, "Not logged on");
+
+    if (command == "logoff")
+      return "<response></response>";
+
+    if (command == "listArticles")
+    {
+      StringBuilder builder;
+      builder << "<response><articles>";
+      for (uint i = 0; i < mArticles.Size(); ++i)
+      {
+        builder << "<article><ixWikiPage>" << String::Format("%u", i + 1) << "</ixWikiPage>";
+        builder << "<sHeadline><![CDATA[" << mArticles[i].mHeadline << "]]></sHeadline></article>";
+      }
+      builder << "</articles></response>";
+      return builder.ToString();
+    }
+
+    if (command == "newArticle")
+    {
+      String headline = arguments.FindValue("sHeadline", "");
+      if (headline.Empty())
+        return ErrorResponse(10, "Missing sHeadline");
+
+      Article& article = mArticles.PushBack();
+      article.mHeadline = headline;
+      article.mEdits = 0;
+
+      return PageResponse(mArticles.Size());
+    }
+
+    if (command == "editArticle")
+    {
+      uint id = (uint)atoi(arguments.FindValue("ixWikiPage", "0").c_str());
+      if (id == 0 || id > mArticles.Size())
+        return ErrorResponse(11, "Unknown ixWikiPage");
+
+      std::string headline = GetFormField(body, contentType, "sHeadline");
+      std::string pageBody = GetFormField(body, contentType, "sBody");
+
+      Article& article = mArticles[id - 1];
+      if (!headline.empty())
+        article.mHeadline = String(headline.c_str(), headline.size());
+      article.mBody = String(pageBody.c_str(), pageBody.size());
+      ++article.mEdits;
+
+      return PageResponse(id);
+    }
+
+    return ErrorResponse(0, "Unknown command");
+  }
+
+  bool RunWikiStandIn(DocGeneratorConfig& config)
+  {
+    WikiStandInServer server;
+
+    if (!server.Start((uint)config.mWikiStandInPort))
+    {
+      printf("unable to start the stand-in wiki on port %d\n", config.mWikiStandInPort);
+      return false;
+    }
+
+    printf("serving a stand-in wiki at http://127.0.0.1:%u/api.asp\n", server.GetPort());
+
+    server.Run();
+
+    return true;
+  }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "LoopbackServer.hpp"
+
+namespace Zero
+{
+  struct DocGeneratorConfig;
+
+  /// Answers the wiki api over HTTP on 127.0.0.1 the way the real wiki does, closely enough to
+  /// publish against without touching it. Connections are kept alive between requests and
+  /// articles only live in memory. One thread serves every connection.
+  class WikiStandInServer : public LoopbackServer
+  {
+  public:
+    WikiStandInServer();
+
+    struct Article
+    {
+      String mHeadline;
+      String mBody;
+      uint mEdits;
+    };
+
+    /// every article, its id is its index plus one
+    Array<Article> mArticles;
+
+    /// every mFailEvery-th request is answered with a 503 before it is looked at, 0 never fails
+    uint mFailEvery;
+    /// how long every answer is held back, like a server doing real work
+    uint mResponseDelayMs;
+
+    uint mRequestCount;
+    uint mFailedCount;
+
+  protected:
+    virtual LoopbackConnection* CreateConnection(void) override;
+
+    /// answers a full request once it arrived, holding the answer back until it is due
+    virtual bool HandleReceived(LoopbackConnection& connection) override;
+
+    /// clients wait for the answer before they send the next request
+    virtual bool WantsToReceive(LoopbackConnection& connection) override;
+
+    /// sends the held back response once it is due, false if the connection should be closed
+    virtual bool Update(LoopbackConnection& connection, double now, double& waitMs) override;
+
+  private:
+    struct Connection : public LoopbackConnection
+    {
+      Connection() : mSendTime(0.0), mCloseAfterResponse(false) {}
+
+      // the answer to the last request, sent once mSendTime has come
+      std::string mResponse;
+      double mSendTime;
+      bool mCloseAfterResponse;
+    };
+
+    /// builds the xml body for one api request
+    String HandleRequest(StringParam query, const std::string& contentType, const std::string& body);
+  };
+
+  /// serves a stand-in wiki on wikiStandInPort until the process is closed, false if it could
+  /// not start. publishWiki can be pointed at it with wikiUrl
+  bool RunWikiStandIn(DocGeneratorConfig& config);
+}
@@ -5,13 +5,27 @@
 //#include "Serialization/Text.hpp"
 #include "Platform/CommandLineSupport.hpp"
 #include "Engine/Environment.hpp"
+#include "Support/FileSupport.hpp"
 
 #include "DocConfiguration.hpp"
 #include "RawDocumentation.hpp"
 #include "MarkupWriter.hpp"
 #include "MacroDatabase.hpp"
 #include "MacroDocTests.hpp"
+#include "DocBenchmarks.hpp"
 #include "TypeBlacklist.hpp"
+#include "DocTaskPool.hpp"
+#include "TrimDocBinary.hpp"
+#include "DocOutputSink.hpp"
+#include "DocWatcher.hpp"
+#include "DocQueryServer.hpp"
+#include "FlattenedSource.hpp"
+#include "WikiOperations.hpp"
+#include "WikiStandIn.hpp"
+#include "ClassTrimStream.hpp"
+
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
 
 namespace Zero
 {
@@ -30,9 +44,14 @@ verbose - if true, some extra parsing information will be logged/output\n\n\
 tagAllAsUnbound - if true, we tag everything we load as unbound types\n\n\
 help - if true, we will print the help text then exit\n\n\
 createTrimmed - if true, we will output the trimmed documentation files\n\n\
+watch - if true, we keep running after generating and only regenerate what changes to the doxygen xml affect\n\n\
+scanSources - if true, events, exceptions and macros are read from the original source files doxygen lists instead of its programlisting xml\n\n\
+lowMemoryTrim - if true, every raw class is trimmed and freed as soon as it and its base classes were loaded, lowering peak memory when creating trimmed docs\n\n\
+publishWiki - if true, instead of generating, a page for every class in the trimmed output is published to wikiUrl\n\n\
 \n\n\
 Options:\n\n\
 doxygenPath - required if parseDoxygen flag is set\n\n\
+sourceDirectory - with scanSources, every source file under this directory can be scanned even if no class points at it\n\n\
 zeroDocFile - this gets us the doc file that zilch will fill out from the engine meta\n\n\
 typedefLibraryFile - defaults to file in rawDocDirectory honestly it should always be with a documentation folder\n\n\
 outputDirectory - where the documentation should output\n\n\
@@ -44,18 +63,53 @@ zeroEventsFile - this is the events file zero outputs\n\n\
 eventsOutputLocation - this is the event list that we generate\n\n\
 exceptionsFile - this is the exceptions file that we generate\n\n\
 trimmedOutput - defaults to trimdoc.data in the output directory\n\n\
+trimmedBinaryOutput - defaults to trimmedOutput with a .bin extension, binary copy of the trimmed output that can be memory mapped\n\n\
 trimmedTypedefFile - where to load the trimmed typedef doclib location\n\n\
 markupDirectory - what directory to output all the markup files to\n\n\
 commandListFile - where to output the command list\n\n\
 runMacroTest - what macro test to run, if -1, no tests will be run, if max(int), all tests will run\n\n\
+runBenchmark - what benchmark to run (lexer, ignoreList, trimLoad, query, search, tokenCache, descriptions, wiki or all), needs doxyPath or trimmedOutput, if empty, no benchmarks will be run\n\n\
+threadCount - how many threads the per-class passes can use, defaults to every hardware thread\n\n\
+queryServerPort - if set, instead of generating, the trimmed output is loaded once and lookups are answered on this port of 127.0.0.1\n\n\
+wikiUrl - the api page publishWiki sends its requests to\n\n\
+wikiEmail - the account publishWiki logs on with\n\n\
+wikiPassword - the password of wikiEmail\n\n\
+wikiConnections - how many requests publishWiki keeps on the wire at once, defaults to 8\n\n\
+wikiRetries - how many times publishWiki retries a request after a network or server error, defaults to 3\n\n\
+wikiStandInPort - if set, instead of generating, a stand-in for the wiki api is served on this port of 127.0.0.1 to publish against\n\n\
 "
   );
 }
 
 bool ValidateConfig(DocGeneratorConfig &config)
 {
-  if (config.mRunMacroTest > -1)
+  if (config.mRunMacroTest > -1 || !config.mRunBenchmark.Empty() || config.mQueryServerPort > 0
+    || config.mWikiStandInPort > 0)
+    return true;
+
+  if (config.mPublishWiki)
+  {
+    if (config.mWikiUrl.Empty() || config.mWikiEmail.Empty() || config.mWikiPassword.Empty())
+    {
+      printf("publishWiki needs wikiUrl, wikiEmail and wikiPassword\n");
+      return false;
+    }
     return true;
+  }
+
+  // watching only makes sense for documentation built from doxygen
+  if (config.mWatch && config.mDoxygenPath.Empty())
+  {
+    printf("watch needs a doxyPath to watch\n");
+    return false;
+  }
+
+  // watching regenerates single classes from the raw library, which low memory mode frees
+  if (config.mWatch && config.mLowMemoryTrim)
+  {
+    printf("watch can not be combined with lowMemoryTrim\n");
+    return false;
+  }
 
   // we have to output something
   if (!config.mCreateTrimmed && config.mOutputDirectory.Empty() && config.mMarkupDirectory.Empty())
@@ -79,7 +133,90 @@ bool ValidateConfig(DocGeneratorConfig &config)
   return true;
 }
 
-void RunDocumentationGenerator(DocGeneratorConfig &config)
+// prints the most memory the process had resident at once. Runs that create trimmed docs keep
+// their peak next to the trimmed output, so the last run of the other trim mode on the same docs
+// is printed along with it and the reduction can be read off directly
+void PrintPeakMemoryUsage(DocGeneratorConfig &config)
+{
+  PROCESS_MEMORY_COUNTERS counters;
+  counters.cb = sizeof(counters);
+
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return;
+
+  double peakMb = counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+
+  printf("peak working set: %.1f MB (%s trim)\n", peakMb,
+    config.mLowMemoryTrim ? "low memory" : "full");
+
+  if (!config.mCreateTrimmed)
+    return;
+
+  // the full trim's peak comes first, then the low memory trim's
+  double peaks[2] = { 0.0, 0.0 };
+  String recordPath = BuildString(config.mTrimmedOutput, ".peak");
+
+  Array<char> record;
+  if (ReadWholeFile(recordPath, record) && !record.Empty())
+  {
+    record.PushBack('\0');
+    sscanf(record.Data(), "%lf %lf", &peaks[0], &peaks[1]);
+  }
+
+  peaks[config.mLowMemoryTrim ? 1 : 0] = peakMb;
+
+  if (peaks[0] > 0.0 && peaks[1] > 0.0)
+  {
+    printf("full trim: %.1f MB, low memory trim: %.1f MB (%.0f%% of full)\n",
+      peaks[0], peaks[1], 100.0 * peaks[1] / peaks[0]);
+  }
+  else
+  {
+    printf("run once %s lowMemoryTrim to compare both trim modes\n",
+      config.mLowMemoryTrim ? "without" : "with");
+  }
+
+  WriteStringRangeToFile(recordPath, String::Format("%.1f %.1f\n", peaks[0], peaks[1]));
+}
+
+// loads the typedefs from doxygen if asked to and prepares them for normalizing types
+void LoadTypedefLibrary(DocGeneratorConfig &config, RawTypedefLibrary *tdLibrary)
+{
+  if (config.mLoadTypedefsFromDoxygen)
+  {
+    tdLibrary->mIgnoreList.mDoxyPath = config.mDoxygenPath;
+
+    if (!config.mIgnoreFile.Empty())
+    {
+      if (!Zero::LoadFromDataFile(tdLibrary->mIgnoreList, config.mIgnoreFile))
+      {
+        Error("Unable to load doc file at: %s", config.mIgnoreFile.c_str());
+      }
+    }
+
+    tdLibrary->LoadTypedefsFromNamespaceDocumentation(config.mDoxygenPath);
+  }
+
+  tdLibrary->BuildMap();
+
+  tdLibrary->ExpandAllTypedefs();
+}
+
+// loads the typedefs types are normalized with before trimming, false if that failed
+bool LoadTrimTypedefs(DocGeneratorConfig &config, RawTypedefLibrary &trimTypedef)
+{
+  if (config.mTrimmedTypedefFile.Empty() || trimTypedef.LoadFromFile(config.mTrimmedTypedefFile))
+    return true;
+
+  Error("Can't load typedef file at: %s", config.mTrimmedTypedefFile);
+  return false;
+}
+
+// trimLib is filled with the finalized trimmed documentation, markupSources points at
+// everything the markup writers can use without loading it back from disk. If a watcher is
+// passed it records what it needs before types are normalized. Returns the raw library, if any
+RawDocumentationLibrary* RunDocumentationGenerator(DocGeneratorConfig &config,
+  DocumentationLibrary &trimLib, ReMarkupSources &markupSources, DocWatcher* watcher)
 {
   if (config.mVerbose)
     SetVerboseFlag();
@@ -89,6 +226,11 @@ void RunDocumentationGenerator(DocGeneratorConfig &config)
     DocLogger::Get()->StartLogger(config.mLogFile, config.mVerbose);
   }
 
+  DocTaskPool::Initialize((uint)Math::Max(config.mThreadCount, 0));
+
+  if (config.mScanSources)
+    SourceFileIndex::Get()->Enable(config.mSourceDirectory);
+
   
   RawDocumentationLibrary *library = nullptr;
   RawTypedefLibrary *tdLibrary = RawTypedefLibrary::Get();
@@ -105,11 +247,34 @@ void RunDocumentationGenerator(DocGeneratorConfig &config)
     }
   }
 
+  // low memory trimming trims and frees every class right after it was loaded, so everything
+  // classes are normalized with has to be ready before the first one
+  bool trimsPerClass = config.mLowMemoryTrim && config.mCreateTrimmed;
+
+  RawTypedefLibrary trimTypedef;
+  ClassTrimStream trimStream(trimLib);
+
+  if (trimsPerClass)
+  {
+    LoadTypedefLibrary(config, tdLibrary);
+
+    if (!LoadTrimTypedefs(config, trimTypedef))
+      return library;
+
+    trimStream.mRawTypedefs = config.mReplaceTypes ? tdLibrary : nullptr;
+    trimStream.mTrimTypedefs = config.mTrimmedTypedefFile.Empty() ? nullptr : &trimTypedef;
+    trimStream.mRawOutputDirectory = config.mOutputDirectory;
+    trimStream.mTagAsUnbound = config.mTagAllAsUnbound;
+  }
+
   // if we are going to parse doxygen
   if (config.mDoxygenPath.SizeInBytes() != 0)
   {
     library = new RawDocumentationLibrary;
 
+    if (trimsPerClass)
+      library->mTrimStream = &trimStream;
+
     library->mBlacklist = blacklist;
 
     if (!config.mZilchTypesToCppFileList.Empty())
@@ -138,14 +303,9 @@ void RunDocumentationGenerator(DocGeneratorConfig &config)
     {
       Zero::DocumentationLibrary *doc = new Zero::DocumentationLibrary();
 
-      if (!Zero::LoadDocumentationSkeleton(*doc, config.mZeroDocFile))
-      {
-        Error("Unable to load doc file at: %s", config.mZeroDocFile.c_str());
-      }
-
-      doc->FinalizeDocumentation();
-
-      library->LoadFromSkeletonFile(config.mDoxygenPath, *doc);
+      // classes are loaded from doxygen while the rest of the skeleton is still being read,
+      // the stream reports it if the file could not be read
+      library->LoadFromSkeletonStream(config.mDoxygenPath, config.mZeroDocFile, *doc);
 
       library->LoadAllEnumDocumentationFromDoxygen(config.mDoxygenPath);
     }
@@ -171,38 +331,38 @@ void RunDocumentationGenerator(DocGeneratorConfig &config)
   {
     library = new RawDocumentationLibrary;
 
+    if (trimsPerClass)
+      library->mTrimStream = &trimStream;
+
     // load from documentation directory
     library->LoadFromDocumentationDirectory(config.mRawDocDirectory);
     library->Build();
   }
 
-  if (config.mLoadTypedefsFromDoxygen)
+  if (trimsPerClass)
   {
-    tdLibrary->mIgnoreList.mDoxyPath = config.mDoxygenPath;
-
-    if (!config.mIgnoreFile.Empty())
-    {
-      if (!Zero::LoadFromDataFile(tdLibrary->mIgnoreList, config.mIgnoreFile))
-      {
-        Error("Unable to load doc file at: %s", config.mIgnoreFile.c_str());
-      }
-    }
-
-    tdLibrary->LoadTypedefsFromNamespaceDocumentation(config.mDoxygenPath);
+    // trims whatever still waits on a base class and fills in the enums
+    if (library)
+      trimStream.Finish(*library);
+  }
+  else
+  {
+    LoadTypedefLibrary(config, tdLibrary);
   }
-
-  tdLibrary->BuildMap();
-
-  tdLibrary->ExpandAllTypedefs();
 
   if (library)
   {
-    if (config.mReplaceTypes)
+    library->mTrimStream = nullptr;
+
+    if (watcher)
+      watcher->RecordTypeUsage(*library);
+
+    if (config.mReplaceTypes && !trimsPerClass)
     {
       library->NormalizeAllTypes(tdLibrary);
     }
 
-    if (config.mTagAllAsUnbound)
+    if (config.mTagAllAsUnbound && !trimsPerClass)
     {
       for (uint i = 0; i < library->mClasses.Size(); ++i)
       {
@@ -213,50 +373,53 @@ void RunDocumentationGenerator(DocGeneratorConfig &config)
     if (config.mOutputDirectory.SizeInBytes())
     {
       // output library and typedefs
-      library->GenerateCustomDocumentationFiles(config.mOutputDirectory);
+      if (!trimsPerClass)
+        library->GenerateCustomDocumentationFiles(config.mOutputDirectory);
       tdLibrary->GenerateTypedefDataFile(config.mOutputDirectory);
     }
 
     if (config.mEventsOutputLocation.SizeInBytes())
     {
       library->SaveEventListToFile(config.mEventsOutputLocation);
+      markupSources.mEvents = &library->mEvents;
     }
   }
 
   /////// Trimmed Documentation ///////
   if (!config.mCreateTrimmed)
-    return;
+    return library;
 
   if (!library)
   {
     printf("No way to load/generate Trimmed documentation given\n");
     PrintHelp();
-    return;
+    return library;
   }
 
-  DocumentationLibrary trimLib;
-
-  if (!config.mTrimmedTypedefFile.Empty())
+  // the stream already filled trimLib while loading
+  if (!trimsPerClass)
   {
-    RawTypedefLibrary trimTypedef;
+    if (!LoadTrimTypedefs(config, trimTypedef))
+      return library;
 
-    if (!trimTypedef.LoadFromFile(config.mTrimmedTypedefFile))
-    {
-      Error("Can't load typedef file at: %s", config.mTrimmedTypedefFile);
-      return;
-    }
-    library->NormalizeAllTypes(&trimTypedef);
-  }
+    if (!config.mTrimmedTypedefFile.Empty())
+      library->NormalizeAllTypes(&trimTypedef);
 
-  library->FillTrimmedDocumentation(trimLib);
+    library->FillTrimmedDocumentation(trimLib);
+  }
 
   //trimLib.LoadFromMeta();
 
   trimLib.FinalizeDocumentation();
+  markupSources.mLibrary = &trimLib;
 
   WriteLog("saving Trimmed Documentation File as: %s\n", config.mTrimmedOutput.c_str());
 
   SaveTrimDocToDataFile(trimLib, config.mTrimmedOutput);
+
+  WriteLog("saving binary Trimmed Documentation File as: %s\n", config.mTrimmedBinaryOutput.c_str());
+
+  SaveTrimDocToBinaryFile(trimLib, config.mTrimmedBinaryOutput);
   //trimLib->La
 
   // if we have the doxy path, input attrib file, and output attrib file, create attrib documentation
@@ -282,6 +445,8 @@ void RunDocumentationGenerator(DocGeneratorConfig &config)
   {
     OutputListOfObjectsWithoutDesc(trimLib, &library->mIgnoreList);
   }
+
+  return library;
 }
 
 }//namespace Zero
@@ -322,13 +487,49 @@ int main(int argc, char* argv[])
     return (int)!Zero::RunMacroTests(config.mRunMacroTest);
   }
 
-  Zero::RunDocumentationGenerator(config);
+  if (!config.mRunBenchmark.Empty())
+  {
+    return (int)!Zero::RunBenchmarks(config.mRunBenchmark, config);
+  }
+
+  if (config.mQueryServerPort > 0)
+  {
+    return (int)!Zero::RunDocQueryServer(config);
+  }
+
+  if (config.mWikiStandInPort > 0)
+  {
+    return (int)!Zero::RunWikiStandIn(config);
+  }
+
+  if (config.mPublishWiki)
+  {
+    return (int)!Zero::PushToWiki(config);
+  }
+
+  // kept alive so the markup writers can use them straight from memory
+  Zero::DocumentationLibrary trimLib;
+  Zero::ReMarkupSources markupSources;
+
+  // only gets to work once everything was generated the normal way
+  Zero::DocWatcher watcher(config, trimLib, markupSources);
+
+  Zero::RawDocumentationLibrary* library = Zero::RunDocumentationGenerator(config, trimLib,
+    markupSources, config.mWatch ? &watcher : nullptr);
 
   if (!config.mMarkupDirectory.Empty())
   {
-    Zero::WriteOutAllReMarkupFiles(config);
+    Zero::WriteOutAllReMarkupFiles(config, markupSources);
   }
 
+  Zero::DocOutputSink::Get()->PrintReport();
+  Zero::PrintPeakMemoryUsage(config);
+  Zero::TokenCache::Get()->PrintStats();
+
+  if (config.mWatch && library)
+  {
+    watcher.Run(*library);
+  }
 
   return 0;
 }